@@ -1,31 +1,57 @@
-#include "listes_generiques.h"
+#include "algues.h"
 #include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define GAUCHE -1
-#define DROITE 1
-#define T1 4
-#define T2 5
-#define TMIN 4
-#define TMAX 9
-#define NBITER 20
-
-/*
-* \brief Cette structure contient les attributs d'un algue, sa taille et son
-* orientation.
-*/
-typedef struct algue {
-  int taille;
-  int orientation;
-} algue;
-
-/*!
-* \brief Créer une algue avec un taille T1 et une orientation à gauche.
-* \return Une algue avec un taille T1 et une orientation à gauche.
-*/
-algue *algue_init() {
+#define NB_RECYCLES 64
+/* Nombre minimal d'algues confiées à chaque thread */
+#define SEUIL_PARALLELE 4096
+
+/* Niveau de vérification : une constante s'il est figé à la compilation. */
+#ifdef ALGUE_VERIFICATION
+#define niveau_verification ALGUE_VERIFICATION
+#else
+static algue_verification niveau_verification = VERIFICATION_DEFAUT;
+#endif
+static unsigned int echantillon_verification = ECHANTILLON_DEFAUT;
+
+/* Vérifie l'invariant d'une algue. */
+static inline void algue_verifier(algue const *a) {
+  assert(a->taille >= TMIN && a->taille <= TMAX);
+  assert(a->orientation == GAUCHE || a->orientation == DROITE);
+  (void)a;
+}
+
+/* Vérifie qu'une algue de la liste est valide et égale à son modèle. */
+static inline void algue_verifier_copie(algue const *a, algue const *modele) {
+  algue_verifier(a);
+  assert(a->taille == modele->taille && a->orientation == modele->orientation);
+  (void)modele;
+}
+
+/* Générateur xorshift, pour tirer les algues vérifiées par échantillonnage */
+static inline uint64_t tirage(uint64_t *etat) {
+  *etat ^= *etat << 13;
+  *etat ^= *etat >> 7;
+  *etat ^= *etat << 17;
+  return *etat;
+}
+
+bool algue_verification_choisir(algue_verification niveau,
+                                unsigned int echantillon) {
+  echantillon_verification = echantillon;
+#ifdef ALGUE_VERIFICATION
+  return niveau == ALGUE_VERIFICATION;
+#else
+  niveau_verification = niveau;
+  return true;
+#endif
+}
+
+algue *algue_init(void) {
   algue *a;
   a = (algue *)malloc(sizeof(algue));
   a->taille = T1;
@@ -33,12 +59,6 @@ algue *algue_init() {
   return a;
 }
 
-/*!
-* \brief Créer une algue avec une taille et un orientation donnée.
-* \param _taille La taille de l'algue.
-* \param _orientation L'orientation de l'algue.
-* \return Une algue avec une taille et une orientation donnée.
-*/
 algue *algue_valeur(int _taille, int _orientation) {
   assert(_taille >= TMIN);
   assert(_taille <= TMAX);
@@ -48,29 +68,18 @@ algue *algue_valeur(int _taille, int _orientation) {
   return a;
 }
 
-/*!
-* \brief Définit la valeur de l'algue à partir d'une recopie.
-*/
 void copier_algue(void *val, void **pt) {
   assert(val != NULL);
   *pt = (algue *)malloc(sizeof(algue));
   memcpy(*pt, val, sizeof(algue));
 }
 
-/*!
-* \brief Définit comment afficher une algue.
-* \param f Le fichier dans lequel afficher l'algue.
-* \param val Un pointeur vers la valeur.
-*/
 void afficher_algue(FILE *f, void *val) {
   assert(f != NULL);
   assert(val != NULL);
   fprintf(f, "(%d,%d)", ((algue *)val)->taille, ((algue *)val)->orientation);
 }
 
-/*!
-* \brief Définit comment désallouer la mémoire pour une algue
-*/
 void detruire_algue(void **pt) {
   if (*pt != NULL) {
     free(*pt);
@@ -78,18 +87,6 @@ void detruire_algue(void **pt) {
   }
 }
 
-/*!
-* \brief Retourne une liste initialisée avec une algue de taille T1 orientée
-* vers la gauche.
-* \param _copie une fonction qui définit la valeur de l'algue à partir d'une
-* recopie.
-* \param _afficher une fonction qui définit comment on affiche la valeur de
-* l'algue.
-* \param _detruire une fonction qui définit comment désallouer la mémoire
-* relative à la valeur de l'algue.
-* \return une liste initialisée avec une algue de taille T1 orientée vers la
-* gauche.
-*/
 liste algue_liste_init(void (*_copier)(void *val, void **pt),
                        void (*_afficher)(FILE *f, void *val),
                        void (*_detruire)(void **pt)) {
@@ -97,74 +94,187 @@ liste algue_liste_init(void (*_copier)(void *val, void **pt),
   assert(_afficher != NULL);
   assert(_detruire != NULL);
   liste l = liste_creer(_copier, _afficher, _detruire);
+  // Les algues sont des blocs sans pointeur : chaque division peut réutiliser
+  // le maillon et la valeur de l'algue mère.
+  liste_recyclage(l, NB_RECYCLES, sizeof(algue));
   algue *p_a = algue_valeur(T1, GAUCHE);
   liste_insertion_debut(l, p_a);
   free(p_a);
   return l;
 }
 
-/*!
-* A appeler après une itération. Vérifie que toute les algues de la liste ont
-* une taille inférieur à TMAX
-*/
+liste algue_liste_init_externe(char const *repertoire, size_t budget) {
+  liste l = liste_creer_externe(sizeof(algue), &afficher_algue, repertoire,
+                                budget);
+  if (l != NULL) {
+    algue a = {T1, GAUCHE};
+    liste_insertion_debut(l, &a);
+  }
+  return l;
+}
+
 void test_algue_iteration(liste l) {
   assert(l != NULL);
   liste_courant_init(l);
-  unsigned int taille = liste_taille(l);
+  size_t taille = liste_taille_etendue(l);
   for (size_t i = 0; i < taille; i++) {
-    assert(((algue *)liste_valeur_courant(l))->taille <= TMAX);
+    algue_verifier(liste_valeur_courant(l));
+    liste_courant_suivant(l);
   }
 }
 
+/* Indice de l'état d'une algue dans algue_compteurs */
+static inline unsigned int algue_etat_indice(algue const *a) {
+  return (unsigned int)(2 * (a->taille - TMIN) + (a->orientation == DROITE));
+}
+
 /* Une itération consiste à visiter tous les éléments de la liste */
 /* et à faire évoluer chaque cellule selon la règle (cf énoncé) */
-void algue_iteration(liste l) {
+/* Les compteurs c sont remplis s'ils ne sont pas NULL. */
+static inline void iteration(liste l, algue_compteurs *c) {
   assert(l != NULL);
+  if (c != NULL) {
+    memset(c, 0, sizeof(*c));
+  }
   liste_courant_init(l);
-  int i = 0;
-  int tailleOriginale = liste_taille(l);
+  // Une colonie externe peut dépasser INT_MAX algues : la boucle compte en
+  // size_t.
+  size_t i = 0;
+  size_t tailleOriginale = liste_taille_etendue(l);
+  algue_verification const niveau = niveau_verification;
+  // Une algue est vérifiée par échantillonnage si le tirage est inférieur à
+  // seuil, soit avec une probabilité echantillon / tailleOriginale.
+  uint64_t etat = (uint64_t)(uintptr_t)l ^ (uint64_t)tailleOriginale << 32 ^
+                  0x9E3779B97F4A7C15u;
+  uint64_t seuil = 0;
+  if (niveau == VERIFICATION_ECHANTILLON) {
+    seuil = echantillon_verification >= tailleOriginale
+                ? UINT64_MAX
+                : UINT64_MAX / (uint64_t)tailleOriginale *
+                      echantillon_verification;
+  }
   while (i < tailleOriginale) {
     // Si l'algue a une taille supérieure à TMAX, je la divise.
     if (((algue *)liste_valeur_courant(l))->taille >= TMAX) {
       // La petite algue est toujours dans la même orientation que l'algue
-      // courante. (- orientation) revient à dire l'orientation opposée (ex:
-      // gauche est l'opposé de droite)
-      algue *p_petiteAlgue =
-          algue_valeur(T1, ((algue *)liste_valeur_courant(l))->orientation);
-      algue *p_moyenneAlgue =
-          algue_valeur(T2, -(((algue *)liste_valeur_courant(l))->orientation));
-      if (p_petiteAlgue->orientation == GAUCHE) {
-        liste_insertion_avant(l, p_petiteAlgue);
-        liste_insertion_apres(l, p_moyenneAlgue);
+      // courante, du côté de cette orientation ; la moyenne est orientée à
+      // l'opposé. L'algue courante est remplacée par ses deux filles, de
+      // gauche à droite, et le courant reste sur celle de droite.
+      int orientation = ((algue *)liste_valeur_courant(l))->orientation;
+      algue filles[2] = {{orientation == GAUCHE ? T1 : T2, GAUCHE},
+                         {orientation == GAUCHE ? T2 : T1, DROITE}};
+      void *vals[2] = {&filles[0], &filles[1]};
+      if (c != NULL) {
+        c->divisions++;
+        c->histogramme[algue_etat_indice(&filles[0])]++;
+        c->histogramme[algue_etat_indice(&filles[1])]++;
+      }
+      if (niveau == VERIFICATION_INCREMENTALE) {
+        // Les deux algues écrites dans la liste sont vérifiées : le courant
+        // passe de celle de gauche à celle de droite.
+        liste_remplacer_courant(l, vals, 2, 0);
+        algue_verifier_copie(liste_valeur_courant(l), &filles[0]);
+        liste_courant_suivant(l);
+        algue_verifier_copie(liste_valeur_courant(l), &filles[1]);
       } else {
-        liste_insertion_apres(l, p_petiteAlgue);
-        liste_insertion_avant(l, p_moyenneAlgue);
+        liste_remplacer_courant(l, vals, 2, 1);
       }
-      free(p_petiteAlgue);
-      free(p_moyenneAlgue);
-      liste_courant_suivant(l);   // Je passe sur la nouvelle algue de droite
-      liste_suppression_avant(l); // Je supprime l'ancienne algue courante
-    } else {                      // Sinon j'augmente sa taille
+    } else { // Sinon j'augmente sa taille
       ((algue *)liste_valeur_courant(l))->taille++;
+      if (niveau == VERIFICATION_INCREMENTALE) {
+        algue_verifier(liste_valeur_courant(l));
+      }
+      if (c != NULL) {
+        c->histogramme[algue_etat_indice(liste_valeur_courant(l))]++;
+      }
+    }
+    if (niveau == VERIFICATION_ECHANTILLON && tirage(&etat) <= seuil) {
+      algue_verifier(liste_valeur_courant(l));
     }
     // Je passe sur la prochaine prochaine algue à vérifier
     liste_courant_suivant(l);
     i++;
   }
-  test_algue_iteration(l);
+  if (niveau == VERIFICATION_COMPLETE) {
+    assert(liste_est_valide(l));
+    test_algue_iteration(l);
+  }
+}
+
+void algue_iteration(liste l) { iteration(l, NULL); }
+
+void algue_iteration_compter(liste l, algue_compteurs *c) {
+  assert(c != NULL);
+  iteration(l, c);
 }
 
-int main(void) {
-  liste l = algue_liste_init(&copier_algue, &afficher_algue, &detruire_algue);
-  FILE *f_out = fopen("algues_out.txt", "w");
-  fprintf(f_out, "la liste initiale\n");
-  liste_affichage(f_out, l);
-  fprintf(f_out, "\n");
-  for (int i = 0; i < NBITER; i++)
+/* Travail d'un thread : un segment de la colonie et ses itérations. */
+typedef struct segment {
+  liste l;
+  unsigned long long nb_iterations;
+} segment;
+
+/* Point d'entrée d'un thread : fait évoluer un segment de la colonie. */
+static void *algue_iterations_segment(void *arg) {
+  segment *s = arg;
+  for (unsigned long long i = 0; i < s->nb_iterations; i++) {
+    algue_iteration(s->l);
+  }
+  return NULL;
+}
+
+void algue_iterations_parallele(liste l, unsigned long long n,
+                                unsigned int nb_threads) {
+  assert(l != NULL);
+  // Tant que la colonie est trop petite pour être découpée, les itérations
+  // sont faites par le thread courant.
+  while (n > 0 && (nb_threads <= 1 ||
+                   liste_taille(l) / nb_threads < SEUIL_PARALLELE)) {
     algue_iteration(l);
-  fprintf(f_out, "la liste résultat de %d itérations\n", NBITER);
-  liste_affichage(f_out, l);
-  liste_detruire(&l);
-  fclose(f_out);
-  return 0;
+    n--;
+  }
+  if (n == 0) {
+    return;
+  }
+  unsigned int taille = liste_taille(l);
+  segment *segments = malloc(nb_threads * sizeof(segment));
+  pthread_t *threads = malloc(nb_threads * sizeof(pthread_t));
+  bool *lance = malloc(nb_threads * sizeof(bool));
+  // Découpage en segments contigus : segments[0] est le début de l, chaque
+  // segment suivant est détaché de la fin du précédent.
+  segments[0].l = l;
+  segments[0].nb_iterations = n;
+  for (unsigned int i = 1; i < nb_threads; i++) {
+    unsigned int debut = (unsigned int)((unsigned long long)taille * (i - 1) /
+                                        nb_threads);
+    unsigned int fin =
+        (unsigned int)((unsigned long long)taille * i / nb_threads);
+    segments[i].l = liste_scinder(segments[i - 1].l, fin - debut);
+    segments[i].nb_iterations = n;
+  }
+  // Chaque algue évolue indépendamment des autres : un segment peut faire
+  // toutes ses itérations sans attendre les autres. Le thread courant fait
+  // évoluer le premier segment.
+  for (unsigned int i = 1; i < nb_threads; i++) {
+    lance[i] = pthread_create(&threads[i], NULL, &algue_iterations_segment,
+                              &segments[i]) == 0;
+    if (!lance[i]) {
+      algue_iterations_segment(&segments[i]);
+    }
+  }
+  algue_iterations_segment(&segments[0]);
+  // Recollage des segments dans l'ordre
+  for (unsigned int i = 1; i < nb_threads; i++) {
+    if (lance[i]) {
+      pthread_join(threads[i], NULL);
+    }
+    liste_concatener(l, &segments[i].l);
+  }
+  free(lance);
+  free(threads);
+  free(segments);
+}
+
+void algue_iteration_parallele(liste l, unsigned int nb_threads) {
+  algue_iterations_parallele(l, 1, nb_threads);
 }
@@ -0,0 +1,195 @@
+#ifndef ALGUES
+#define ALGUES
+#include "listes_generiques.h"
+#include <stdio.h>
+
+/*! \file
+ * \brief Module de simulation des algues.
+ *
+ * Une colonie d'algues est une liste générique d'algues. À chaque itération,
+ * chaque algue grandit d'une unité ; une algue ayant atteint TMAX se divise en
+ * une petite algue (taille T1, même orientation) et une moyenne algue (taille
+ * T2, orientation opposée), la petite étant placée du côté de son orientation.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+#define GAUCHE -1
+#define DROITE 1
+#define T1 4
+#define T2 5
+#define TMIN 4
+#define TMAX 9
+#define NBITER 20
+
+/*
+* \brief Cette structure contient les attributs d'un algue, sa taille et son
+* orientation.
+*/
+typedef struct algue {
+  int taille;
+  int orientation;
+} algue;
+
+/*!
+ * \brief Paramètres de la règle d'évolution des algues.
+ */
+typedef struct algue_regle {
+  int t1;   /* taille de la petite algue issue d'une division */
+  int t2;   /* taille de la moyenne algue issue d'une division */
+  int tmin; /* taille minimale d'une algue */
+  int tmax; /* taille à laquelle une algue se divise */
+} algue_regle;
+
+/*! \brief Nombre d'états (taille, orientation) d'une algue. */
+#define NB_ETATS (2 * (TMAX - TMIN + 1))
+
+/*!
+ * \brief Compteurs d'une itération, remplis pendant le parcours de la colonie.
+ * L'état (taille, orientation) a pour indice
+ * 2 * (taille - TMIN) + (orientation == DROITE), comme dans algue_etat.
+ */
+typedef struct algue_compteurs {
+  unsigned long long divisions;             /* algues qui se sont divisées */
+  unsigned long long histogramme[NB_ETATS]; /* algues par état après
+                                               l'itération */
+} algue_compteurs;
+
+/*! \brief Règle définie par les constantes du module. */
+#define REGLE_DEFAUT                                                           \
+  { T1, T2, TMIN, TMAX }
+
+/*!
+ * \brief Niveaux de vérification des invariants pendant algue_iteration.
+ * Le niveau est choisi à l'exécution par algue_verification_choisir, ou figé
+ * à la compilation en définissant ALGUE_VERIFICATION (par exemple
+ * -DALGUE_VERIFICATION=VERIFICATION_AUCUNE), auquel cas les vérifications
+ * inutiles disparaissent du code.
+ */
+typedef enum algue_verification {
+  VERIFICATION_AUCUNE,       /* aucune vérification */
+  VERIFICATION_ECHANTILLON,  /* quelques algues tirées au hasard */
+  VERIFICATION_INCREMENTALE, /* chaque algue, au moment où elle évolue */
+  VERIFICATION_COMPLETE      /* toute la colonie et la structure de la liste,
+                                après l'itération */
+} algue_verification;
+
+/*! \brief Niveau de vérification utilisé à défaut d'autre choix. */
+#define VERIFICATION_DEFAUT VERIFICATION_INCREMENTALE
+/*! \brief Nombre d'algues vérifiées par itération en échantillonnage. */
+#define ECHANTILLON_DEFAUT 16
+
+/*!
+* \brief Créer une algue avec un taille T1 et une orientation à gauche.
+* \return Une algue avec un taille T1 et une orientation à gauche.
+*/
+algue *algue_init(void);
+
+/*!
+* \brief Créer une algue avec une taille et un orientation donnée.
+* \param _taille La taille de l'algue.
+* \param _orientation L'orientation de l'algue.
+* \return Une algue avec une taille et une orientation donnée.
+*/
+algue *algue_valeur(int _taille, int _orientation);
+
+/*!
+* \brief Définit la valeur de l'algue à partir d'une recopie.
+*/
+void copier_algue(void *val, void **pt);
+
+/*!
+* \brief Définit comment afficher une algue.
+* \param f Le fichier dans lequel afficher l'algue.
+* \param val Un pointeur vers la valeur.
+*/
+void afficher_algue(FILE *f, void *val);
+
+/*!
+* \brief Définit comment désallouer la mémoire pour une algue
+*/
+void detruire_algue(void **pt);
+
+/*!
+* \brief Retourne une liste initialisée avec une algue de taille T1 orientée
+* vers la gauche.
+* \param _copie une fonction qui définit la valeur de l'algue à partir d'une
+* recopie.
+* \param _afficher une fonction qui définit comment on affiche la valeur de
+* l'algue.
+* \param _detruire une fonction qui définit comment désallouer la mémoire
+* relative à la valeur de l'algue.
+* \return une liste initialisée avec une algue de taille T1 orientée vers la
+* gauche.
+*/
+liste algue_liste_init(void (*_copier)(void *val, void **pt),
+                       void (*_afficher)(FILE *f, void *val),
+                       void (*_detruire)(void **pt));
+
+/*!
+* \brief Retourne une liste externe (cf. liste_creer_externe) initialisée
+* comme par algue_liste_init, pour les colonies plus grandes que la mémoire.
+* Elle ne peut pas évoluer sur plusieurs threads.
+* \param repertoire répertoire du fichier de débordement, NULL par défaut.
+* \param budget mémoire de la colonie en octets, 0 par défaut.
+* \return la liste, NULL si le fichier de débordement n'a pas pu être créé.
+*/
+liste algue_liste_init_externe(char const *repertoire, size_t budget);
+
+/*!
+* A appeler après une itération. Vérifie que toute les algues de la liste ont
+* une taille entre TMIN et TMAX et une orientation valide.
+*/
+void test_algue_iteration(liste l);
+
+/*!
+ * \brief Choisit le niveau de vérification des itérations suivantes. Le choix
+ * est global : il doit être fait avant de lancer des itérations en parallèle.
+ * \param niveau niveau de vérification.
+ * \param echantillon nombre d'algues vérifiées par itération au niveau
+ * VERIFICATION_ECHANTILLON.
+ * \return false si le niveau est figé à la compilation à une autre valeur.
+ */
+bool algue_verification_choisir(algue_verification niveau,
+                                unsigned int echantillon);
+
+/*!
+ * \brief Fait évoluer chaque algue de la liste d'une itération.
+ * \param l colonie à faire évoluer.
+ */
+void algue_iteration(liste l);
+
+/*!
+ * \brief Fait évoluer chaque algue de la liste d'une itération, en comptant
+ * les divisions et les algues de chaque état au fur et à mesure.
+ * \param l colonie à faire évoluer.
+ * \param c compteurs remplis pour cette itération.
+ */
+void algue_iteration_compter(liste l, algue_compteurs *c);
+
+/*!
+ * \brief Fait évoluer la colonie de n itérations avec plusieurs threads.
+ * Dès que la colonie est assez grande, elle est découpée en segments
+ * contigus ; chaque thread fait faire toutes les itérations restantes à son
+ * segment comme à une liste séparée, puis les segments sont recollés dans
+ * l'ordre en temps constant. Le résultat est identique à celui de n appels à
+ * algue_iteration.
+ * \param l colonie à faire évoluer.
+ * \param n nombre d'itérations.
+ * \param nb_threads nombre de threads.
+ */
+void algue_iterations_parallele(liste l, unsigned long long n,
+                                unsigned int nb_threads);
+
+/*!
+ * \brief Fait évoluer la colonie d'une itération avec plusieurs threads.
+ * Le découpage en segments coûte un parcours partiel de la colonie à chaque
+ * appel : algue_iterations_parallele est préférable pour plusieurs
+ * itérations.
+ * \param l colonie à faire évoluer.
+ * \param nb_threads nombre de threads.
+ */
+void algue_iteration_parallele(liste l, unsigned int nb_threads);
+
+#endif
@@ -0,0 +1,229 @@
+#define _POSIX_C_SOURCE 200809L
+#include "algues_balayage.h"
+#include "algues_soa.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief File de travail d'un thread : les indices des configurations
+ * indices[debut..fin[ restent à faire. Le propriétaire prend à la fin, les
+ * voleurs au début.
+ */
+typedef struct file_travail {
+  pthread_mutex_t verrou;
+  size_t *indices;
+  size_t debut;
+  size_t fin;
+} file_travail;
+
+/*!
+ * \brief Données partagées par les threads d'un balayage.
+ */
+typedef struct balayage {
+  balayage_config const *configs;
+  balayage_resultat *resultats;
+  file_travail *files;
+  unsigned int nb_threads;
+} balayage;
+
+/*!
+ * \brief Travail d'un thread : son numéro et sa colonie réutilisée.
+ */
+typedef struct ouvrier {
+  balayage *b;
+  unsigned int numero;
+  colonie_soa colonie;
+} ouvrier;
+
+/*!
+ * \brief Durée écoulée depuis debut, en secondes.
+ */
+static double secondes_depuis(struct timespec const *debut) {
+  struct timespec fin;
+  clock_gettime(CLOCK_MONOTONIC, &fin);
+  return (double)(fin.tv_sec - debut->tv_sec) +
+         (double)(fin.tv_nsec - debut->tv_nsec) * 1e-9;
+}
+
+/*!
+ * \brief Simule une configuration dans la colonie du thread.
+ * \param o thread qui simule.
+ * \param i indice de la configuration.
+ */
+static void simuler(ouvrier *o, size_t i) {
+  balayage_config const *c = &o->b->configs[i];
+  balayage_resultat *r = &o->b->resultats[i];
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  // La formule close dit à l'avance si la colonie tient en mémoire
+  algue_stats_calculer(&c->regle, c->iterations, 0, &r->stats);
+  r->simule = r->stats.exact &&
+              r->stats.population <= BALAYAGE_POPULATION_MAX;
+  if (r->simule) {
+    if (o->colonie == NULL) {
+      o->colonie = colonie_soa_creer(&c->regle);
+    } else {
+      colonie_soa_reinitialiser(o->colonie, &c->regle);
+    }
+    for (unsigned long long k = 0; k < c->iterations; k++) {
+      colonie_soa_iteration(o->colonie);
+    }
+    colonie_soa_stats(o->colonie, c->iterations, &r->stats);
+  }
+  r->secondes = secondes_depuis(&debut);
+}
+
+/*!
+ * \brief Prend une configuration : d'abord à la fin de sa propre file, puis
+ * au début des files des autres threads.
+ * \param o thread qui cherche du travail.
+ * \param i indice de la configuration prise.
+ * \return false quand toutes les files sont vides.
+ */
+static bool prendre(ouvrier *o, size_t *i) {
+  balayage *b = o->b;
+  for (unsigned int k = 0; k < b->nb_threads; k++) {
+    file_travail *f = &b->files[(o->numero + k) % b->nb_threads];
+    bool trouve = false;
+    pthread_mutex_lock(&f->verrou);
+    if (f->debut < f->fin) {
+      *i = k == 0 ? f->indices[--f->fin] : f->indices[f->debut++];
+      trouve = true;
+    }
+    pthread_mutex_unlock(&f->verrou);
+    if (trouve) {
+      return true;
+    }
+  }
+  // Aucune tâche n'est créée pendant le balayage : les files restent vides.
+  return false;
+}
+
+/*!
+ * \brief Point d'entrée d'un thread.
+ */
+static void *travailler(void *arg) {
+  ouvrier *o = arg;
+  size_t i;
+  while (prendre(o, &i)) {
+    simuler(o, i);
+  }
+  return NULL;
+}
+
+bool balayage_regle_valide(algue_regle const *r) {
+  assert(r != NULL);
+  return r->tmin >= 1 && r->tmin <= r->tmax && r->tmax <= 127 &&
+         r->t1 >= r->tmin && r->t1 <= r->tmax && r->t2 >= r->tmin &&
+         r->t2 <= r->tmax &&
+         2 * (r->tmax - r->tmin + 1) <= ALGUE_STATS_MAX_ETATS;
+}
+
+bool balayage_lire(FILE *f, balayage_config **configs, size_t *n) {
+  assert(f != NULL && configs != NULL && n != NULL);
+  size_t capacite = 16;
+  size_t ligne_numero = 0;
+  char ligne[256];
+  *configs = malloc(capacite * sizeof(balayage_config));
+  *n = 0;
+  while (fgets(ligne, sizeof(ligne), f) != NULL) {
+    ligne_numero++;
+    char const *p = ligne + strspn(ligne, " \t\r\n");
+    if (*p == '\0' || *p == '#') {
+      continue;
+    }
+    balayage_config c;
+    char reste[2];
+    if (sscanf(p, "%d %d %d %d %llu %1s", &c.regle.t1, &c.regle.t2,
+               &c.regle.tmin, &c.regle.tmax, &c.iterations, reste) != 5 ||
+        !balayage_regle_valide(&c.regle)) {
+      free(*configs);
+      *configs = NULL;
+      *n = ligne_numero;
+      return false;
+    }
+    if (*n == capacite) {
+      capacite *= 2;
+      *configs = realloc(*configs, capacite * sizeof(balayage_config));
+      assert(*configs != NULL);
+    }
+    (*configs)[(*n)++] = c;
+  }
+  return true;
+}
+
+void balayage_executer(balayage_config const *configs, size_t n,
+                       unsigned int nb_threads, balayage_resultat *resultats) {
+  assert(configs != NULL || n == 0);
+  assert(resultats != NULL || n == 0);
+  assert(nb_threads > 0);
+  balayage b = {configs, resultats, NULL, nb_threads};
+  b.files = malloc(nb_threads * sizeof(file_travail));
+  ouvrier *ouvriers = malloc(nb_threads * sizeof(ouvrier));
+  pthread_t *threads = malloc(nb_threads * sizeof(pthread_t));
+  bool *lance = malloc(nb_threads * sizeof(bool));
+  // Distribution initiale en tourniquet : les configurations voisines, souvent
+  // de coûts proches, sont réparties entre les threads.
+  for (unsigned int t = 0; t < nb_threads; t++) {
+    file_travail *f = &b.files[t];
+    pthread_mutex_init(&f->verrou, NULL);
+    f->indices = malloc((n / nb_threads + 1) * sizeof(size_t));
+    f->debut = f->fin = 0;
+    for (size_t i = t; i < n; i += nb_threads) {
+      f->indices[f->fin++] = i;
+    }
+    ouvriers[t].b = &b;
+    ouvriers[t].numero = t;
+    ouvriers[t].colonie = NULL;
+  }
+  for (unsigned int t = 1; t < nb_threads; t++) {
+    lance[t] =
+        pthread_create(&threads[t], NULL, &travailler, &ouvriers[t]) == 0;
+  }
+  // Le thread courant travaille aussi ; il vole les files des threads qui
+  // n'ont pas pu être créés.
+  travailler(&ouvriers[0]);
+  for (unsigned int t = 0; t < nb_threads; t++) {
+    if (t > 0 && lance[t]) {
+      pthread_join(threads[t], NULL);
+    }
+    if (ouvriers[t].colonie != NULL) {
+      colonie_soa_detruire(&ouvriers[t].colonie);
+    }
+    pthread_mutex_destroy(&b.files[t].verrou);
+    free(b.files[t].indices);
+  }
+  free(lance);
+  free(threads);
+  free(ouvriers);
+  free(b.files);
+}
+
+void balayage_afficher(FILE *f, balayage_config const *c,
+                       balayage_resultat const *r) {
+  assert(f != NULL && c != NULL && r != NULL);
+  algue_stats const *s = &r->stats;
+  fprintf(f, "T1=%d T2=%d TMIN=%d TMAX=%d NBITER=%llu population=", c->regle.t1,
+          c->regle.t2, c->regle.tmin, c->regle.tmax, c->iterations);
+  algue_stats_afficher_effectif(f, s, s->population, s->log10_population);
+  for (int taille = c->regle.tmin; taille <= c->regle.tmax; taille++) {
+    for (int o = GAUCHE; o <= DROITE; o += DROITE - GAUCHE) {
+      unsigned int e = algue_etat(&c->regle, taille, o);
+      fprintf(f, " (%d,%d)=", taille, o);
+      algue_stats_afficher_effectif(f, s, s->histogramme[e],
+                                    s->log10_histogramme[e]);
+    }
+  }
+  fprintf(f, " %s temps=%.6f\n", r->simule ? "simulation" : "formule",
+          r->secondes);
+}
@@ -0,0 +1,91 @@
+#ifndef ALGUES_BALAYAGE
+#define ALGUES_BALAYAGE
+#include "algues.h"
+#include "algues_stats.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Balayage de paramètres de la simulation des algues.
+ *
+ * Un fichier de balayage contient une configuration par ligne, sous la forme
+ * de cinq entiers "T1 T2 TMIN TMAX NBITER" ; les lignes vides et celles qui
+ * commencent par # sont ignorées.
+ *
+ * Les configurations sont simulées en parallèle par un groupe de threads à
+ * vol de travail : chaque thread dépile les configurations de sa propre file
+ * et, quand elle est vide, en vole au début de la file d'un autre thread.
+ * Chaque thread garde une colonie (moteur par tableaux parallèles) dont les
+ * tampons servent à toutes ses simulations : les threads ne se disputent pas
+ * l'allocateur.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Population au-delà de laquelle une colonie n'est pas simulée. */
+#define BALAYAGE_POPULATION_MAX (1ULL << 24)
+
+/*!
+ * \brief Une configuration à simuler.
+ */
+typedef struct balayage_config {
+  algue_regle regle;
+  unsigned long long iterations;
+} balayage_config;
+
+/*!
+ * \brief Résultat d'une configuration.
+ */
+typedef struct balayage_resultat {
+  algue_stats stats;
+  bool simule;     /* faux si la colonie, trop grande, a été calculée par
+                      algue_stats_calculer au lieu d'être simulée */
+  double secondes; /* durée du calcul */
+} balayage_resultat;
+
+/*!
+ * \brief Vérifie qu'une règle peut être simulée : les tailles sont positives,
+ * t1 et t2 sont entre tmin et tmax, tmax tient sur un octet signé et le
+ * nombre d'états ne dépasse pas ALGUE_STATS_MAX_ETATS.
+ * \param r règle à vérifier.
+ * \return true ssi la règle est valide.
+ */
+bool balayage_regle_valide(algue_regle const *r);
+
+/*!
+ * \brief Lecture d'un fichier de balayage.
+ * \param f fichier ouvert en lecture.
+ * \param configs tableau alloué des configurations lues, à libérer par free.
+ * \param n nombre de configurations lues.
+ * \return true ssi le fichier est valide ; sinon rien n'est alloué et n est le
+ * numéro de la ligne invalide.
+ */
+bool balayage_lire(FILE *f, balayage_config **configs, size_t *n);
+
+/*!
+ * \brief Simule toutes les configurations.
+ * Une colonie dont la population finale dépasse BALAYAGE_POPULATION_MAX est
+ * calculée par algue_stats_calculer.
+ * \param configs configurations à simuler.
+ * \param n nombre de configurations.
+ * \param nb_threads nombre de threads.
+ * \param resultats tableau de n résultats à remplir, dans l'ordre des
+ * configurations.
+ */
+void balayage_executer(balayage_config const *configs, size_t n,
+                       unsigned int nb_threads, balayage_resultat *resultats);
+
+/*!
+ * \brief Affichage du résultat d'une configuration sur une ligne.
+ * Le résultat est de la forme :
+ * \verbatim T1=4 T2=5 TMIN=4 TMAX=9 NBITER=20 population=8 (4,-1)=0 ... simulation temps=0.000012\endverbatim
+ * \param f flux où imprimer.
+ * \param c configuration.
+ * \param r résultat de la configuration.
+ */
+void balayage_afficher(FILE *f, balayage_config const *c,
+                       balayage_resultat const *r);
+
+#endif
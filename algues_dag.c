@@ -0,0 +1,237 @@
+#include "algues_dag.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Les nœuds sont rangés par niveau k puis par état : le nœud (s, k) a
+ * l'indice k * nb_etats + s dans longueurs, et ses effectifs commencent à
+ * l'indice (k * nb_etats + s) * nb_etats dans effectifs.
+ * suivant[s] est l'état dans lequel une algue de l'état s passe en grandissant
+ * ; gauche[s] et droite[s] sont les états de ses deux filles si elle se
+ * divise.
+ */
+struct colonie_dag_struct {
+  algue_regle regle;
+  unsigned int n;
+  unsigned int nb_etats;
+  unsigned int racine;
+  unsigned long long *longueurs;
+  unsigned long long *effectifs;
+  bool divise[ALGUE_STATS_MAX_ETATS];
+  unsigned int suivant[ALGUE_STATS_MAX_ETATS];
+  unsigned int gauche[ALGUE_STATS_MAX_ETATS];
+  unsigned int droite[ALGUE_STATS_MAX_ETATS];
+};
+
+/*!
+ * \brief Nœud à visiter lors d'un parcours.
+ */
+typedef struct noeud {
+  unsigned int etat;
+  unsigned int k;
+} noeud;
+
+/*!
+ * \brief Le parcours est une pile de nœuds restant à développer, le sommet
+ * étant le prochain.
+ */
+struct colonie_dag_parcours_struct {
+  colonie_dag d;
+  noeud *pile;
+  unsigned int hauteur;
+};
+
+/*!
+ * \brief Somme saturée à ULLONG_MAX.
+ */
+static unsigned long long somme_saturee(unsigned long long a,
+                                        unsigned long long b) {
+  return a > ULLONG_MAX - b ? ULLONG_MAX : a + b;
+}
+
+/*!
+ * \brief Retourne l'algue correspondant à un état.
+ * \param d colonie dont on utilise la règle.
+ * \param etat indice de l'état.
+ */
+static algue etat_algue(colonie_dag d, unsigned int etat) {
+  algue a = {d->regle.tmin + (int)(etat / 2), etat % 2 ? DROITE : GAUCHE};
+  return a;
+}
+
+colonie_dag colonie_dag_creer(algue_regle const *r, unsigned int n) {
+  assert(r != NULL);
+  colonie_dag d = malloc(sizeof(struct colonie_dag_struct));
+  algue_stats s;
+  algue_stats_initialiser(r, 0, &s);
+  d->regle = *r;
+  d->n = n;
+  d->nb_etats = s.nb_etats;
+  d->racine = algue_etat(r, r->t1, GAUCHE);
+  unsigned int e = d->nb_etats;
+  for (int taille = r->tmin; taille <= r->tmax; taille++) {
+    for (int o = GAUCHE; o <= DROITE; o += DROITE - GAUCHE) {
+      unsigned int i = algue_etat(r, taille, o);
+      d->divise[i] = taille >= r->tmax;
+      if (d->divise[i]) {
+        d->suivant[i] = i;
+        d->gauche[i] = algue_etat(r, o == GAUCHE ? r->t1 : r->t2, GAUCHE);
+        d->droite[i] = algue_etat(r, o == GAUCHE ? r->t2 : r->t1, DROITE);
+      } else {
+        d->suivant[i] = algue_etat(r, taille + 1, o);
+        d->gauche[i] = d->droite[i] = i;
+      }
+    }
+  }
+  d->longueurs = malloc(((size_t)n + 1) * e * sizeof(unsigned long long));
+  d->effectifs = calloc(((size_t)n + 1) * e * e, sizeof(unsigned long long));
+  assert(d->longueurs != NULL && d->effectifs != NULL);
+  for (unsigned int i = 0; i < e; i++) {
+    d->longueurs[i] = 1;
+    d->effectifs[i * e + i] = 1;
+  }
+  for (unsigned int k = 1; k <= n; k++) {
+    unsigned long long const *l_prec = d->longueurs + (size_t)(k - 1) * e;
+    unsigned long long const *e_prec = d->effectifs + (size_t)(k - 1) * e * e;
+    unsigned long long *l_k = d->longueurs + (size_t)k * e;
+    unsigned long long *e_k = d->effectifs + (size_t)k * e * e;
+    for (unsigned int i = 0; i < e; i++) {
+      if (d->divise[i]) {
+        unsigned int g = d->gauche[i], dr = d->droite[i];
+        l_k[i] = somme_saturee(l_prec[g], l_prec[dr]);
+        for (unsigned int j = 0; j < e; j++) {
+          e_k[i * e + j] = e_prec[g * e + j] + e_prec[dr * e + j];
+        }
+      } else {
+        l_k[i] = l_prec[d->suivant[i]];
+        memcpy(e_k + i * e, e_prec + d->suivant[i] * e,
+               e * sizeof(unsigned long long));
+      }
+    }
+  }
+  return d;
+}
+
+void colonie_dag_detruire(colonie_dag *d) {
+  assert(d != NULL && *d != NULL);
+  free((*d)->longueurs);
+  free((*d)->effectifs);
+  free(*d);
+  *d = NULL;
+}
+
+unsigned long long colonie_dag_taille(colonie_dag d) {
+  assert(d != NULL);
+  return d->longueurs[(size_t)d->n * d->nb_etats + d->racine];
+}
+
+algue colonie_dag_valeur(colonie_dag d, unsigned long long i) {
+  assert(d != NULL && i < colonie_dag_taille(d));
+  unsigned int etat = d->racine;
+  for (unsigned int k = d->n; k > 0; k--) {
+    if (d->divise[etat]) {
+      unsigned long long l_gauche =
+          d->longueurs[(size_t)(k - 1) * d->nb_etats + d->gauche[etat]];
+      if (i < l_gauche) {
+        etat = d->gauche[etat];
+      } else {
+        i -= l_gauche;
+        etat = d->droite[etat];
+      }
+    } else {
+      etat = d->suivant[etat];
+    }
+  }
+  return etat_algue(d, etat);
+}
+
+void colonie_dag_stats(colonie_dag d, algue_stats *s) {
+  assert(d != NULL && s != NULL);
+  if (colonie_dag_taille(d) == ULLONG_MAX) {
+    /* les effectifs ont débordé : seul leur calcul modulaire a un sens */
+    algue_stats_calculer(&d->regle, d->n, 0, s);
+    return;
+  }
+  algue_stats_initialiser(&d->regle, d->n, s);
+  unsigned long long const *effectifs =
+      d->effectifs + ((size_t)d->n * d->nb_etats + d->racine) * d->nb_etats;
+  memcpy(s->histogramme, effectifs, d->nb_etats * sizeof(unsigned long long));
+  algue_stats_terminer(s);
+}
+
+colonie_dag_parcours colonie_dag_parcours_creer(colonie_dag d) {
+  assert(d != NULL);
+  colonie_dag_parcours p = malloc(sizeof(struct colonie_dag_parcours_struct));
+  p->d = d;
+  /* chaque division remplace un nœud par deux nœuds d'un niveau inférieur :
+     la pile ne dépasse pas n + 1 nœuds */
+  p->pile = malloc(((size_t)d->n + 1) * sizeof(noeud));
+  p->pile[0].etat = d->racine;
+  p->pile[0].k = d->n;
+  p->hauteur = 1;
+  return p;
+}
+
+bool colonie_dag_parcours_suivant(colonie_dag_parcours p, algue *a) {
+  assert(p != NULL && a != NULL);
+  if (p->hauteur == 0) {
+    return false;
+  }
+  noeud m = p->pile[--p->hauteur];
+  while (m.k > 0) {
+    if (p->d->divise[m.etat]) {
+      p->pile[p->hauteur].etat = p->d->droite[m.etat];
+      p->pile[p->hauteur++].k = m.k - 1;
+      m.etat = p->d->gauche[m.etat];
+    } else {
+      m.etat = p->d->suivant[m.etat];
+    }
+    m.k--;
+  }
+  *a = etat_algue(p->d, m.etat);
+  return true;
+}
+
+void colonie_dag_parcours_detruire(colonie_dag_parcours *p) {
+  assert(p != NULL && *p != NULL);
+  free((*p)->pile);
+  free(*p);
+  *p = NULL;
+}
+
+void colonie_dag_affichage(FILE *f, colonie_dag d) {
+  assert(f != NULL && d != NULL);
+  colonie_dag_parcours p = colonie_dag_parcours_creer(d);
+  algue a;
+  fprintf(f, "Liste de %llu éléments : [ ", colonie_dag_taille(d));
+  while (colonie_dag_parcours_suivant(p, &a)) {
+    fprintf(f, "(%d,%d)", a.taille, a.orientation);
+  }
+  fprintf(f, "]");
+  colonie_dag_parcours_detruire(&p);
+}
+
+liste colonie_dag_vers_liste(colonie_dag d, unsigned long long max_taille) {
+  assert(d != NULL);
+  if (colonie_dag_taille(d) > max_taille) {
+    return NULL;
+  }
+  liste l = liste_creer(&copier_algue, &afficher_algue, &detruire_algue);
+  colonie_dag_parcours p = colonie_dag_parcours_creer(d);
+  algue a;
+  while (colonie_dag_parcours_suivant(p, &a)) {
+    liste_insertion_fin(l, &a);
+  }
+  colonie_dag_parcours_detruire(&p);
+  return l;
+}
@@ -0,0 +1,119 @@
+#ifndef ALGUES_DAG
+#define ALGUES_DAG
+#include "algues.h"
+#include "algues_stats.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Représentation partagée des très grandes colonies d'algues.
+ *
+ * Une algue dans un état (taille, orientation) donne toujours la même
+ * suite d'algues après k itérations. La colonie obtenue après n itérations
+ * est donc représentée, comme une corde de L-système, par un graphe sans
+ * cycle où chaque couple (état, k) est un nœud unique : une feuille si
+ * k = 0, le nœud (état suivant, k - 1) si l'algue grandit, et la
+ * concaténation des nœuds de ses deux filles à k - 1 si elle se divise.
+ *
+ * Chaque nœud connaît sa longueur et son effectif par état. La colonie de la
+ * génération n occupe O(états × n) nœuds, quelle que soit sa population.
+ *
+ * Les longueurs sont saturées à ULLONG_MAX : l'accès aux algues reste correct
+ * pour toutes les positions inférieures.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Colonie d'algues partagée.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_dag_struct *colonie_dag;
+
+/*!
+ * \brief Parcours dans l'ordre d'une colonie partagée.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_dag_parcours_struct *colonie_dag_parcours;
+
+/*!
+ * \brief Construction de la colonie issue de n itérations d'une algue de
+ * taille r->t1 orientée vers la gauche.
+ * \param r règle d'évolution, recopiée dans la colonie.
+ * \param n nombre d'itérations.
+ * \return une nouvelle colonie.
+ */
+colonie_dag colonie_dag_creer(algue_regle const *r, unsigned int n);
+
+/*!
+ * \brief Destruction de la colonie.
+ * \param d pointeur vers la colonie à détruire.
+ */
+void colonie_dag_detruire(colonie_dag *d);
+
+/*!
+ * \brief Retourne le nombre d'algues de la colonie.
+ * \param d colonie sur laquelle porte la demande.
+ * \return le nombre d'algues, ou ULLONG_MAX s'il ne tient pas sur 64 bits.
+ */
+unsigned long long colonie_dag_taille(colonie_dag d);
+
+/*!
+ * \brief Retourne l'algue à la position i, en O(n).
+ * \param d colonie sur laquelle porte la demande.
+ * \param i position de l'algue, inférieure à la taille de la colonie.
+ * \return l'algue à la position i.
+ */
+algue colonie_dag_valeur(colonie_dag d, unsigned long long i);
+
+/*!
+ * \brief Calcule les statistiques de la colonie à partir des effectifs de
+ * sa racine.
+ * \param d colonie à compter.
+ * \param s statistiques à remplir.
+ */
+void colonie_dag_stats(colonie_dag d, algue_stats *s);
+
+/*!
+ * \brief Création d'un parcours positionné avant la première algue.
+ * La colonie ne doit pas être détruite avant le parcours.
+ * \param d colonie à parcourir.
+ * \return un nouveau parcours.
+ */
+colonie_dag_parcours colonie_dag_parcours_creer(colonie_dag d);
+
+/*!
+ * \brief Passe à l'algue suivante.
+ * \param p parcours à avancer.
+ * \param a algue lue, si elle existe.
+ * \return false si le parcours est terminé.
+ */
+bool colonie_dag_parcours_suivant(colonie_dag_parcours p, algue *a);
+
+/*!
+ * \brief Destruction du parcours.
+ * \param p pointeur vers le parcours à détruire.
+ */
+void colonie_dag_parcours_detruire(colonie_dag_parcours *p);
+
+/*!
+ * \brief Affichage de la colonie, dans le même format que liste_affichage,
+ * sans passage à la ligne à la fin.
+ * \param f flux où imprimer.
+ * \param d colonie à afficher.
+ */
+void colonie_dag_affichage(FILE *f, colonie_dag d);
+
+/*!
+ * \brief Matérialise la colonie dans une liste d'algues si elle est assez
+ * petite.
+ * \param d colonie à matérialiser.
+ * \param max_taille taille maximale acceptée.
+ * \return une nouvelle liste d'algues (copier_algue, afficher_algue,
+ * detruire_algue) contenant les algues de la colonie dans l'ordre, ou NULL si
+ * la colonie compte plus de max_taille algues.
+ */
+liste colonie_dag_vers_liste(colonie_dag d, unsigned long long max_taille);
+
+#endif
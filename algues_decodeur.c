@@ -0,0 +1,37 @@
+#include "algues_flux.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Retraduit un fichier de colonies binaire ou rle (./algues --format) dans le
+ * format texte de algues_out.txt.
+ */
+int main(int argc, char *argv[]) {
+  if (argc != 2 && argc != 3) {
+    fprintf(stderr, "usage : %s ENTREE [SORTIE]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  FILE *f_in = fopen(argv[1], "rb");
+  if (f_in == NULL) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  FILE *f_out = argc == 3 ? fopen(argv[2], "w") : stdout;
+  if (f_out == NULL) {
+    perror(argv[2]);
+    fclose(f_in);
+    return EXIT_FAILURE;
+  }
+  flux_algues fx = flux_algues_creer(f_out, FORMAT_TEXTE);
+  bool valide = flux_algues_recopier(f_in, fx);
+  flux_algues_detruire(&fx);
+  fclose(f_in);
+  if (f_out != stdout) {
+    fclose(f_out);
+  }
+  if (!valide) {
+    fprintf(stderr, "%s : fichier de colonies invalide\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
@@ -0,0 +1,353 @@
+#include "algues_flux.h"
+#include "algues.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Signature des fichiers binaires et rle. */
+#define SIGNATURE "ALGUES"
+/*! \brief Version du format des fichiers binaires et rle. */
+#define VERSION 1
+/*! \brief Période maximale d'un motif répété en rle. */
+#define PERIODE_MAX 128
+/*! \brief Longueur minimale d'une répétition en rle. */
+#define REPETITION_MIN 4
+/*! \brief Nombre d'octets compressés d'un coup en rle. */
+#define TAMPON_RLE 65536
+
+/*!
+ * \brief Pour le format rle, les octets à compresser sont accumulés dans
+ * tampon, précédés des historique derniers octets déjà compressés de la même
+ * colonie, auxquels les répétitions peuvent faire référence.
+ */
+struct flux_algues_struct {
+  FILE *f;
+  flux_format format;
+  bool premiere;                 /* aucune colonie n'a encore été écrite */
+  unsigned long long restantes;  /* algues restant à écrire */
+  char textes[256][12];          /* texte de chaque octet, "" si inconnu */
+  unsigned char *tampon;
+  size_t historique;
+  size_t fin;
+};
+
+unsigned char algue_octet(int taille, int orientation) {
+  assert(taille >= 0 && taille <= 127);
+  assert(orientation == GAUCHE || orientation == DROITE);
+  return (unsigned char)(taille << 1 | (orientation == DROITE));
+}
+
+int octet_taille(unsigned char octet) { return octet >> 1; }
+
+int octet_orientation(unsigned char octet) {
+  return octet & 1 ? DROITE : GAUCHE;
+}
+
+/*!
+ * \brief Écriture d'un entier sur 8 octets petit-boutistes.
+ */
+static void ecrire_u64(FILE *f, unsigned long long n) {
+  for (int i = 0; i < 8; i++) {
+    putc((int)(n >> (8 * i) & 0xFF), f);
+  }
+}
+
+/*!
+ * \brief Lecture d'un entier sur 8 octets petit-boutistes.
+ * \return true ssi les 8 octets ont pu être lus.
+ */
+static bool lire_u64(FILE *f, unsigned long long *n) {
+  unsigned char octets[8];
+  if (fread(octets, 1, 8, f) != 8) {
+    return false;
+  }
+  *n = 0;
+  for (int i = 7; i >= 0; i--) {
+    *n = *n << 8 | octets[i];
+  }
+  return true;
+}
+
+/*!
+ * \brief Écriture d'un entier LEB128 : 7 bits par octet, le bit de poids fort
+ * indiquant qu'un octet suit.
+ */
+static void ecrire_leb128(FILE *f, unsigned long long n) {
+  while (n >= 0x80) {
+    putc((int)(n & 0x7F) | 0x80, f);
+    n >>= 7;
+  }
+  putc((int)n, f);
+}
+
+/*!
+ * \brief Lecture d'un entier LEB128.
+ * \return true ssi l'entier a pu être lu.
+ */
+static bool lire_leb128(FILE *f, unsigned long long *n) {
+  *n = 0;
+  for (int decalage = 0; decalage < 64; decalage += 7) {
+    int c = getc(f);
+    if (c == EOF) {
+      return false;
+    }
+    *n |= (unsigned long long)(c & 0x7F) << decalage;
+    if (!(c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief Écriture d'octets non compressés en rle, par jetons de 128 au plus.
+ */
+static void rle_litteraux(FILE *f, unsigned char const *octets, size_t n) {
+  while (n > 0) {
+    size_t k = n < 128 ? n : 128;
+    putc((int)(k - 1), f);
+    fwrite(octets, 1, k, f);
+    octets += k;
+    n -= k;
+  }
+}
+
+/*!
+ * \brief Compresse les octets du tampon qui suivent l'historique, puis garde
+ * les derniers comme nouvel historique.
+ * Chaque position est comparée aux PERIODE_MAX précédentes et la plus longue
+ * répétition est retenue si elle atteint REPETITION_MIN octets.
+ * \param fx flux au format rle.
+ */
+static void rle_compresser(flux_algues fx) {
+  unsigned char const *b = fx->tampon;
+  size_t i = fx->historique;
+  size_t litteral = i;
+  while (i < fx->fin) {
+    size_t meilleure = 0;
+    size_t periode = 0;
+    for (size_t p = 1; p <= PERIODE_MAX && p <= i; p++) {
+      size_t n = 0;
+      while (i + n < fx->fin && b[i + n] == b[i + n - p]) {
+        n++;
+      }
+      if (n > meilleure) {
+        meilleure = n;
+        periode = p;
+        if (i + n == fx->fin) {
+          break;
+        }
+      }
+    }
+    if (meilleure >= REPETITION_MIN) {
+      rle_litteraux(fx->f, b + litteral, i - litteral);
+      putc((int)(0x80 | (periode - 1)), fx->f);
+      ecrire_leb128(fx->f, meilleure);
+      i += meilleure;
+      litteral = i;
+    } else {
+      i++;
+    }
+  }
+  rle_litteraux(fx->f, b + litteral, fx->fin - litteral);
+  size_t garde = fx->fin < PERIODE_MAX ? fx->fin : PERIODE_MAX;
+  memmove(fx->tampon, fx->tampon + fx->fin - garde, garde);
+  fx->historique = fx->fin = garde;
+}
+
+flux_algues flux_algues_creer(FILE *f, flux_format format) {
+  assert(f != NULL);
+  flux_algues fx = malloc(sizeof(struct flux_algues_struct));
+  fx->f = f;
+  fx->format = format;
+  fx->premiere = true;
+  fx->restantes = 0;
+  memset(fx->textes, 0, sizeof(fx->textes));
+  fx->tampon = NULL;
+  fx->historique = fx->fin = 0;
+  if (format == FORMAT_RLE) {
+    fx->tampon = malloc(PERIODE_MAX + TAMPON_RLE);
+  }
+  if (format != FORMAT_TEXTE) {
+    fwrite(SIGNATURE, 1, strlen(SIGNATURE), f);
+    putc(VERSION, f);
+    putc(format, f);
+  }
+  return fx;
+}
+
+void flux_algues_detruire(flux_algues *fx) {
+  assert(fx != NULL && *fx != NULL);
+  assert((*fx)->restantes == 0);
+  fflush((*fx)->f);
+  free((*fx)->tampon);
+  free(*fx);
+  *fx = NULL;
+}
+
+void flux_algues_debut(flux_algues fx, bool initiale,
+                       unsigned long long iterations,
+                       unsigned long long taille) {
+  assert(fx != NULL && fx->restantes == 0);
+  fx->restantes = taille;
+  if (fx->format == FORMAT_TEXTE) {
+    if (!fx->premiere) {
+      fprintf(fx->f, "\n");
+    }
+    if (initiale) {
+      fprintf(fx->f, "la liste initiale\n");
+    } else {
+      fprintf(fx->f, "la liste résultat de %llu itérations\n", iterations);
+    }
+    fprintf(fx->f, "Liste de %llu éléments : [ ", taille);
+  } else {
+    putc(initiale, fx->f);
+    ecrire_u64(fx->f, iterations);
+    ecrire_u64(fx->f, taille);
+  }
+  fx->premiere = false;
+}
+
+void flux_algues_ecrire(flux_algues fx, int taille, int orientation) {
+  assert(fx != NULL && fx->restantes > 0);
+  unsigned char octet = algue_octet(taille, orientation);
+  fx->restantes--;
+  switch (fx->format) {
+  case FORMAT_TEXTE:
+    if (fx->textes[octet][0] == '\0') {
+      sprintf(fx->textes[octet], "(%d,%d)", taille, orientation);
+    }
+    fputs(fx->textes[octet], fx->f);
+    break;
+  case FORMAT_BINAIRE:
+    putc(octet, fx->f);
+    break;
+  case FORMAT_RLE:
+    fx->tampon[fx->fin++] = octet;
+    if (fx->fin == PERIODE_MAX + TAMPON_RLE) {
+      rle_compresser(fx);
+    }
+    break;
+  }
+}
+
+void flux_algues_fin(flux_algues fx) {
+  assert(fx != NULL && fx->restantes == 0);
+  if (fx->format == FORMAT_TEXTE) {
+    fprintf(fx->f, "]");
+  } else if (fx->format == FORMAT_RLE) {
+    rle_compresser(fx);
+    /* les colonies sont indépendantes */
+    fx->historique = fx->fin = 0;
+  }
+}
+
+bool flux_algues_lire_entete(FILE *f, flux_format *format) {
+  assert(f != NULL && format != NULL);
+  char signature[sizeof(SIGNATURE)] = "";
+  if (fread(signature, 1, strlen(SIGNATURE), f) != strlen(SIGNATURE) ||
+      strcmp(signature, SIGNATURE) != 0 || getc(f) != VERSION) {
+    return false;
+  }
+  int c = getc(f);
+  if (c != FORMAT_BINAIRE && c != FORMAT_RLE) {
+    return false;
+  }
+  *format = (flux_format)c;
+  return true;
+}
+
+/*!
+ * \brief Recopie n algues au format binaire.
+ * \return true ssi les n algues ont pu être lues.
+ */
+static bool recopier_binaire(FILE *f, flux_algues fx, unsigned long long n) {
+  unsigned char octets[4096];
+  while (n > 0) {
+    size_t k = n < sizeof(octets) ? (size_t)n : sizeof(octets);
+    if (fread(octets, 1, k, f) != k) {
+      return false;
+    }
+    for (size_t i = 0; i < k; i++) {
+      flux_algues_ecrire(fx, octet_taille(octets[i]),
+                         octet_orientation(octets[i]));
+    }
+    n -= k;
+  }
+  return true;
+}
+
+/*!
+ * \brief Recopie n algues au format rle. Les PERIODE_MAX derniers octets
+ * décodés sont conservés dans un tampon circulaire pour les répétitions.
+ * \return true ssi les n algues ont pu être lues.
+ */
+static bool recopier_rle(FILE *f, flux_algues fx, unsigned long long n) {
+  unsigned char recents[PERIODE_MAX];
+  unsigned long long produits = 0;
+  while (produits < n) {
+    int c = getc(f);
+    unsigned long long k;
+    if (c == EOF) {
+      return false;
+    }
+    if (c < 0x80) {
+      k = (unsigned long long)c + 1;
+      if (k > n - produits) {
+        return false;
+      }
+      for (unsigned long long i = 0; i < k; i++) {
+        int octet = getc(f);
+        if (octet == EOF) {
+          return false;
+        }
+        recents[produits++ % PERIODE_MAX] = (unsigned char)octet;
+        flux_algues_ecrire(fx, octet_taille((unsigned char)octet),
+                           octet_orientation((unsigned char)octet));
+      }
+    } else {
+      unsigned long long p = (unsigned long long)(c & 0x7F) + 1;
+      if (!lire_leb128(f, &k) || p > produits || k > n - produits) {
+        return false;
+      }
+      for (unsigned long long i = 0; i < k; i++) {
+        unsigned char octet = recents[(produits - p) % PERIODE_MAX];
+        recents[produits++ % PERIODE_MAX] = octet;
+        flux_algues_ecrire(fx, octet_taille(octet), octet_orientation(octet));
+      }
+    }
+  }
+  return true;
+}
+
+bool flux_algues_recopier(FILE *f, flux_algues fx) {
+  assert(f != NULL && fx != NULL);
+  flux_format format;
+  if (!flux_algues_lire_entete(f, &format)) {
+    return false;
+  }
+  int initiale;
+  while ((initiale = getc(f)) != EOF) {
+    unsigned long long iterations, taille;
+    if (!lire_u64(f, &iterations) || !lire_u64(f, &taille)) {
+      return false;
+    }
+    flux_algues_debut(fx, initiale == 1, iterations, taille);
+    bool valide = format == FORMAT_BINAIRE ? recopier_binaire(f, fx, taille)
+                                           : recopier_rle(f, fx, taille);
+    if (!valide) {
+      fx->restantes = 0;
+      return false;
+    }
+    flux_algues_fin(fx);
+  }
+  return true;
+}
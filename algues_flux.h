@@ -0,0 +1,125 @@
+#ifndef ALGUES_FLUX
+#define ALGUES_FLUX
+#include <stdbool.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Écriture en flux des colonies d'algues.
+ *
+ * Les algues sont écrites une à une pendant le parcours de la colonie, sans
+ * construire de représentation intermédiaire. Trois formats sont proposés :
+ * - texte : le format de liste_affichage, précédé des titres de algues_out.txt
+ *   ;
+ * - binaire : un octet par algue, la taille dans les 7 bits de poids fort et
+ *   l'orientation (1 pour DROITE) dans le bit de poids faible ;
+ * - rle : les mêmes octets, dont les motifs répétés sont compressés.
+ *
+ * Un fichier binaire ou rle commence par un en-tête de 8 octets ("ALGUES",
+ * une version, le format) suivi d'une colonie par enregistrement : un octet
+ * (1 pour la colonie initiale), le nombre d'itérations et le nombre d'algues
+ * sur 8 octets petit-boutistes, puis les données.
+ *
+ * Les données rle sont une suite de jetons : un octet c < 128 est suivi de
+ * c + 1 octets recopiés tels quels ; un octet 128 + p - 1 est suivi d'une
+ * longueur n (entier LEB128) et répète les n octets obtenus en recopiant
+ * ceux situés p octets plus tôt.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Formats d'écriture.
+ */
+typedef enum flux_format {
+  FORMAT_TEXTE,
+  FORMAT_BINAIRE,
+  FORMAT_RLE
+} flux_format;
+
+/*!
+ * \brief Flux d'écriture de colonies.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct flux_algues_struct *flux_algues;
+
+/*!
+ * \brief Code d'une algue sur un octet.
+ * \param taille taille de l'algue, entre 0 et 127.
+ * \param orientation GAUCHE ou DROITE.
+ * \return l'octet codant l'algue.
+ */
+unsigned char algue_octet(int taille, int orientation);
+
+/*!
+ * \brief Décode la taille d'une algue codée sur un octet.
+ * \param octet code de l'algue.
+ * \return la taille de l'algue.
+ */
+int octet_taille(unsigned char octet);
+
+/*!
+ * \brief Décode l'orientation d'une algue codée sur un octet.
+ * \param octet code de l'algue.
+ * \return GAUCHE ou DROITE.
+ */
+int octet_orientation(unsigned char octet);
+
+/*!
+ * \brief Création d'un flux écrivant dans f. Pour les formats binaires,
+ * l'en-tête est écrit immédiatement.
+ * \param f fichier ouvert en écriture, qui n'est pas fermé par le flux.
+ * \param format format d'écriture.
+ * \return un nouveau flux.
+ */
+flux_algues flux_algues_creer(FILE *f, flux_format format);
+
+/*!
+ * \brief Destruction du flux, après écriture des données en attente.
+ * \param fx pointeur vers le flux à détruire.
+ */
+void flux_algues_detruire(flux_algues *fx);
+
+/*!
+ * \brief Commence l'écriture d'une colonie.
+ * \param fx flux où écrire.
+ * \param initiale vrai pour la colonie initiale, faux pour un résultat.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param taille nombre d'algues qui seront écrites.
+ */
+void flux_algues_debut(flux_algues fx, bool initiale,
+                       unsigned long long iterations, unsigned long long taille);
+
+/*!
+ * \brief Écrit l'algue suivante de la colonie commencée.
+ * \param fx flux où écrire.
+ * \param taille taille de l'algue.
+ * \param orientation orientation de l'algue.
+ */
+void flux_algues_ecrire(flux_algues fx, int taille, int orientation);
+
+/*!
+ * \brief Termine la colonie commencée, dont toutes les algues ont été
+ * écrites.
+ * \param fx flux où écrire.
+ */
+void flux_algues_fin(flux_algues fx);
+
+/*!
+ * \brief Lecture d'un en-tête de fichier binaire ou rle.
+ * \param f fichier ouvert en lecture.
+ * \param format format lu.
+ * \return true ssi l'en-tête est valide.
+ */
+bool flux_algues_lire_entete(FILE *f, flux_format *format);
+
+/*!
+ * \brief Recopie toutes les colonies d'un fichier binaire ou rle dans un
+ * flux, par exemple pour les retraduire en texte.
+ * \param f fichier ouvert en lecture.
+ * \param fx flux où écrire.
+ * \return true ssi le fichier est valide.
+ */
+bool flux_algues_recopier(FILE *f, flux_algues fx);
+
+#endif
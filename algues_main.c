@@ -0,0 +1,682 @@
+#include "algues.h"
+#include "algues_balayage.h"
+#include "algues_dag.h"
+#include "algues_flux.h"
+#include "algues_metriques.h"
+#include "algues_paresseux.h"
+#include "algues_reprise.h"
+#include "algues_soa.h"
+#include "algues_stats.h"
+#include "algues_swar.h"
+#include "listes_trace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * \brief Moteurs de simulation disponibles.
+ */
+typedef enum moteur {
+  MOTEUR_LISTE,
+  MOTEUR_SOA,
+  MOTEUR_SWAR,
+  MOTEUR_PARESSEUX,
+  MOTEUR_DAG
+} moteur;
+
+/*!
+ * \brief Options de la ligne de commande.
+ */
+typedef struct options {
+  moteur moteur;
+  unsigned long long iterations; /* nombre d'itérations à simuler */
+  bool histogramme; /* afficher les statistiques au lieu de la colonie */
+  bool stats;       /* statistiques calculées sans matérialiser la colonie */
+  unsigned long long modulo; /* modulo des statistiques, 0 pour 2^64 */
+  unsigned int threads;      /* nombre de threads du moteur liste */
+  char const *sortie;        /* fichier où écrire la colonie */
+  flux_format format;        /* format du fichier de sortie */
+  char const *sauvegarde;    /* fichier des points de reprise */
+  unsigned long long intervalle; /* itérations entre deux points, 0 sinon */
+  bool reprendre;            /* repartir du dernier point de reprise */
+  char const *balayage;      /* fichier de configurations, NULL sinon */
+  algue_verification verification; /* vérification des itérations */
+  unsigned long long echantillon;  /* algues vérifiées par échantillonnage */
+  char const *metriques;     /* fichier des métriques, NULL sinon */
+  metriques_format format_metriques; /* format du fichier des métriques */
+  bool position;             /* afficher une seule algue de la colonie */
+  unsigned long long indice; /* position de l'algue à afficher */
+  char const *trace;         /* fichier de trace des listes, NULL sinon */
+  char const *externe;       /* répertoire de la colonie externe, NULL sinon */
+  unsigned long long budget; /* mémoire de la colonie externe en Ko */
+} options;
+
+/*!
+ * \brief Affiche l'utilisation du programme.
+ * \param nom nom du programme.
+ */
+static void usage(char const *nom) {
+  fprintf(stderr,
+          "usage : %s [--moteur liste|soa|swar|paresseux|dag]\n"
+          "        [--iterations N]"
+          " [--histogramme] [--threads N] [--sortie FICHIER]\n"
+          "        [--algue I]\n"
+          "        [--format texte|binaire|rle]\n"
+          "        [--sauvegarde FICHIER] [--intervalle N] [--reprendre]\n"
+          "        [--verification aucune|echantillon|incrementale|complete]\n"
+          "        [--echantillon K] [--metriques FICHIER]\n"
+          "        [--format-metriques csv|json] [--trace FICHIER]\n"
+          "        [--externe REPERTOIRE] [--budget KO]\n",
+          nom);
+  fprintf(stderr, "        %s --stats N [--modulo M]\n", nom);
+  fprintf(stderr, "        %s --balayage FICHIER [--threads N]\n", nom);
+}
+
+/*!
+ * \brief Lecture d'un entier positif en argument.
+ * \param texte argument à lire.
+ * \param n entier lu.
+ * \return true ssi l'argument est un entier positif valide.
+ */
+static bool lire_entier(char const *texte, unsigned long long *n) {
+  char *fin;
+  if (texte == NULL || *texte == '-') {
+    return false;
+  }
+  *n = strtoull(texte, &fin, 10);
+  return *fin == '\0' && fin != texte;
+}
+
+/*!
+ * \brief Lecture des options de la ligne de commande.
+ * \param argc nombre d'arguments.
+ * \param argv arguments.
+ * \param o options à remplir.
+ * \return true ssi les options sont valides.
+ */
+static bool lire_options(int argc, char *argv[], options *o) {
+  o->moteur = MOTEUR_LISTE;
+  o->iterations = NBITER;
+  o->histogramme = false;
+  o->stats = false;
+  o->modulo = 0;
+  o->threads = 1;
+  o->sortie = "algues_out.txt";
+  o->format = FORMAT_TEXTE;
+  o->sauvegarde = "algues_reprise.bin";
+  o->intervalle = 0;
+  o->reprendre = false;
+  o->balayage = NULL;
+  o->metriques = NULL;
+  o->format_metriques = METRIQUES_CSV;
+  o->verification = VERIFICATION_DEFAUT;
+  o->echantillon = ECHANTILLON_DEFAUT;
+  o->position = false;
+  o->trace = NULL;
+  o->externe = NULL;
+  o->budget = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--moteur") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "liste") == 0) {
+        o->moteur = MOTEUR_LISTE;
+      } else if (strcmp(argv[i], "soa") == 0) {
+        o->moteur = MOTEUR_SOA;
+      } else if (strcmp(argv[i], "swar") == 0) {
+        o->moteur = MOTEUR_SWAR;
+      } else if (strcmp(argv[i], "paresseux") == 0) {
+        o->moteur = MOTEUR_PARESSEUX;
+      } else if (strcmp(argv[i], "dag") == 0) {
+        o->moteur = MOTEUR_DAG;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      if (!lire_entier(argv[++i], &o->iterations)) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      unsigned long long n;
+      if (!lire_entier(argv[++i], &n) || n == 0 || n > 1024) {
+        return false;
+      }
+      o->threads = (unsigned int)n;
+    } else if (strcmp(argv[i], "--sortie") == 0 && i + 1 < argc) {
+      o->sortie = argv[++i];
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "texte") == 0) {
+        o->format = FORMAT_TEXTE;
+      } else if (strcmp(argv[i], "binaire") == 0) {
+        o->format = FORMAT_BINAIRE;
+      } else if (strcmp(argv[i], "rle") == 0) {
+        o->format = FORMAT_RLE;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--sauvegarde") == 0 && i + 1 < argc) {
+      o->sauvegarde = argv[++i];
+    } else if (strcmp(argv[i], "--intervalle") == 0 && i + 1 < argc) {
+      if (!lire_entier(argv[++i], &o->intervalle)) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--reprendre") == 0) {
+      o->reprendre = true;
+    } else if (strcmp(argv[i], "--balayage") == 0 && i + 1 < argc) {
+      o->balayage = argv[++i];
+    } else if (strcmp(argv[i], "--verification") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "aucune") == 0) {
+        o->verification = VERIFICATION_AUCUNE;
+      } else if (strcmp(argv[i], "echantillon") == 0) {
+        o->verification = VERIFICATION_ECHANTILLON;
+      } else if (strcmp(argv[i], "incrementale") == 0) {
+        o->verification = VERIFICATION_INCREMENTALE;
+      } else if (strcmp(argv[i], "complete") == 0) {
+        o->verification = VERIFICATION_COMPLETE;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--echantillon") == 0 && i + 1 < argc) {
+      if (!lire_entier(argv[++i], &o->echantillon) ||
+          o->echantillon > UINT_MAX) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--metriques") == 0 && i + 1 < argc) {
+      o->metriques = argv[++i];
+    } else if (strcmp(argv[i], "--format-metriques") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "csv") == 0) {
+        o->format_metriques = METRIQUES_CSV;
+      } else if (strcmp(argv[i], "json") == 0) {
+        o->format_metriques = METRIQUES_JSON;
+      } else {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      o->trace = argv[++i];
+    } else if (strcmp(argv[i], "--externe") == 0 && i + 1 < argc) {
+      o->externe = argv[++i];
+    } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+      if (!lire_entier(argv[++i], &o->budget) || o->budget == 0 ||
+          o->budget > SIZE_MAX / 1024) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--algue") == 0 && i + 1 < argc) {
+      o->position = true;
+      if (!lire_entier(argv[++i], &o->indice)) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--histogramme") == 0) {
+      o->histogramme = true;
+    } else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+      o->stats = true;
+      if (!lire_entier(argv[++i], &o->iterations)) {
+        return false;
+      }
+    } else if (strcmp(argv[i], "--modulo") == 0 && i + 1 < argc) {
+      if (!lire_entier(argv[++i], &o->modulo) || o->modulo == 0 ||
+          o->modulo > (1ULL << 32)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  if (o->position && o->moteur != MOTEUR_DAG) {
+    return false;
+  }
+  if ((o->reprendre || o->intervalle > 0 || o->metriques != NULL ||
+       o->trace != NULL || o->externe != NULL) &&
+      o->moteur != MOTEUR_LISTE) {
+    return false;
+  }
+  // Une colonie externe n'est ni découpée entre threads ni relue d'un point
+  // de reprise.
+  if (o->externe != NULL && (o->threads > 1 || o->reprendre)) {
+    return false;
+  }
+  // Les métriques sont relevées à chaque itération, par le seul thread
+  // courant : les segments parallèles ne sont pas synchronisés entre deux
+  // itérations.
+  if (o->metriques != NULL && o->threads > 1) {
+    return false;
+  }
+  return o->modulo == 0 || o->stats;
+}
+
+/*!
+ * \brief Ouvre le fichier de sortie et son flux.
+ * \param o options de la simulation.
+ * \param f_out fichier ouvert.
+ * \return le flux d'écriture, ou NULL si le fichier n'a pas pu être ouvert.
+ */
+static flux_algues ouvrir_sortie(options const *o, FILE **f_out) {
+  *f_out = fopen(o->sortie, o->format == FORMAT_TEXTE ? "w" : "wb");
+  if (*f_out == NULL) {
+    perror(o->sortie);
+    return NULL;
+  }
+  return flux_algues_creer(*f_out, o->format);
+}
+
+/*!
+ * \brief Ferme le flux et le fichier de sortie.
+ * \param fx flux à détruire.
+ * \param f_out fichier à fermer.
+ */
+static void fermer_sortie(flux_algues *fx, FILE *f_out) {
+  flux_algues_detruire(fx);
+  fclose(f_out);
+}
+
+/*!
+ * \brief Écrit une colonie en liste dans le flux, en la parcourant.
+ * \param fx flux où écrire.
+ * \param l colonie à écrire.
+ * \param initiale vrai pour la colonie initiale.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ */
+static void ecrire_liste(flux_algues fx, liste l, bool initiale,
+                         unsigned long long iterations) {
+  flux_algues_debut(fx, initiale, iterations, liste_taille_etendue(l));
+  liste_courant_init(l);
+  for (size_t i = 0; i < liste_taille_etendue(l); i++) {
+    algue const *a = liste_valeur_courant(l);
+    flux_algues_ecrire(fx, a->taille, a->orientation);
+    liste_courant_suivant(l);
+  }
+  flux_algues_fin(fx);
+}
+
+/*!
+ * \brief Écrit une colonie en tableaux parallèles dans le flux.
+ * \param fx flux où écrire.
+ * \param c colonie à écrire.
+ * \param initiale vrai pour la colonie initiale.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ */
+static void ecrire_soa(flux_algues fx, colonie_soa c, bool initiale,
+                       unsigned long long iterations) {
+  flux_algues_debut(fx, initiale, iterations, colonie_soa_taille(c));
+  for (size_t i = 0; i < colonie_soa_taille(c); i++) {
+    algue a = colonie_soa_valeur(c, i);
+    flux_algues_ecrire(fx, a.taille, a.orientation);
+  }
+  flux_algues_fin(fx);
+}
+
+/*!
+ * \brief Écrit une colonie codée sur 4 bits dans le flux.
+ * \param fx flux où écrire.
+ * \param c colonie à écrire.
+ * \param initiale vrai pour la colonie initiale.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ */
+static void ecrire_swar(flux_algues fx, colonie_swar c, bool initiale,
+                       unsigned long long iterations) {
+  flux_algues_debut(fx, initiale, iterations, colonie_swar_taille(c));
+  for (size_t i = 0; i < colonie_swar_taille(c); i++) {
+    algue a = colonie_swar_valeur(c, i);
+    flux_algues_ecrire(fx, a.taille, a.orientation);
+  }
+  flux_algues_fin(fx);
+}
+
+/*!
+ * \brief Écrit une colonie pilotée par les divisions dans le flux, en la
+ * parcourant.
+ * \param fx flux où écrire.
+ * \param c colonie à écrire.
+ * \param initiale vrai pour la colonie initiale.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ */
+static void ecrire_paresseux(flux_algues fx, colonie_paresseuse c,
+                             bool initiale, unsigned long long iterations) {
+  colonie_paresseuse_parcours p = colonie_paresseuse_parcours_creer(c);
+  algue a;
+  flux_algues_debut(fx, initiale, iterations, colonie_paresseuse_taille(c));
+  while (colonie_paresseuse_parcours_suivant(p, &a)) {
+    flux_algues_ecrire(fx, a.taille, a.orientation);
+  }
+  flux_algues_fin(fx);
+  colonie_paresseuse_parcours_detruire(&p);
+}
+
+/*!
+ * \brief Écrit une colonie partagée dans le flux, en la parcourant.
+ * \param fx flux où écrire.
+ * \param d colonie à écrire.
+ * \param initiale vrai pour la colonie initiale.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ */
+static void ecrire_dag(flux_algues fx, colonie_dag d, bool initiale,
+                       unsigned long long iterations) {
+  colonie_dag_parcours p = colonie_dag_parcours_creer(d);
+  algue a;
+  flux_algues_debut(fx, initiale, iterations, colonie_dag_taille(d));
+  while (colonie_dag_parcours_suivant(p, &a)) {
+    flux_algues_ecrire(fx, a.taille, a.orientation);
+  }
+  flux_algues_fin(fx);
+  colonie_dag_parcours_detruire(&p);
+}
+
+/*!
+ * \brief Simulation avec le moteur liste. La colonie initiale et la colonie
+ * résultat sont écrites dans le fichier de sortie, ou les statistiques de la
+ * colonie résultat sur la sortie standard.
+ * \param o options de la simulation.
+ */
+static int simulation_liste(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  unsigned long long faites = 0;
+  liste l = o->externe != NULL
+                ? algue_liste_init_externe(o->externe,
+                                           (size_t)o->budget * 1024)
+                : algue_liste_init(&copier_algue, &afficher_algue,
+                                   &detruire_algue);
+  if (l == NULL) {
+    perror(o->externe);
+    return EXIT_FAILURE;
+  }
+  FILE *f_out = NULL;
+  flux_algues fx = NULL;
+  if (!o->histogramme) {
+    fx = ouvrir_sortie(o, &f_out);
+    if (fx == NULL) {
+      liste_detruire(&l);
+      return EXIT_FAILURE;
+    }
+    ecrire_liste(fx, l, true, 0);
+  }
+  FILE *f_metriques = NULL;
+  if (o->metriques != NULL) {
+    f_metriques = fopen(o->metriques, "w");
+    if (f_metriques == NULL) {
+      perror(o->metriques);
+      liste_detruire(&l);
+      if (fx != NULL) {
+        fermer_sortie(&fx, f_out);
+      }
+      return EXIT_FAILURE;
+    }
+    metriques_entete(f_metriques, o->format_metriques);
+  }
+  if (o->reprendre) {
+    // La colonie initiale est toujours la même : seule la colonie courante
+    // est reprise du fichier.
+    algue_regle lue;
+    liste_detruire(&l);
+    l = reprise_lire(o->sauvegarde, &lue, &faites);
+    if (l == NULL || memcmp(&lue, &r, sizeof(r)) != 0 ||
+        faites > o->iterations) {
+      fprintf(stderr, "point de reprise inutilisable : %s\n", o->sauvegarde);
+      if (l != NULL) {
+        liste_detruire(&l);
+      }
+      if (fx != NULL) {
+        fermer_sortie(&fx, f_out);
+      }
+      if (f_metriques != NULL) {
+        fclose(f_metriques);
+      }
+      return EXIT_FAILURE;
+    }
+  }
+  while (faites < o->iterations) {
+    unsigned long long n = o->iterations - faites;
+    if (o->intervalle > 0 && n > o->intervalle) {
+      n = o->intervalle;
+    }
+    // Avec les métriques, il n'y a qu'un thread (cf. lire_options).
+    if (f_metriques != NULL) {
+      metriques_iterations(l, n, faites, f_metriques, o->format_metriques);
+    } else {
+      algue_iterations_parallele(l, n, o->threads);
+    }
+    faites += n;
+    if (o->intervalle > 0 && !reprise_ecrire(o->sauvegarde, &r, faites, l)) {
+      perror(o->sauvegarde);
+    }
+  }
+  if (f_metriques != NULL) {
+    fclose(f_metriques);
+  }
+  if (o->histogramme) {
+    algue_stats s;
+    algue_stats_liste(&r, l, o->iterations, &s);
+    algue_stats_afficher(stdout, &r, &s);
+  } else {
+    ecrire_liste(fx, l, false, o->iterations);
+    fermer_sortie(&fx, f_out);
+  }
+  liste_detruire(&l);
+  return 0;
+}
+
+/*!
+ * \brief Simulation avec le moteur par tableaux parallèles, avec les mêmes
+ * sorties que simulation_liste.
+ * \param o options de la simulation.
+ */
+static int simulation_soa(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  colonie_soa c = colonie_soa_creer(&r);
+  FILE *f_out = NULL;
+  flux_algues fx = NULL;
+  if (!o->histogramme) {
+    fx = ouvrir_sortie(o, &f_out);
+    if (fx == NULL) {
+      colonie_soa_detruire(&c);
+      return EXIT_FAILURE;
+    }
+    ecrire_soa(fx, c, true, 0);
+  }
+  for (unsigned long long i = 0; i < o->iterations; i++)
+    colonie_soa_iteration(c);
+  if (o->histogramme) {
+    algue_stats s;
+    colonie_soa_stats(c, o->iterations, &s);
+    algue_stats_afficher(stdout, &r, &s);
+  } else {
+    ecrire_soa(fx, c, false, o->iterations);
+    fermer_sortie(&fx, f_out);
+  }
+  colonie_soa_detruire(&c);
+  return 0;
+}
+
+/*!
+ * \brief Simulation avec le moteur sur des mots de 64 bits, avec les mêmes
+ * sorties que simulation_liste.
+ * \param o options de la simulation.
+ */
+static int simulation_swar(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  colonie_swar c = colonie_swar_creer(&r);
+  FILE *f_out = NULL;
+  flux_algues fx = NULL;
+  if (!o->histogramme) {
+    fx = ouvrir_sortie(o, &f_out);
+    if (fx == NULL) {
+      colonie_swar_detruire(&c);
+      return EXIT_FAILURE;
+    }
+    ecrire_swar(fx, c, true, 0);
+  }
+  for (unsigned long long i = 0; i < o->iterations; i++)
+    colonie_swar_iteration(c);
+  if (o->histogramme) {
+    algue_stats s;
+    colonie_swar_stats(c, o->iterations, &s);
+    algue_stats_afficher(stdout, &r, &s);
+  } else {
+    ecrire_swar(fx, c, false, o->iterations);
+    fermer_sortie(&fx, f_out);
+  }
+  colonie_swar_detruire(&c);
+  return 0;
+}
+
+/*!
+ * \brief Simulation avec le moteur piloté par les divisions, avec les mêmes
+ * sorties que simulation_liste.
+ * \param o options de la simulation.
+ */
+static int simulation_paresseux(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  colonie_paresseuse c = colonie_paresseuse_creer(&r);
+  FILE *f_out = NULL;
+  flux_algues fx = NULL;
+  if (!o->histogramme) {
+    fx = ouvrir_sortie(o, &f_out);
+    if (fx == NULL) {
+      colonie_paresseuse_detruire(&c);
+      return EXIT_FAILURE;
+    }
+    ecrire_paresseux(fx, c, true, 0);
+  }
+  for (unsigned long long i = 0; i < o->iterations; i++)
+    colonie_paresseuse_iteration(c);
+  if (o->histogramme) {
+    algue_stats s;
+    colonie_paresseuse_stats(c, o->iterations, &s);
+    algue_stats_afficher(stdout, &r, &s);
+  } else {
+    ecrire_paresseux(fx, c, false, o->iterations);
+    fermer_sortie(&fx, f_out);
+  }
+  colonie_paresseuse_detruire(&c);
+  return 0;
+}
+
+/*!
+ * \brief Simulation avec la représentation partagée, avec les mêmes sorties
+ * que simulation_liste. Elle permet aussi d'afficher une seule algue d'une
+ * colonie trop grande pour être parcourue.
+ * \param o options de la simulation.
+ */
+static int simulation_dag(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  if (o->iterations > UINT_MAX) {
+    fprintf(stderr, "trop d'itérations : %llu\n", o->iterations);
+    return EXIT_FAILURE;
+  }
+  colonie_dag d = colonie_dag_creer(&r, (unsigned int)o->iterations);
+  if (o->position) {
+    if (o->indice >= colonie_dag_taille(d)) {
+      fprintf(stderr, "position hors de la colonie : %llu\n", o->indice);
+      colonie_dag_detruire(&d);
+      return EXIT_FAILURE;
+    }
+    algue a = colonie_dag_valeur(d, o->indice);
+    printf("algue %llu : (%d,%d)\n", o->indice, a.taille, a.orientation);
+  } else if (o->histogramme) {
+    algue_stats s;
+    colonie_dag_stats(d, &s);
+    algue_stats_afficher(stdout, &r, &s);
+  } else {
+    FILE *f_out;
+    flux_algues fx = ouvrir_sortie(o, &f_out);
+    if (fx == NULL) {
+      colonie_dag_detruire(&d);
+      return EXIT_FAILURE;
+    }
+    colonie_dag initiale = colonie_dag_creer(&r, 0);
+    ecrire_dag(fx, initiale, true, 0);
+    ecrire_dag(fx, d, false, o->iterations);
+    fermer_sortie(&fx, f_out);
+    colonie_dag_detruire(&initiale);
+  }
+  colonie_dag_detruire(&d);
+  return 0;
+}
+
+/*!
+ * \brief Statistiques calculées sans matérialiser la colonie.
+ * \param o options du calcul.
+ */
+static int statistiques(options const *o) {
+  algue_regle const r = REGLE_DEFAUT;
+  algue_stats s;
+  algue_stats_calculer(&r, o->iterations, o->modulo, &s);
+  algue_stats_afficher(stdout, &r, &s);
+  return 0;
+}
+
+/*!
+ * \brief Simulation de toutes les configurations d'un fichier de balayage,
+ * avec une ligne de résultat par configuration sur la sortie standard.
+ * \param o options du balayage.
+ */
+static int balayage_parametres(options const *o) {
+  FILE *f = fopen(o->balayage, "r");
+  if (f == NULL) {
+    perror(o->balayage);
+    return EXIT_FAILURE;
+  }
+  balayage_config *configs;
+  size_t n;
+  bool valide = balayage_lire(f, &configs, &n);
+  fclose(f);
+  if (!valide) {
+    fprintf(stderr, "%s : configuration invalide ligne %zu\n", o->balayage,
+            n);
+    return EXIT_FAILURE;
+  }
+  balayage_resultat *resultats = malloc((n + 1) * sizeof(balayage_resultat));
+  balayage_executer(configs, n, o->threads, resultats);
+  for (size_t i = 0; i < n; i++) {
+    balayage_afficher(stdout, &configs[i], &resultats[i]);
+  }
+  free(resultats);
+  free(configs);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  options o;
+  if (!lire_options(argc, argv, &o)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (!algue_verification_choisir(o.verification,
+                                  (unsigned int)o.echantillon)) {
+    fprintf(stderr, "niveau de vérification figé à la compilation\n");
+  }
+  if (o.stats) {
+    return statistiques(&o);
+  }
+  if (o.balayage != NULL) {
+    return balayage_parametres(&o);
+  }
+  switch (o.moteur) {
+  case MOTEUR_SOA:
+    return simulation_soa(&o);
+  case MOTEUR_SWAR:
+    return simulation_swar(&o);
+  case MOTEUR_PARESSEUX:
+    return simulation_paresseux(&o);
+  case MOTEUR_DAG:
+    return simulation_dag(&o);
+  case MOTEUR_LISTE:
+  default:
+    if (o.trace != NULL) {
+      if (!listes_trace_demarrer(o.trace)) {
+        perror(o.trace);
+        return EXIT_FAILURE;
+      }
+      int code = simulation_liste(&o);
+      if (!listes_trace_arreter()) {
+        perror(o.trace);
+        return EXIT_FAILURE;
+      }
+      return code;
+    }
+    return simulation_liste(&o);
+  }
+}
@@ -0,0 +1,68 @@
+#define _POSIX_C_SOURCE 200809L
+#include "algues_metriques.h"
+#include <assert.h>
+#include <time.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+void metriques_entete(FILE *f, metriques_format format) {
+  assert(f != NULL);
+  if (format == METRIQUES_CSV) {
+    fprintf(f, "iteration,population,divisions");
+    for (int taille = TMIN; taille <= TMAX; taille++) {
+      fprintf(f, ",%d:%d,%d:%d", taille, GAUCHE, taille, DROITE);
+    }
+    fprintf(f, ",allocations,temps\n");
+  }
+}
+
+void metriques_ecrire(FILE *f, metriques_format format,
+                      algue_metriques const *m) {
+  assert(f != NULL && m != NULL);
+  // L'histogramme est rangé par taille puis orientation, GAUCHE d'abord :
+  // l'indice i correspond à la taille TMIN + i / 2.
+  if (format == METRIQUES_CSV) {
+    fprintf(f, "%llu,%llu,%llu", m->iteration, m->population,
+            m->compteurs.divisions);
+    for (unsigned int i = 0; i < NB_ETATS; i++) {
+      fprintf(f, ",%llu", m->compteurs.histogramme[i]);
+    }
+    fprintf(f, ",%llu,%.9f\n", m->allocations, m->secondes);
+  } else {
+    fprintf(f,
+            "{\"iteration\":%llu,\"population\":%llu,\"divisions\":%llu,"
+            "\"histogramme\":{",
+            m->iteration, m->population, m->compteurs.divisions);
+    for (unsigned int i = 0; i < NB_ETATS; i++) {
+      fprintf(f, "%s\"%d:%d\":%llu", i == 0 ? "" : ",", TMIN + (int)i / 2,
+              i % 2 ? DROITE : GAUCHE, m->compteurs.histogramme[i]);
+    }
+    fprintf(f, "},\"allocations\":%llu,\"temps\":%.9f}\n", m->allocations,
+            m->secondes);
+  }
+}
+
+void metriques_iterations(liste l, unsigned long long n,
+                          unsigned long long deja, FILE *f,
+                          metriques_format format) {
+  assert(l != NULL && f != NULL);
+  algue_metriques m;
+  for (unsigned long long i = 1; i <= n; i++) {
+    struct timespec debut, fin;
+    unsigned long long allocations = liste_nb_allocations(l);
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    algue_iteration_compter(l, &m.compteurs);
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    m.iteration = deja + i;
+    m.population = liste_taille_etendue(l);
+    m.allocations = liste_nb_allocations(l) - allocations;
+    m.secondes = (double)(fin.tv_sec - debut.tv_sec) +
+                 (double)(fin.tv_nsec - debut.tv_nsec) * 1e-9;
+    metriques_ecrire(f, format, &m);
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef ALGUES_METRIQUES
+#define ALGUES_METRIQUES
+#include "algues.h"
+#include <stdio.h>
+
+/*! \file
+ * \brief Flux de métriques par itération d'une simulation d'algues.
+ *
+ * Chaque itération produit un enregistrement : numéro d'itération,
+ * population, nombre de divisions, histogramme des états (taille,
+ * orientation), nombre d'allocations de la liste pendant l'itération et
+ * durée en secondes. Deux formats sont proposés :
+ * - csv : une ligne d'en-tête puis une ligne par itération, les colonnes de
+ *   l'histogramme étant nommées "taille:orientation" ;
+ * - json : un objet JSON par ligne, l'histogramme étant un objet dont les
+ *   clés sont "taille:orientation".
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Formats du flux de métriques.
+ */
+typedef enum metriques_format { METRIQUES_CSV, METRIQUES_JSON } metriques_format;
+
+/*!
+ * \brief Métriques d'une itération.
+ */
+typedef struct algue_metriques {
+  unsigned long long iteration;   /* numéro de l'itération, à partir de 1 */
+  unsigned long long population;  /* algues après l'itération */
+  algue_compteurs compteurs;      /* divisions et histogramme */
+  unsigned long long allocations; /* allocations pendant l'itération */
+  double secondes;                /* durée de l'itération */
+} algue_metriques;
+
+/*!
+ * \brief Écrit l'en-tête du flux, s'il y en a un dans ce format.
+ * \param f flux où écrire.
+ * \param format format du flux.
+ */
+void metriques_entete(FILE *f, metriques_format format);
+
+/*!
+ * \brief Écrit l'enregistrement d'une itération.
+ * \param f flux où écrire.
+ * \param format format du flux.
+ * \param m métriques de l'itération.
+ */
+void metriques_ecrire(FILE *f, metriques_format format,
+                      algue_metriques const *m);
+
+/*!
+ * \brief Fait évoluer la colonie de n itérations en écrivant les métriques de
+ * chacune.
+ * \param l colonie à faire évoluer.
+ * \param n nombre d'itérations.
+ * \param deja nombre d'itérations déjà faites, pour numéroter les suivantes.
+ * \param f flux où écrire.
+ * \param format format du flux.
+ */
+void metriques_iterations(liste l, unsigned long long n,
+                          unsigned long long deja, FILE *f,
+                          metriques_format format);
+
+#endif
@@ -0,0 +1,209 @@
+#include "algues_moteurs.h"
+#include "algues_dag.h"
+#include "algues_paresseux.h"
+#include "algues_soa.h"
+#include "algues_swar.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/* Moteur liste : la colonie est une liste générique d'algues. */
+static void *liste_creer_moteur(algue_regle const *r) {
+  algue_regle const defaut = REGLE_DEFAUT;
+  assert(memcmp(r, &defaut, sizeof(defaut)) == 0);
+  (void)r;
+  (void)defaut;
+  return algue_liste_init(&copier_algue, &afficher_algue, &detruire_algue);
+}
+
+/* Moteur externe : la même liste, dont les segments débordent dans un fichier
+   au-delà du budget par défaut. */
+static void *externe_creer_moteur(algue_regle const *r) {
+  algue_regle const defaut = REGLE_DEFAUT;
+  assert(memcmp(r, &defaut, sizeof(defaut)) == 0);
+  (void)r;
+  (void)defaut;
+  liste l = algue_liste_init_externe(NULL, 0);
+  assert(l != NULL);
+  return l;
+}
+
+static void liste_detruire_moteur(void **colonie) {
+  liste l = *colonie;
+  liste_detruire(&l);
+  *colonie = NULL;
+}
+
+static void liste_iteration_moteur(void *colonie) { algue_iteration(colonie); }
+
+static unsigned long long liste_taille_moteur(void *colonie) {
+  return liste_taille_etendue(colonie);
+}
+
+static void liste_parcourir(void *colonie,
+                            void (*visiter)(algue const *a, void *donnees),
+                            void *donnees) {
+  liste l = colonie;
+  liste_courant_init(l);
+  for (size_t i = 0; i < liste_taille_etendue(l); i++) {
+    visiter(liste_valeur_courant(l), donnees);
+    liste_courant_suivant(l);
+  }
+}
+
+/* Moteur par tableaux parallèles. */
+static void *soa_creer(algue_regle const *r) { return colonie_soa_creer(r); }
+
+static void soa_detruire(void **colonie) {
+  colonie_soa c = *colonie;
+  colonie_soa_detruire(&c);
+  *colonie = NULL;
+}
+
+static void soa_iteration(void *colonie) { colonie_soa_iteration(colonie); }
+
+static unsigned long long soa_taille(void *colonie) {
+  return colonie_soa_taille(colonie);
+}
+
+static void soa_parcourir(void *colonie,
+                          void (*visiter)(algue const *a, void *donnees),
+                          void *donnees) {
+  for (size_t i = 0; i < colonie_soa_taille(colonie); i++) {
+    algue a = colonie_soa_valeur(colonie, i);
+    visiter(&a, donnees);
+  }
+}
+
+/* Moteur sur des mots de 64 bits. */
+static void *swar_creer(algue_regle const *r) { return colonie_swar_creer(r); }
+
+static void swar_detruire(void **colonie) {
+  colonie_swar c = *colonie;
+  colonie_swar_detruire(&c);
+  *colonie = NULL;
+}
+
+static void swar_iteration(void *colonie) { colonie_swar_iteration(colonie); }
+
+static unsigned long long swar_taille(void *colonie) {
+  return colonie_swar_taille(colonie);
+}
+
+static void swar_parcourir(void *colonie,
+                           void (*visiter)(algue const *a, void *donnees),
+                           void *donnees) {
+  for (size_t i = 0; i < colonie_swar_taille(colonie); i++) {
+    algue a = colonie_swar_valeur(colonie, i);
+    visiter(&a, donnees);
+  }
+}
+
+/* Moteur piloté par les divisions. */
+static void *paresseux_creer(algue_regle const *r) {
+  return colonie_paresseuse_creer(r);
+}
+
+static void paresseux_detruire(void **colonie) {
+  colonie_paresseuse c = *colonie;
+  colonie_paresseuse_detruire(&c);
+  *colonie = NULL;
+}
+
+static void paresseux_iteration(void *colonie) {
+  colonie_paresseuse_iteration(colonie);
+}
+
+static unsigned long long paresseux_taille(void *colonie) {
+  return colonie_paresseuse_taille(colonie);
+}
+
+static void paresseux_parcourir(void *colonie,
+                                void (*visiter)(algue const *a, void *donnees),
+                                void *donnees) {
+  colonie_paresseuse_parcours p = colonie_paresseuse_parcours_creer(colonie);
+  algue a;
+  while (colonie_paresseuse_parcours_suivant(p, &a)) {
+    visiter(&a, donnees);
+  }
+  colonie_paresseuse_parcours_detruire(&p);
+}
+
+/*!
+ * \brief La représentation partagée est construite pour un nombre
+ * d'itérations donné : une itération reconstruit la génération suivante, ce
+ * qui ne coûte que le nombre d'itérations fois le nombre d'états.
+ */
+typedef struct dag_moteur {
+  algue_regle regle;
+  unsigned int iterations;
+  colonie_dag d;
+} dag_moteur;
+
+static void *dag_creer(algue_regle const *r) {
+  dag_moteur *m = malloc(sizeof(dag_moteur));
+  m->regle = *r;
+  m->iterations = 0;
+  m->d = colonie_dag_creer(r, 0);
+  return m;
+}
+
+static void dag_detruire(void **colonie) {
+  dag_moteur *m = *colonie;
+  colonie_dag_detruire(&m->d);
+  free(m);
+  *colonie = NULL;
+}
+
+static void dag_iteration(void *colonie) {
+  dag_moteur *m = colonie;
+  colonie_dag_detruire(&m->d);
+  m->d = colonie_dag_creer(&m->regle, ++m->iterations);
+}
+
+static unsigned long long dag_taille(void *colonie) {
+  return colonie_dag_taille(((dag_moteur *)colonie)->d);
+}
+
+static void dag_parcourir(void *colonie,
+                          void (*visiter)(algue const *a, void *donnees),
+                          void *donnees) {
+  colonie_dag_parcours p =
+      colonie_dag_parcours_creer(((dag_moteur *)colonie)->d);
+  algue a;
+  while (colonie_dag_parcours_suivant(p, &a)) {
+    visiter(&a, donnees);
+  }
+  colonie_dag_parcours_detruire(&p);
+}
+
+moteur_algues const moteurs_algues[NB_MOTEURS_ALGUES] = {
+    {"liste", 64, &liste_creer_moteur, &liste_detruire_moteur,
+     &liste_iteration_moteur, &liste_taille_moteur, &liste_parcourir},
+    {"soa", 8, &soa_creer, &soa_detruire, &soa_iteration, &soa_taille,
+     &soa_parcourir},
+    {"swar", 2, &swar_creer, &swar_detruire, &swar_iteration, &swar_taille,
+     &swar_parcourir},
+    {"paresseux", 24, &paresseux_creer, &paresseux_detruire,
+     &paresseux_iteration, &paresseux_taille, &paresseux_parcourir},
+    {"dag", 0, &dag_creer, &dag_detruire, &dag_iteration, &dag_taille,
+     &dag_parcourir},
+    {"externe", 0, &externe_creer_moteur, &liste_detruire_moteur,
+     &liste_iteration_moteur, &liste_taille_moteur, &liste_parcourir}};
+
+moteur_algues const *moteur_algues_chercher(char const *nom) {
+  assert(nom != NULL);
+  for (unsigned int i = 0; i < NB_MOTEURS_ALGUES; i++) {
+    if (strcmp(moteurs_algues[i].nom, nom) == 0) {
+      return &moteurs_algues[i];
+    }
+  }
+  return NULL;
+}
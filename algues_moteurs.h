@@ -0,0 +1,53 @@
+#ifndef ALGUES_MOTEURS
+#define ALGUES_MOTEURS
+#include "algues.h"
+#include <stddef.h>
+
+/*! \file
+ * \brief Interface commune des moteurs de simulation des algues.
+ *
+ * Chaque moteur (liste, soa, swar, paresseux, dag, externe) est décrit par
+ * une table de fonctions qui manipulent sa colonie à travers un pointeur
+ * générique : un même programme peut ainsi faire évoluer et parcourir
+ * n'importe quel moteur, par exemple pour les comparer.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Table des fonctions d'un moteur.
+ */
+typedef struct moteur_algues {
+  char const *nom;
+  size_t octets_par_algue; /* mémoire approximative par algue, tampons
+                              compris */
+  /*! création d'une colonie d'une algue ; le moteur liste n'accepte que la
+   * règle par défaut */
+  void *(*creer)(algue_regle const *r);
+  /*! destruction de la colonie */
+  void (*detruire)(void **colonie);
+  /*! une itération */
+  void (*iteration)(void *colonie);
+  /*! nombre d'algues */
+  unsigned long long (*taille)(void *colonie);
+  /*! appelle visiter sur chaque algue, dans l'ordre */
+  void (*parcourir)(void *colonie,
+                    void (*visiter)(algue const *a, void *donnees),
+                    void *donnees);
+} moteur_algues;
+
+/*! \brief Nombre de moteurs disponibles. */
+#define NB_MOTEURS_ALGUES 6
+
+/*! \brief Les moteurs disponibles, le moteur liste en premier. */
+extern moteur_algues const moteurs_algues[NB_MOTEURS_ALGUES];
+
+/*!
+ * \brief Recherche un moteur par son nom.
+ * \param nom nom du moteur.
+ * \return le moteur, ou NULL s'il n'existe pas.
+ */
+moteur_algues const *moteur_algues_chercher(char const *nom);
+
+#endif
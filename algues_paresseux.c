@@ -0,0 +1,197 @@
+#include "algues_paresseux.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Indice de fin du chaînage des algues. */
+#define FIN UINT32_MAX
+
+/*!
+ * \brief Algue enregistrée par sa naissance. Sa taille à l'itération k est
+ * taille + (k - naissance).
+ */
+typedef struct noeud {
+  uint32_t naissance;
+  uint32_t suivant; /* indice de l'algue suivante, FIN pour la dernière */
+  int8_t taille;
+  int8_t orientation;
+} noeud;
+
+/*!
+ * \brief Case de l'échéancier : indices des algues qui se divisent à une même
+ * itération.
+ */
+typedef struct case_echeancier {
+  uint32_t *algues;
+  size_t nombre;
+  size_t capacite;
+} case_echeancier;
+
+/*!
+ * \brief La colonie est un tableau de noeuds chaînés à partir de premier ;
+ * la case k % horizon de l'échéancier contient les algues qui se divisent à
+ * l'itération k.
+ */
+struct colonie_paresseuse_struct {
+  algue_regle regle;
+  uint32_t iteration; /* nombre d'itérations faites */
+  noeud *noeuds;
+  size_t taille;
+  size_t capacite;
+  uint32_t premier;
+  case_echeancier *echeancier;
+  unsigned int horizon;
+};
+
+/*!
+ * \brief Un parcours suit le chaînage des noeuds.
+ */
+struct colonie_paresseuse_parcours_struct {
+  colonie_paresseuse c;
+  uint32_t noeud;
+};
+
+/*!
+ * \brief Inscrit une algue née à l'itération courante dans la case de sa
+ * division : elle se divise à l'itération qui suit celle où elle atteint
+ * tmax.
+ * \param c colonie.
+ * \param i indice de l'algue.
+ */
+static void planifier(colonie_paresseuse c, uint32_t i) {
+  uint32_t division = c->noeuds[i].naissance +
+                      (uint32_t)(c->regle.tmax - c->noeuds[i].taille) + 1;
+  case_echeancier *e = &c->echeancier[division % c->horizon];
+  if (e->nombre == e->capacite) {
+    e->capacite = e->capacite == 0 ? 16 : 2 * e->capacite;
+    e->algues = realloc(e->algues, e->capacite * sizeof(uint32_t));
+    assert(e->algues != NULL);
+  }
+  e->algues[e->nombre++] = i;
+}
+
+colonie_paresseuse colonie_paresseuse_creer(algue_regle const *r) {
+  assert(r != NULL);
+  assert(r->tmax <= INT8_MAX);
+  assert(r->t1 <= r->tmax && r->t2 <= r->tmax);
+  colonie_paresseuse c = malloc(sizeof(struct colonie_paresseuse_struct));
+  c->regle = *r;
+  c->iteration = 0;
+  c->capacite = 16;
+  c->noeuds = malloc(c->capacite * sizeof(noeud));
+  c->taille = 1;
+  c->premier = 0;
+  c->noeuds[0].naissance = 0;
+  c->noeuds[0].suivant = FIN;
+  c->noeuds[0].taille = (int8_t)r->t1;
+  c->noeuds[0].orientation = GAUCHE;
+  // Le délai maximal avant une division est tmax - min(t1, t2) + 1 : une case
+  // de plus évite qu'une algue soit inscrite dans la case en cours.
+  c->horizon =
+      (unsigned int)(r->tmax - (r->t1 < r->t2 ? r->t1 : r->t2) + 2);
+  c->echeancier = calloc(c->horizon, sizeof(case_echeancier));
+  planifier(c, 0);
+  return c;
+}
+
+void colonie_paresseuse_detruire(colonie_paresseuse *c) {
+  assert(c != NULL && *c != NULL);
+  for (unsigned int k = 0; k < (*c)->horizon; k++) {
+    free((*c)->echeancier[k].algues);
+  }
+  free((*c)->echeancier);
+  free((*c)->noeuds);
+  free(*c);
+  *c = NULL;
+}
+
+void colonie_paresseuse_iteration(colonie_paresseuse c) {
+  assert(c != NULL);
+  assert(c->iteration < UINT32_MAX);
+  c->iteration++;
+  case_echeancier *e = &c->echeancier[c->iteration % c->horizon];
+  if (c->taille + e->nombre > c->capacite) {
+    while (c->taille + e->nombre > c->capacite) {
+      c->capacite *= 2;
+    }
+    assert(c->capacite <= FIN);
+    c->noeuds = realloc(c->noeuds, c->capacite * sizeof(noeud));
+    assert(c->noeuds != NULL);
+  }
+  // Les algues de la case sont retirées avant d'être replanifiées : leurs
+  // filles ne sont jamais inscrites dans la case courante.
+  size_t nombre = e->nombre;
+  e->nombre = 0;
+  for (size_t k = 0; k < nombre; k++) {
+    uint32_t gauche = e->algues[k];
+    uint32_t droite = (uint32_t)c->taille++;
+    noeud *n = &c->noeuds[gauche];
+    int orientation = n->orientation;
+    // La mère devient l'algue de gauche, celle de droite est chaînée après
+    c->noeuds[droite].naissance = c->iteration;
+    c->noeuds[droite].suivant = n->suivant;
+    c->noeuds[droite].taille =
+        (int8_t)(orientation == GAUCHE ? c->regle.t2 : c->regle.t1);
+    c->noeuds[droite].orientation = DROITE;
+    n->naissance = c->iteration;
+    n->suivant = droite;
+    n->taille = (int8_t)(orientation == GAUCHE ? c->regle.t1 : c->regle.t2);
+    n->orientation = GAUCHE;
+    planifier(c, gauche);
+    planifier(c, droite);
+  }
+}
+
+size_t colonie_paresseuse_taille(colonie_paresseuse c) {
+  assert(c != NULL);
+  return c->taille;
+}
+
+void colonie_paresseuse_stats(colonie_paresseuse c,
+                              unsigned long long iterations, algue_stats *s) {
+  assert(c != NULL && s != NULL);
+  algue_stats_initialiser(&c->regle, iterations, s);
+  // L'ordre des algues n'importe pas : le tableau est lu séquentiellement
+  for (size_t i = 0; i < c->taille; i++) {
+    noeud const *n = &c->noeuds[i];
+    int taille = n->taille + (int)(c->iteration - n->naissance);
+    s->histogramme[algue_etat(&c->regle, taille, n->orientation)]++;
+  }
+  algue_stats_terminer(s);
+}
+
+colonie_paresseuse_parcours
+colonie_paresseuse_parcours_creer(colonie_paresseuse c) {
+  assert(c != NULL);
+  colonie_paresseuse_parcours p =
+      malloc(sizeof(struct colonie_paresseuse_parcours_struct));
+  p->c = c;
+  p->noeud = c->premier;
+  return p;
+}
+
+bool colonie_paresseuse_parcours_suivant(colonie_paresseuse_parcours p,
+                                         algue *a) {
+  assert(p != NULL && a != NULL);
+  if (p->noeud == FIN) {
+    return false;
+  }
+  noeud const *n = &p->c->noeuds[p->noeud];
+  a->taille = n->taille + (int)(p->c->iteration - n->naissance);
+  a->orientation = n->orientation;
+  p->noeud = n->suivant;
+  return true;
+}
+
+void colonie_paresseuse_parcours_detruire(colonie_paresseuse_parcours *p) {
+  assert(p != NULL && *p != NULL);
+  free(*p);
+  *p = NULL;
+}
@@ -0,0 +1,102 @@
+#ifndef ALGUES_PARESSEUX
+#define ALGUES_PARESSEUX
+#include "algues.h"
+#include "algues_stats.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! \file
+ * \brief Moteur de simulation des algues piloté par les divisions.
+ *
+ * Une algue ne grandit que d'une unité par itération jusqu'à sa division :
+ * sa taille se déduit de l'itération courante, de son itération de naissance
+ * et de sa taille de naissance, qui sont seules enregistrées. Aucune algue
+ * n'est donc modifiée par une itération, sauf celles qui se divisent.
+ *
+ * L'itération de division de chaque algue est connue dès sa naissance ; les
+ * algues sont rangées dans un échéancier circulaire, avec une case par
+ * itération sur un horizon de tmax - min(t1, t2) + 2 itérations. Une
+ * itération ne traite que la case courante : son coût est proportionnel au
+ * nombre de divisions, et non à la population.
+ *
+ * Les algues sont chaînées dans l'ordre de algue_iteration ; les deux algues
+ * issues d'une division prennent la place de leur mère.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Colonie d'algues pilotée par les divisions.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_paresseuse_struct *colonie_paresseuse;
+
+/*!
+ * \brief Parcours dans l'ordre d'une colonie pilotée par les divisions.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_paresseuse_parcours_struct *colonie_paresseuse_parcours;
+
+/*!
+ * \brief Création d'une colonie contenant une algue de taille r->t1 orientée
+ * vers la gauche.
+ * \param r règle d'évolution, recopiée dans la colonie.
+ * \return une nouvelle colonie.
+ */
+colonie_paresseuse colonie_paresseuse_creer(algue_regle const *r);
+
+/*!
+ * \brief Destruction de la colonie.
+ * \param c pointeur vers la colonie à détruire.
+ */
+void colonie_paresseuse_detruire(colonie_paresseuse *c);
+
+/*!
+ * \brief Fait évoluer la colonie d'une itération, en ne traitant que les
+ * algues qui se divisent.
+ * \param c colonie à faire évoluer.
+ */
+void colonie_paresseuse_iteration(colonie_paresseuse c);
+
+/*!
+ * \brief Retourne le nombre d'algues de la colonie.
+ * \param c colonie sur laquelle porte la demande.
+ * \return le nombre d'algues.
+ */
+size_t colonie_paresseuse_taille(colonie_paresseuse c);
+
+/*!
+ * \brief Calcule les statistiques de la colonie.
+ * \param c colonie à compter.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param s statistiques à remplir.
+ */
+void colonie_paresseuse_stats(colonie_paresseuse c,
+                              unsigned long long iterations, algue_stats *s);
+
+/*!
+ * \brief Création d'un parcours positionné avant la première algue.
+ * La colonie ne doit pas évoluer ni être détruite avant la fin du parcours.
+ * \param c colonie à parcourir.
+ * \return un nouveau parcours.
+ */
+colonie_paresseuse_parcours
+colonie_paresseuse_parcours_creer(colonie_paresseuse c);
+
+/*!
+ * \brief Passe à l'algue suivante, dont la taille est calculée.
+ * \param p parcours à avancer.
+ * \param a algue lue, si elle existe.
+ * \return false si le parcours est terminé.
+ */
+bool colonie_paresseuse_parcours_suivant(colonie_paresseuse_parcours p,
+                                         algue *a);
+
+/*!
+ * \brief Destruction du parcours.
+ * \param p pointeur vers le parcours à détruire.
+ */
+void colonie_paresseuse_parcours_detruire(colonie_paresseuse_parcours *p);
+
+#endif
@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200809L
+#include "algues_reprise.h"
+#include "algues_flux.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Signature des fichiers de reprise. */
+#define SIGNATURE "ALGREPR"
+/*! \brief Version du format des fichiers de reprise. */
+#define VERSION 1
+/*! \brief Taille de l'en-tête d'un fichier de reprise. */
+#define TAILLE_ENTETE 32
+
+/*!
+ * \brief Écriture d'un entier de n octets petit-boutistes.
+ */
+static void ecrire_entier(unsigned char *octets, unsigned long long v, int n) {
+  for (int i = 0; i < n; i++) {
+    octets[i] = (unsigned char)(v >> (8 * i));
+  }
+}
+
+/*!
+ * \brief Lecture d'un entier de n octets petit-boutistes.
+ */
+static unsigned long long lire_entier(unsigned char const *octets, int n) {
+  unsigned long long v = 0;
+  for (int i = n - 1; i >= 0; i--) {
+    v = v << 8 | octets[i];
+  }
+  return v;
+}
+
+/*!
+ * \brief Synchronise le répertoire d'un fichier, pour qu'un renommage y soit
+ * durable.
+ * \param chemin fichier du répertoire.
+ * \return true ssi le répertoire a été synchronisé.
+ */
+static bool repertoire_synchroniser(char const *chemin) {
+  char const *separateur = strrchr(chemin, '/');
+  char *repertoire;
+  if (separateur == NULL) {
+    repertoire = malloc(2);
+    strcpy(repertoire, ".");
+  } else {
+    size_t longueur = separateur == chemin ? 1 : (size_t)(separateur - chemin);
+    repertoire = malloc(longueur + 1);
+    memcpy(repertoire, chemin, longueur);
+    repertoire[longueur] = '\0';
+  }
+  int fd = open(repertoire, O_RDONLY);
+  free(repertoire);
+  if (fd < 0) {
+    return false;
+  }
+  bool valide = fsync(fd) == 0;
+  return close(fd) == 0 && valide;
+}
+
+/*!
+ * \brief Vérifie que chaque octet code une algue de taille comprise entre TMIN
+ * et TMAX ; l'orientation, donnée par le bit de poids faible, est toujours
+ * valide.
+ * \param octets codes des algues.
+ * \param n nombre d'algues.
+ * \return true ssi toutes les algues sont valides.
+ */
+static bool algues_valides(unsigned char const *octets, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    int taille = octet_taille(octets[i]);
+    if (taille < TMIN || taille > TMAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool reprise_ecrire(char const *chemin, algue_regle const *r,
+                    unsigned long long iterations, liste l) {
+  assert(chemin != NULL && r != NULL && l != NULL);
+  unsigned char entete[TAILLE_ENTETE] = {0};
+  memcpy(entete, SIGNATURE, strlen(SIGNATURE));
+  entete[7] = VERSION;
+  ecrire_entier(entete + 8, (unsigned long long)r->t1, 2);
+  ecrire_entier(entete + 10, (unsigned long long)r->t2, 2);
+  ecrire_entier(entete + 12, (unsigned long long)r->tmin, 2);
+  ecrire_entier(entete + 14, (unsigned long long)r->tmax, 2);
+  ecrire_entier(entete + 16, iterations, 8);
+  ecrire_entier(entete + 24, liste_taille_etendue(l), 8);
+
+  char *temporaire = malloc(strlen(chemin) + 5);
+  sprintf(temporaire, "%s.tmp", chemin);
+  FILE *f = fopen(temporaire, "wb");
+  if (f == NULL) {
+    free(temporaire);
+    return false;
+  }
+  fwrite(entete, 1, TAILLE_ENTETE, f);
+  liste_courant_init(l);
+  for (size_t i = 0; i < liste_taille_etendue(l); i++) {
+    algue const *a = liste_valeur_courant(l);
+    putc(algue_octet(a->taille, a->orientation), f);
+    liste_courant_suivant(l);
+  }
+  // Les données doivent être sur le disque avant le renommage, sinon une
+  // panne pourrait laisser un fichier de reprise tronqué.
+  bool valide = fflush(f) == 0 && !ferror(f) && fsync(fileno(f)) == 0;
+  valide = fclose(f) == 0 && valide;
+  valide = valide && rename(temporaire, chemin) == 0;
+  if (!valide) {
+    remove(temporaire);
+  }
+  // Le renommage n'est durable qu'une fois le répertoire synchronisé.
+  valide = valide && repertoire_synchroniser(chemin);
+  free(temporaire);
+  return valide;
+}
+
+liste reprise_lire(char const *chemin, algue_regle *r,
+                   unsigned long long *iterations) {
+  assert(chemin != NULL && r != NULL && iterations != NULL);
+  int fd = open(chemin, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < TAILLE_ENTETE) {
+    close(fd);
+    return NULL;
+  }
+  size_t taille_fichier = (size_t)st.st_size;
+  unsigned char const *octets =
+      mmap(NULL, taille_fichier, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (octets == MAP_FAILED) {
+    return NULL;
+  }
+  posix_madvise((void *)octets, taille_fichier, POSIX_MADV_SEQUENTIAL);
+  unsigned long long taille = lire_entier(octets + 24, 8);
+  liste l = NULL;
+  if (memcmp(octets, SIGNATURE, strlen(SIGNATURE)) == 0 &&
+      octets[7] == VERSION && taille > 0 && taille <= UINT_MAX &&
+      taille == taille_fichier - TAILLE_ENTETE &&
+      algues_valides(octets + TAILLE_ENTETE, (size_t)taille)) {
+    r->t1 = (int)lire_entier(octets + 8, 2);
+    r->t2 = (int)lire_entier(octets + 10, 2);
+    r->tmin = (int)lire_entier(octets + 12, 2);
+    r->tmax = (int)lire_entier(octets + 14, 2);
+    *iterations = lire_entier(octets + 16, 8);
+    l = algue_liste_init(&copier_algue, &afficher_algue, &detruire_algue);
+    // algue_liste_init crée une première algue, remplacée par celle du fichier
+    algue *a = liste_valeur_tete(l);
+    a->taille = octet_taille(octets[TAILLE_ENTETE]);
+    a->orientation = octet_orientation(octets[TAILLE_ENTETE]);
+    for (unsigned long long i = 1; i < taille; i++) {
+      algue b = {octet_taille(octets[TAILLE_ENTETE + i]),
+                 octet_orientation(octets[TAILLE_ENTETE + i])};
+      liste_insertion_fin(l, &b);
+    }
+  }
+  munmap((void *)octets, taille_fichier);
+  return l;
+}
@@ -0,0 +1,47 @@
+#ifndef ALGUES_REPRISE
+#define ALGUES_REPRISE
+#include "algues.h"
+#include <stdbool.h>
+
+/*! \file
+ * \brief Points de reprise des simulations d'algues.
+ *
+ * Un point de reprise contient la règle d'évolution, le nombre d'itérations
+ * déjà faites et la colonie, à raison d'un octet par algue (cf algue_octet).
+ * Le fichier commence par un en-tête de 32 octets : "ALGREPR", une version,
+ * les quatre paramètres de la règle sur 2 octets, puis le nombre
+ * d'itérations et le nombre d'algues sur 8 octets, tous petit-boutistes.
+ *
+ * L'écriture passe par un fichier temporaire renommé une fois complet, puis
+ * le répertoire est synchronisé : le fichier de reprise est toujours soit
+ * l'ancien point, soit le nouveau. À la lecture, un fichier dont une algue
+ * n'a pas une taille entre TMIN et TMAX est refusé.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Écrit un point de reprise de la colonie.
+ * \param chemin fichier de reprise, remplacé atomiquement.
+ * \param r règle d'évolution de la colonie.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param l colonie à sauvegarder.
+ * \return true ssi le point de reprise a été écrit.
+ */
+bool reprise_ecrire(char const *chemin, algue_regle const *r,
+                    unsigned long long iterations, liste l);
+
+/*!
+ * \brief Reconstruit une colonie à partir d'un point de reprise. Le fichier
+ * est projeté en mémoire et la colonie construite en un seul parcours.
+ * \param chemin fichier de reprise.
+ * \param r règle d'évolution lue.
+ * \param iterations nombre d'itérations lu.
+ * \return la colonie, créée comme par algue_liste_init, ou NULL si le fichier
+ * n'existe pas ou est invalide.
+ */
+liste reprise_lire(char const *chemin, algue_regle *r,
+                   unsigned long long *iterations);
+
+#endif
@@ -0,0 +1,240 @@
+#include "algues_soa.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Nombre d'algues par bloc de la somme préfixe. */
+#define BLOC 64
+
+/*!
+ * \brief Tampon de tailles et d'orientations.
+ */
+typedef struct tampon {
+  int8_t *tailles;
+  int8_t *orientations;
+  size_t capacite;
+} tampon;
+
+/*!
+ * \brief La colonie lit dans entree et écrit dans sortie, qui sont échangés à
+ * la fin de chaque itération. divisions contient le nombre de divisions de
+ * chaque bloc, puis leur somme préfixe.
+ */
+struct colonie_soa_struct {
+  algue_regle regle;
+  size_t taille;
+  tampon entree;
+  tampon sortie;
+  size_t *divisions;
+  size_t capacite_divisions;
+};
+
+/*!
+ * \brief Agrandit le tampon pour qu'il puisse contenir n algues.
+ * \param t tampon à agrandir.
+ * \param n nombre d'algues à pouvoir contenir.
+ */
+static void tampon_reserver(tampon *t, size_t n) {
+  if (n > t->capacite) {
+    size_t capacite = t->capacite == 0 ? BLOC : t->capacite;
+    while (capacite < n) {
+      capacite *= 2;
+    }
+    t->tailles = realloc(t->tailles, capacite);
+    t->orientations = realloc(t->orientations, capacite);
+    assert(t->tailles != NULL && t->orientations != NULL);
+    t->capacite = capacite;
+  }
+}
+
+/*!
+ * \brief Fait grandir les algues d'un bloc qui ne se divisent pas et marque
+ * celles qui se divisent d'une taille nulle.
+ * \param tailles tailles des algues du bloc, modifiées en place.
+ * \param n nombre d'algues du bloc.
+ * \param tmax taille à laquelle une algue se divise.
+ * \return le nombre d'algues du bloc qui se divisent.
+ */
+static size_t bloc_grandir(int8_t *tailles, size_t n, int8_t tmax) {
+  size_t divisions = 0;
+  size_t i = 0;
+#ifdef __SSE2__
+  __m128i const vtmax = _mm_set1_epi8(tmax);
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128((__m128i const *)(tailles + i));
+    /* -1 pour les algues qui grandissent, 0 pour celles qui se divisent */
+    __m128i grandit = _mm_cmplt_epi8(v, vtmax);
+    v = _mm_and_si128(_mm_sub_epi8(v, grandit), grandit);
+    _mm_storeu_si128((__m128i *)(tailles + i), v);
+    divisions += 16 - (size_t)__builtin_popcount(_mm_movemask_epi8(grandit));
+  }
+#endif
+  for (; i < n; i++) {
+    if (tailles[i] >= tmax) {
+      tailles[i] = 0;
+      divisions++;
+    } else {
+      tailles[i]++;
+    }
+  }
+  return divisions;
+}
+
+/*!
+ * \brief Recopie un bloc dans le tampon de sortie en développant les
+ * divisions, marquées par bloc_grandir.
+ * Les deux algues issues d'une division sont dans l'ordre de algue_iteration :
+ * la petite algue est du côté de son orientation.
+ * \param r règle d'évolution.
+ * \param e tampon d'entrée.
+ * \param debut indice de la première algue du bloc dans l'entrée.
+ * \param n nombre d'algues du bloc.
+ * \param s tampon de sortie.
+ * \param o indice de la première algue du bloc dans la sortie.
+ */
+static void bloc_developper(algue_regle const *r, tampon const *e,
+                            size_t debut, size_t n, tampon *s, size_t o) {
+  for (size_t i = debut; i < debut + n; i++) {
+    int8_t orientation = e->orientations[i];
+    if (e->tailles[i] == 0) {
+      s->tailles[o] = (int8_t)(orientation == GAUCHE ? r->t1 : r->t2);
+      s->orientations[o++] = GAUCHE;
+      s->tailles[o] = (int8_t)(orientation == GAUCHE ? r->t2 : r->t1);
+      s->orientations[o++] = DROITE;
+    } else {
+      s->tailles[o] = e->tailles[i];
+      s->orientations[o++] = orientation;
+    }
+  }
+}
+
+colonie_soa colonie_soa_creer(algue_regle const *r) {
+  assert(r != NULL);
+  assert(r->tmax <= INT8_MAX);
+  colonie_soa c = malloc(sizeof(struct colonie_soa_struct));
+  c->regle = *r;
+  c->entree.tailles = c->entree.orientations = NULL;
+  c->entree.capacite = 0;
+  c->sortie = c->entree;
+  c->divisions = NULL;
+  c->capacite_divisions = 0;
+  tampon_reserver(&c->entree, 1);
+  c->entree.tailles[0] = (int8_t)r->t1;
+  c->entree.orientations[0] = GAUCHE;
+  c->taille = 1;
+  return c;
+}
+
+void colonie_soa_detruire(colonie_soa *c) {
+  assert(c != NULL && *c != NULL);
+  free((*c)->entree.tailles);
+  free((*c)->entree.orientations);
+  free((*c)->sortie.tailles);
+  free((*c)->sortie.orientations);
+  free((*c)->divisions);
+  free(*c);
+  *c = NULL;
+}
+
+void colonie_soa_reinitialiser(colonie_soa c, algue_regle const *r) {
+  assert(c != NULL && r != NULL);
+  assert(r->tmax <= INT8_MAX);
+  c->regle = *r;
+  c->entree.tailles[0] = (int8_t)r->t1;
+  c->entree.orientations[0] = GAUCHE;
+  c->taille = 1;
+}
+
+/*!
+ * \brief Itération avec une règle donnée. Avec la règle par défaut, qui est
+ * constante, le compilateur peut spécialiser les deux passes.
+ * \param c colonie à faire évoluer.
+ * \param r règle d'évolution.
+ */
+static inline void iteration_regle(colonie_soa c, algue_regle const *r) {
+  size_t nb_blocs = (c->taille + BLOC - 1) / BLOC;
+  if (nb_blocs > c->capacite_divisions) {
+    c->divisions = realloc(c->divisions, nb_blocs * sizeof(size_t));
+    assert(c->divisions != NULL);
+    c->capacite_divisions = nb_blocs;
+  }
+  size_t total = 0;
+  for (size_t b = 0; b < nb_blocs; b++) {
+    size_t debut = b * BLOC;
+    size_t n = c->taille - debut < BLOC ? c->taille - debut : BLOC;
+    size_t d = bloc_grandir(c->entree.tailles + debut, n, (int8_t)r->tmax);
+    /* somme préfixe exclusive : divisions des blocs précédents */
+    c->divisions[b] = total;
+    total += d;
+  }
+  tampon_reserver(&c->sortie, c->taille + total);
+  for (size_t b = 0; b < nb_blocs; b++) {
+    size_t debut = b * BLOC;
+    size_t n = c->taille - debut < BLOC ? c->taille - debut : BLOC;
+    size_t o = debut + c->divisions[b];
+    size_t d = (b + 1 < nb_blocs ? c->divisions[b + 1] : total) -
+               c->divisions[b];
+    if (d == 0) {
+      memcpy(c->sortie.tailles + o, c->entree.tailles + debut, n);
+      memcpy(c->sortie.orientations + o, c->entree.orientations + debut, n);
+    } else {
+      bloc_developper(r, &c->entree, debut, n, &c->sortie, o);
+    }
+  }
+  tampon t = c->entree;
+  c->entree = c->sortie;
+  c->sortie = t;
+  c->taille += total;
+}
+
+void colonie_soa_iteration(colonie_soa c) {
+  assert(c != NULL);
+  static algue_regle const defaut = REGLE_DEFAUT;
+  if (memcmp(&c->regle, &defaut, sizeof(defaut)) == 0) {
+    iteration_regle(c, &defaut);
+  } else {
+    iteration_regle(c, &c->regle);
+  }
+}
+
+size_t colonie_soa_taille(colonie_soa c) {
+  assert(c != NULL);
+  return c->taille;
+}
+
+algue colonie_soa_valeur(colonie_soa c, size_t i) {
+  assert(c != NULL && i < c->taille);
+  algue a = {c->entree.tailles[i], c->entree.orientations[i]};
+  return a;
+}
+
+void colonie_soa_affichage(FILE *f, colonie_soa c) {
+  assert(f != NULL && c != NULL);
+  fprintf(f, "Liste de %zu éléments : [ ", c->taille);
+  for (size_t i = 0; i < c->taille; i++) {
+    fprintf(f, "(%d,%d)", c->entree.tailles[i], c->entree.orientations[i]);
+  }
+  fprintf(f, "]");
+}
+
+void colonie_soa_stats(colonie_soa c, unsigned long long iterations,
+                       algue_stats *s) {
+  assert(c != NULL && s != NULL);
+  algue_stats_initialiser(&c->regle, iterations, s);
+  for (size_t i = 0; i < c->taille; i++) {
+    s->histogramme[algue_etat(&c->regle, c->entree.tailles[i],
+                              c->entree.orientations[i])]++;
+  }
+  algue_stats_terminer(s);
+}
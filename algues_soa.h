@@ -0,0 +1,93 @@
+#ifndef ALGUES_SOA
+#define ALGUES_SOA
+#include "algues.h"
+#include "algues_stats.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Moteur de simulation des algues par tableaux parallèles.
+ *
+ * La colonie est enregistrée dans deux tableaux d'octets, l'un pour les
+ * tailles et l'autre pour les orientations. Une itération lit un tampon et
+ * écrit le suivant : une première passe vectorisée fait grandir les algues et
+ * compte les divisions par bloc, une somme préfixe des divisions donne la
+ * position de chaque bloc dans le tampon de sortie, puis une seconde passe
+ * recopie les blocs et y développe les divisions.
+ *
+ * L'ordre des algues est celui de algue_iteration.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Colonie d'algues en tableaux parallèles.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_soa_struct *colonie_soa;
+
+/*!
+ * \brief Création d'une colonie contenant une algue de taille r->t1 orientée
+ * vers la gauche.
+ * \param r règle d'évolution, recopiée dans la colonie.
+ * \return une nouvelle colonie.
+ */
+colonie_soa colonie_soa_creer(algue_regle const *r);
+
+/*!
+ * \brief Destruction de la colonie.
+ * \param c pointeur vers la colonie à détruire.
+ */
+void colonie_soa_detruire(colonie_soa *c);
+
+/*!
+ * \brief Remet la colonie à une algue de taille r->t1 orientée vers la
+ * gauche, en gardant ses tampons : une colonie peut ainsi servir à plusieurs
+ * simulations sans nouvelle allocation.
+ * \param c colonie à réinitialiser.
+ * \param r nouvelle règle d'évolution, recopiée dans la colonie.
+ */
+void colonie_soa_reinitialiser(colonie_soa c, algue_regle const *r);
+
+/*!
+ * \brief Fait évoluer chaque algue de la colonie d'une itération.
+ * \param c colonie à faire évoluer.
+ */
+void colonie_soa_iteration(colonie_soa c);
+
+/*!
+ * \brief Retourne le nombre d'algues de la colonie.
+ * \param c colonie sur laquelle porte la demande.
+ * \return le nombre d'algues.
+ */
+size_t colonie_soa_taille(colonie_soa c);
+
+/*!
+ * \brief Retourne l'algue à la position i.
+ * \param c colonie sur laquelle porte la demande.
+ * \param i position de l'algue, inférieure à la taille de la colonie.
+ * \return l'algue à la position i.
+ */
+algue colonie_soa_valeur(colonie_soa c, size_t i);
+
+/*!
+ * \brief Affichage de la colonie, dans le même format que liste_affichage :
+ * \verbatim Liste de 2 éléments : [ (4,-1)(5,1)]\endverbatim
+ * sans passage à la ligne à la fin.
+ * \param f flux où imprimer.
+ * \param c colonie à afficher.
+ */
+void colonie_soa_affichage(FILE *f, colonie_soa c);
+
+/*!
+ * \brief Calcule les statistiques de la colonie.
+ * \param c colonie à compter.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param s statistiques à remplir.
+ */
+void colonie_soa_stats(colonie_soa c, unsigned long long iterations,
+                       algue_stats *s);
+
+#endif
@@ -0,0 +1,322 @@
+#include "algues_stats.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Matrice de transition entre états, élevée progressivement au carré.
+ * coef[j][i] est le nombre d'algues dans l'état j issues d'une algue dans
+ * l'état i. approx contient les mêmes coefficients divisés par 10^log10_echelle
+ * pour en suivre l'ordre de grandeur sans débordement.
+ */
+typedef struct matrice {
+  unsigned long long coef[ALGUE_STATS_MAX_ETATS][ALGUE_STATS_MAX_ETATS];
+  double approx[ALGUE_STATS_MAX_ETATS][ALGUE_STATS_MAX_ETATS];
+  double log10_echelle;
+} matrice;
+
+/*!
+ * \brief Vecteur d'effectifs par état, avec son ordre de grandeur.
+ */
+typedef struct vecteur {
+  unsigned long long coef[ALGUE_STATS_MAX_ETATS];
+  double approx[ALGUE_STATS_MAX_ETATS];
+  double log10_echelle;
+} vecteur;
+
+/*!
+ * \brief Vérifie la cohérence de la règle et retourne son nombre d'états.
+ * \param r règle d'évolution.
+ * \return le nombre d'états (taille, orientation).
+ */
+static unsigned int regle_nb_etats(algue_regle const *r) {
+  assert(r != NULL);
+  assert(r->tmin <= r->t1 && r->t1 <= r->tmax);
+  assert(r->tmin <= r->t2 && r->t2 <= r->tmax);
+  unsigned int nb_etats = 2 * (unsigned int)(r->tmax - r->tmin + 1);
+  assert(nb_etats <= ALGUE_STATS_MAX_ETATS);
+  return nb_etats;
+}
+
+unsigned int algue_etat(algue_regle const *r, int taille, int orientation) {
+  assert(r != NULL);
+  assert(taille >= r->tmin && taille <= r->tmax);
+  assert(orientation == GAUCHE || orientation == DROITE);
+  return 2 * (unsigned int)(taille - r->tmin) + (orientation == DROITE);
+}
+
+/*!
+ * \brief Somme modulaire.
+ * \param a premier terme, inférieur au modulo.
+ * \param b second terme, inférieur au modulo.
+ * \param modulo modulo, 0 pour 2^64.
+ * \return (a + b) modulo.
+ */
+static unsigned long long mod_somme(unsigned long long a, unsigned long long b,
+                                    unsigned long long modulo) {
+  if (modulo == 0) {
+    return a + b;
+  }
+  return a >= modulo - b ? a - (modulo - b) : a + b;
+}
+
+/*!
+ * \brief Produit modulaire.
+ * \param a premier facteur, inférieur au modulo.
+ * \param b second facteur, inférieur au modulo.
+ * \param modulo modulo, 0 pour 2^64, sinon au plus 2^32.
+ * \return (a * b) modulo.
+ */
+static unsigned long long mod_produit(unsigned long long a,
+                                      unsigned long long b,
+                                      unsigned long long modulo) {
+  if (modulo == 0) {
+    return a * b;
+  }
+  return (a * b) % modulo;
+}
+
+/*!
+ * \brief Ramène le plus grand coefficient approché à 1 en reportant le
+ * facteur dans l'échelle.
+ * \param approx coefficients approchés.
+ * \param nb nombre de coefficients.
+ * \param log10_echelle échelle à mettre à jour.
+ */
+static void normaliser(double *approx, unsigned int nb,
+                       double *log10_echelle) {
+  double max = 0.0;
+  for (unsigned int i = 0; i < nb; i++) {
+    if (approx[i] > max) {
+      max = approx[i];
+    }
+  }
+  if (max > 0.0) {
+    for (unsigned int i = 0; i < nb; i++) {
+      approx[i] /= max;
+    }
+    *log10_echelle += log10(max);
+  }
+}
+
+/*!
+ * \brief Construit la matrice de transition d'une itération.
+ * \param r règle d'évolution.
+ * \param nb_etats nombre d'états.
+ * \param m matrice à remplir.
+ */
+static void matrice_transition(algue_regle const *r, unsigned int nb_etats,
+                               matrice *m) {
+  memset(m, 0, sizeof(matrice));
+  for (int taille = r->tmin; taille <= r->tmax; taille++) {
+    for (int o = GAUCHE; o <= DROITE; o += DROITE - GAUCHE) {
+      unsigned int i = algue_etat(r, taille, o);
+      if (taille >= r->tmax) {
+        m->coef[algue_etat(r, r->t1, o)][i]++;
+        m->coef[algue_etat(r, r->t2, -o)][i]++;
+      } else {
+        m->coef[algue_etat(r, taille + 1, o)][i]++;
+      }
+    }
+  }
+  for (unsigned int j = 0; j < nb_etats; j++) {
+    for (unsigned int i = 0; i < nb_etats; i++) {
+      m->approx[j][i] = (double)m->coef[j][i];
+    }
+  }
+  m->log10_echelle = 0.0;
+}
+
+/*!
+ * \brief Élève la matrice au carré.
+ * \param m matrice à élever au carré.
+ * \param tmp matrice de travail.
+ * \param nb_etats nombre d'états.
+ * \param modulo modulo des coefficients.
+ */
+static void matrice_carre(matrice *m, matrice *tmp, unsigned int nb_etats,
+                          unsigned long long modulo) {
+  for (unsigned int j = 0; j < nb_etats; j++) {
+    for (unsigned int i = 0; i < nb_etats; i++) {
+      unsigned long long c = 0;
+      double a = 0.0;
+      for (unsigned int k = 0; k < nb_etats; k++) {
+        c = mod_somme(c, mod_produit(m->coef[j][k], m->coef[k][i], modulo),
+                      modulo);
+        a += m->approx[j][k] * m->approx[k][i];
+      }
+      tmp->coef[j][i] = c;
+      tmp->approx[j][i] = a;
+    }
+  }
+  memcpy(m->coef, tmp->coef, sizeof(tmp->coef));
+  memcpy(m->approx, tmp->approx, sizeof(tmp->approx));
+  m->log10_echelle *= 2;
+  normaliser(&m->approx[0][0], ALGUE_STATS_MAX_ETATS * ALGUE_STATS_MAX_ETATS,
+             &m->log10_echelle);
+}
+
+/*!
+ * \brief Applique la matrice au vecteur.
+ * \param m matrice à appliquer.
+ * \param v vecteur remplacé par m v.
+ * \param nb_etats nombre d'états.
+ * \param modulo modulo des coefficients.
+ */
+static void matrice_appliquer(matrice const *m, vecteur *v,
+                              unsigned int nb_etats,
+                              unsigned long long modulo) {
+  vecteur tmp;
+  memset(&tmp, 0, sizeof(vecteur));
+  for (unsigned int j = 0; j < nb_etats; j++) {
+    for (unsigned int i = 0; i < nb_etats; i++) {
+      tmp.coef[j] = mod_somme(
+          tmp.coef[j], mod_produit(m->coef[j][i], v->coef[i], modulo), modulo);
+      tmp.approx[j] += m->approx[j][i] * v->approx[i];
+    }
+  }
+  memcpy(v->coef, tmp.coef, sizeof(tmp.coef));
+  memcpy(v->approx, tmp.approx, sizeof(tmp.approx));
+  v->log10_echelle += m->log10_echelle;
+  normaliser(v->approx, nb_etats, &v->log10_echelle);
+}
+
+/*!
+ * \brief Remplit la population et l'exactitude à partir de l'histogramme.
+ * \param s statistiques dont l'histogramme est rempli.
+ */
+static void stats_totaliser(algue_stats *s) {
+  double total = 0.0;
+  double max = -INFINITY;
+  s->population = 0;
+  for (unsigned int i = 0; i < s->nb_etats; i++) {
+    s->population = mod_somme(s->population, s->histogramme[i], s->modulo);
+    if (s->log10_histogramme[i] > max) {
+      max = s->log10_histogramme[i];
+    }
+  }
+  for (unsigned int i = 0; i < s->nb_etats; i++) {
+    total += pow(10.0, s->log10_histogramme[i] - max);
+  }
+  s->log10_population = max + log10(total);
+  /* 2^64 vaut environ 1.8e19 : la marge couvre l'erreur d'arrondi */
+  double log10_modulo = s->modulo == 0 ? 19.0 : log10((double)s->modulo);
+  s->exact = s->log10_population < log10_modulo - 1e-6;
+}
+
+void algue_stats_calculer(algue_regle const *r, unsigned long long n,
+                          unsigned long long modulo, algue_stats *s) {
+  assert(s != NULL);
+  assert(modulo == 0 || modulo <= (1ULL << 32));
+  matrice *puissance = malloc(sizeof(matrice));
+  matrice *tmp = malloc(sizeof(matrice));
+  vecteur v;
+  unsigned int nb_etats = regle_nb_etats(r);
+  s->iterations = n;
+  matrice_transition(r, nb_etats, puissance);
+  if (modulo != 0) {
+    for (unsigned int j = 0; j < nb_etats; j++) {
+      for (unsigned int i = 0; i < nb_etats; i++) {
+        puissance->coef[j][i] %= modulo;
+      }
+    }
+  }
+  memset(&v, 0, sizeof(vecteur));
+  v.coef[algue_etat(r, r->t1, GAUCHE)] = modulo == 1 ? 0 : 1;
+  v.approx[algue_etat(r, r->t1, GAUCHE)] = 1.0;
+  while (n > 0) {
+    if (n & 1) {
+      matrice_appliquer(puissance, &v, nb_etats, modulo);
+    }
+    n >>= 1;
+    if (n > 0) {
+      matrice_carre(puissance, tmp, nb_etats, modulo);
+    }
+  }
+  free(puissance);
+  free(tmp);
+  s->modulo = modulo;
+  s->nb_etats = nb_etats;
+  for (unsigned int i = 0; i < nb_etats; i++) {
+    s->histogramme[i] = v.coef[i];
+    s->log10_histogramme[i] =
+        v.approx[i] > 0.0 ? v.log10_echelle + log10(v.approx[i]) : -INFINITY;
+  }
+  stats_totaliser(s);
+}
+
+void algue_stats_initialiser(algue_regle const *r,
+                             unsigned long long iterations, algue_stats *s) {
+  assert(s != NULL);
+  s->iterations = iterations;
+  s->modulo = 0;
+  s->nb_etats = regle_nb_etats(r);
+  memset(s->histogramme, 0, sizeof(s->histogramme));
+}
+
+void algue_stats_terminer(algue_stats *s) {
+  assert(s != NULL);
+  for (unsigned int i = 0; i < s->nb_etats; i++) {
+    s->log10_histogramme[i] = s->histogramme[i] > 0
+                                  ? log10((double)s->histogramme[i])
+                                  : -INFINITY;
+  }
+  stats_totaliser(s);
+}
+
+void algue_stats_liste(algue_regle const *r, liste l,
+                       unsigned long long iterations, algue_stats *s) {
+  assert(l != NULL && s != NULL);
+  algue_stats_initialiser(r, iterations, s);
+  liste_courant_init(l);
+  for (size_t i = 0; i < liste_taille_etendue(l); i++) {
+    algue *a = liste_valeur_courant(l);
+    s->histogramme[algue_etat(r, a->taille, a->orientation)]++;
+    liste_courant_suivant(l);
+  }
+  algue_stats_terminer(s);
+}
+
+void algue_stats_afficher_effectif(FILE *f, algue_stats const *s,
+                                   unsigned long long valeur,
+                                   double log10_valeur) {
+  assert(f != NULL && s != NULL);
+  if (s->exact || isinf(log10_valeur)) {
+    fprintf(f, "%llu", valeur);
+  } else {
+    double exposant = floor(log10_valeur);
+    fprintf(f, "~%.6fe%.0f (modulo ", pow(10.0, log10_valeur - exposant),
+            exposant);
+    if (s->modulo == 0) {
+      fprintf(f, "2^64");
+    } else {
+      fprintf(f, "%llu", s->modulo);
+    }
+    fprintf(f, " : %llu)", valeur);
+  }
+}
+
+void algue_stats_afficher(FILE *f, algue_regle const *r, algue_stats const *s) {
+  assert(f != NULL && r != NULL && s != NULL);
+  fprintf(f, "la population après %llu itérations : ", s->iterations);
+  algue_stats_afficher_effectif(f, s, s->population, s->log10_population);
+  fprintf(f, "\n");
+  for (int taille = r->tmin; taille <= r->tmax; taille++) {
+    for (int o = GAUCHE; o <= DROITE; o += DROITE - GAUCHE) {
+      unsigned int i = algue_etat(r, taille, o);
+      fprintf(f, "(%d,%d) : ", taille, o);
+      algue_stats_afficher_effectif(f, s, s->histogramme[i],
+                                    s->log10_histogramme[i]);
+      fprintf(f, "\n");
+    }
+  }
+}
@@ -0,0 +1,120 @@
+#ifndef ALGUES_STATS
+#define ALGUES_STATS
+#include "algues.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Statistiques de population des algues sans matérialiser la colonie.
+ *
+ * L'évolution d'une algue ne dépend que de son état (taille, orientation). Le
+ * nombre d'algues dans chaque état après n itérations s'obtient donc en
+ * élevant la matrice de transition entre états à la puissance n, par
+ * exponentiation rapide.
+ *
+ * Les effectifs sont calculés modulo 2^64 (ou modulo un entier donné) et
+ * accompagnés de leur logarithme décimal, qui donne leur ordre de grandeur
+ * quand ils dépassent le modulo.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Nombre maximal d'états (taille, orientation) gérés. */
+#define ALGUE_STATS_MAX_ETATS 64
+
+/*!
+ * \brief Population et histogramme par état d'une colonie.
+ * L'état d'indice i correspond à la taille tmin + i / 2, orientée à gauche si
+ * i est pair et à droite sinon.
+ */
+typedef struct algue_stats {
+  unsigned long long iterations; /* nombre d'itérations depuis l'algue
+                                    initiale */
+  unsigned long long modulo;     /* modulo des effectifs, 0 pour 2^64 */
+  bool exact;                    /* vrai si les effectifs sont exacts */
+  unsigned int nb_etats;
+  unsigned long long population; /* population modulo */
+  double log10_population;       /* ordre de grandeur de la population */
+  unsigned long long histogramme[ALGUE_STATS_MAX_ETATS]; /* effectif modulo */
+  double log10_histogramme[ALGUE_STATS_MAX_ETATS]; /* ordre de grandeur, -inf
+                                                       si l'état est vide */
+} algue_stats;
+
+/*!
+ * \brief Retourne l'indice de l'état (taille, orientation).
+ * \param r règle d'évolution.
+ * \param taille taille de l'algue, entre r->tmin et r->tmax.
+ * \param orientation GAUCHE ou DROITE.
+ * \return l'indice de l'état dans l'histogramme.
+ */
+unsigned int algue_etat(algue_regle const *r, int taille, int orientation);
+
+/*!
+ * \brief Calcule la population après n itérations depuis l'algue initiale
+ * (taille r->t1, orientée à gauche).
+ * Le calcul se fait en O(e^3 log n) pour e états.
+ * \param r règle d'évolution.
+ * \param n nombre d'itérations.
+ * \param modulo modulo des effectifs, 0 pour 2^64, sinon au plus 2^32.
+ * \param s statistiques à remplir.
+ */
+void algue_stats_calculer(algue_regle const *r, unsigned long long n,
+                          unsigned long long modulo, algue_stats *s);
+
+/*!
+ * \brief Prépare le comptage des algues d'une colonie matérialisée.
+ * L'histogramme est remis à zéro ; il doit ensuite être incrémenté pour
+ * chaque algue (à l'indice donné par algue_etat) puis algue_stats_terminer
+ * doit être appelé.
+ * \param r règle d'évolution.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param s statistiques à remplir.
+ */
+void algue_stats_initialiser(algue_regle const *r,
+                             unsigned long long iterations, algue_stats *s);
+
+/*!
+ * \brief Termine le comptage commencé par algue_stats_initialiser en
+ * calculant la population et les ordres de grandeur.
+ * \param s statistiques dont l'histogramme est rempli.
+ */
+void algue_stats_terminer(algue_stats *s);
+
+/*!
+ * \brief Calcule les statistiques d'une colonie matérialisée.
+ * \param r règle d'évolution.
+ * \param l colonie d'algues.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param s statistiques à remplir.
+ */
+void algue_stats_liste(algue_regle const *r, liste l,
+                       unsigned long long iterations, algue_stats *s);
+
+/*!
+ * \brief Affichage d'un effectif, exact ou approché : un effectif inexact est
+ * affiché par son ordre de grandeur suivi de sa valeur modulo.
+ * \param f flux où imprimer.
+ * \param s statistiques auxquelles appartient l'effectif.
+ * \param valeur effectif modulo.
+ * \param log10_valeur ordre de grandeur de l'effectif.
+ */
+void algue_stats_afficher_effectif(FILE *f, algue_stats const *s,
+                                   unsigned long long valeur,
+                                   double log10_valeur);
+
+/*!
+ * \brief Affichage de la population puis d'une ligne par état.
+ * Le résultat est de la forme :
+ * \verbatim la population après 20 itérations : 8
+(4,-1) : 0
+...\endverbatim
+ * Un effectif inexact est affiché par son ordre de grandeur suivi de sa
+ * valeur modulo.
+ * \param f flux où imprimer.
+ * \param r règle d'évolution.
+ * \param s statistiques à afficher.
+ */
+void algue_stats_afficher(FILE *f, algue_regle const *r, algue_stats const *s);
+
+#endif
@@ -0,0 +1,211 @@
+#include "algues_swar.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Bit de poids faible de chaque champ. */
+#define UNS 0x1111111111111111ULL
+/*! \brief Bits de taille de chaque champ. */
+#define TAILLES 0x7777777777777777ULL
+/*! \brief Bit d'orientation de chaque champ. */
+#define ORIENTATIONS 0x8888888888888888ULL
+/*! \brief Nombre d'algues par mot. */
+#define PAR_MOT 16
+
+/*!
+ * \brief Développement d'un octet (deux algues) : jusqu'à quatre champs,
+ * le premier dans les bits de poids faible.
+ */
+typedef struct developpement {
+  uint16_t champs;
+  uint8_t nombre;
+} developpement;
+
+/*!
+ * \brief La colonie lit les mots de entree et écrit ceux de sortie, qui sont
+ * échangés à la fin de chaque itération. Les champs qui suivent la dernière
+ * algue du dernier mot sont nuls.
+ */
+struct colonie_swar_struct {
+  algue_regle regle;
+  size_t taille;
+  uint64_t *entree;
+  uint64_t *sortie;
+  size_t capacite; /* nombre de mots de chaque tampon */
+  uint64_t divise; /* tmax - tmin répété dans chaque champ */
+  developpement table[256];
+};
+
+/*!
+ * \brief Écriture en fin de tampon, par champs de 4 bits : les champs sont
+ * accumulés dans un mot, écrit dès qu'il est plein.
+ */
+typedef struct ecriture {
+  uint64_t *mots;
+  uint64_t accumule;
+  unsigned int nombre; /* champs dans accumule, moins de PAR_MOT */
+} ecriture;
+
+/*!
+ * \brief Ajoute n champs, n <= PAR_MOT.
+ * \param e écriture en cours.
+ * \param champs les champs, le premier dans les bits de poids faible.
+ * \param n nombre de champs.
+ */
+static inline void ecriture_ajouter(ecriture *e, uint64_t champs,
+                                    unsigned int n) {
+  e->accumule |= champs << (4 * e->nombre);
+  e->nombre += n;
+  if (e->nombre >= PAR_MOT) {
+    *e->mots++ = e->accumule;
+    e->nombre -= PAR_MOT;
+    // Champs qui n'ont pas tenu dans le mot écrit
+    e->accumule = e->nombre == 0 ? 0 : champs >> (4 * (n - e->nombre));
+  }
+}
+
+/*!
+ * \brief Évolution d'une algue codée sur 4 bits.
+ * \param r règle d'évolution.
+ * \param champ algue codée.
+ * \param n nombre d'algues produites, 1 ou 2.
+ * \return les algues produites, la première dans les bits de poids faible.
+ */
+static unsigned int champ_evoluer(algue_regle const *r, unsigned int champ,
+                                  unsigned int *n) {
+  unsigned int droite = champ & 8;
+  if ((int)(champ & 7) < r->tmax - r->tmin) {
+    *n = 1;
+    return champ + 1;
+  }
+  // La petite algue est du côté de son orientation, cf algue_iteration
+  unsigned int gauche = (unsigned int)((droite ? r->t2 : r->t1) - r->tmin);
+  unsigned int droit = (unsigned int)((droite ? r->t1 : r->t2) - r->tmin);
+  *n = 2;
+  return gauche | (droit | 8) << 4;
+}
+
+/*!
+ * \brief Compte les algues qui se divisent dans un mot.
+ * \param c colonie.
+ * \param mot mot de 16 algues.
+ * \return un mot dont le bit de poids fort de chaque champ vaut 1 ssi l'algue
+ * se divise.
+ */
+static inline uint64_t divisions(colonie_swar c, uint64_t mot) {
+  // Un champ est nul ssi la taille de l'algue vaut tmax ; les champs sont
+  // inférieurs à 8, ajouter 7 met le bit de poids fort à 1 ssi il est non nul.
+  uint64_t ecart = (mot & TAILLES) ^ c->divise;
+  return ~(ecart + 7 * UNS) & ORIENTATIONS;
+}
+
+colonie_swar colonie_swar_creer(algue_regle const *r) {
+  assert(r != NULL);
+  assert(r->tmin >= 0 && r->tmax - r->tmin < 8);
+  assert(r->t1 >= r->tmin && r->t1 <= r->tmax);
+  assert(r->t2 >= r->tmin && r->t2 <= r->tmax);
+  colonie_swar c = malloc(sizeof(struct colonie_swar_struct));
+  c->regle = *r;
+  c->capacite = 1;
+  c->entree = calloc(c->capacite, sizeof(uint64_t));
+  c->sortie = calloc(c->capacite, sizeof(uint64_t));
+  c->entree[0] = (uint64_t)(r->t1 - r->tmin);
+  c->taille = 1;
+  c->divise = (uint64_t)(r->tmax - r->tmin) * UNS;
+  for (unsigned int octet = 0; octet < 256; octet++) {
+    unsigned int n1, n2;
+    unsigned int bas = champ_evoluer(r, octet & 0xF, &n1);
+    unsigned int haut = champ_evoluer(r, octet >> 4, &n2);
+    c->table[octet].champs = (uint16_t)(bas | haut << (4 * n1));
+    c->table[octet].nombre = (uint8_t)(n1 + n2);
+  }
+  return c;
+}
+
+void colonie_swar_detruire(colonie_swar *c) {
+  assert(c != NULL && *c != NULL);
+  free((*c)->entree);
+  free((*c)->sortie);
+  free(*c);
+  *c = NULL;
+}
+
+void colonie_swar_iteration(colonie_swar c) {
+  assert(c != NULL);
+  size_t nb_mots = (c->taille + PAR_MOT - 1) / PAR_MOT;
+  // Au pire, chaque algue se divise
+  size_t besoin = (2 * c->taille + PAR_MOT - 1) / PAR_MOT;
+  if (besoin > c->capacite) {
+    c->capacite = 2 * besoin;
+    free(c->sortie);
+    c->sortie = malloc(c->capacite * sizeof(uint64_t));
+    c->entree = realloc(c->entree, c->capacite * sizeof(uint64_t));
+    assert(c->entree != NULL && c->sortie != NULL);
+  }
+  ecriture e = {c->sortie, 0, 0};
+  size_t taille = 0;
+  size_t complets = c->taille / PAR_MOT;
+  for (size_t m = 0; m < complets; m++) {
+    uint64_t mot = c->entree[m];
+    uint64_t d = divisions(c, mot);
+    if (d == 0) {
+      ecriture_ajouter(&e, mot + UNS, PAR_MOT);
+      taille += PAR_MOT;
+    } else {
+      for (unsigned int o = 0; o < 8; o++) {
+        developpement const *dev = &c->table[(mot >> (8 * o)) & 0xFF];
+        ecriture_ajouter(&e, dev->champs, dev->nombre);
+        taille += dev->nombre;
+      }
+    }
+  }
+  // Dernier mot incomplet : les champs nuls qui suivent ne sont pas des algues
+  if (complets < nb_mots) {
+    uint64_t mot = c->entree[complets];
+    for (size_t i = complets * PAR_MOT; i < c->taille; i++) {
+      unsigned int n;
+      unsigned int champs = champ_evoluer(&c->regle, mot & 0xF, &n);
+      ecriture_ajouter(&e, champs, n);
+      taille += n;
+      mot >>= 4;
+    }
+  }
+  if (e.nombre > 0) {
+    *e.mots = e.accumule;
+  }
+  uint64_t *t = c->entree;
+  c->entree = c->sortie;
+  c->sortie = t;
+  c->taille = taille;
+}
+
+size_t colonie_swar_taille(colonie_swar c) {
+  assert(c != NULL);
+  return c->taille;
+}
+
+algue colonie_swar_valeur(colonie_swar c, size_t i) {
+  assert(c != NULL && i < c->taille);
+  unsigned int champ =
+      (unsigned int)(c->entree[i / PAR_MOT] >> (4 * (i % PAR_MOT))) & 0xF;
+  algue a = {c->regle.tmin + (int)(champ & 7), champ & 8 ? DROITE : GAUCHE};
+  return a;
+}
+
+void colonie_swar_stats(colonie_swar c, unsigned long long iterations,
+                        algue_stats *s) {
+  assert(c != NULL && s != NULL);
+  algue_stats_initialiser(&c->regle, iterations, s);
+  for (size_t i = 0; i < c->taille; i++) {
+    algue a = colonie_swar_valeur(c, i);
+    s->histogramme[algue_etat(&c->regle, a.taille, a.orientation)]++;
+  }
+  algue_stats_terminer(s);
+}
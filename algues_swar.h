@@ -0,0 +1,77 @@
+#ifndef ALGUES_SWAR
+#define ALGUES_SWAR
+#include "algues.h"
+#include "algues_stats.h"
+#include <stddef.h>
+
+/*! \file
+ * \brief Moteur de simulation des algues sur des mots de 64 bits.
+ *
+ * Chaque algue est codée sur 4 bits : taille - tmin sur les 3 bits de poids
+ * faible et l'orientation (1 pour DROITE) sur le bit de poids fort ; un mot
+ * de 64 bits contient 16 algues, la première dans les bits de poids faible.
+ * La règle doit vérifier tmax - tmin < 8.
+ *
+ * Une itération traite un mot à la fois, sans branchement par algue : les
+ * algues qui atteignent tmax sont repérées par une comparaison des 16
+ * champs en parallèle. Un mot sans division grandit par une seule addition ;
+ * un mot avec divisions est développé octet par octet avec une table de 256
+ * entrées, calculée pour la règle à la création de la colonie.
+ *
+ * L'ordre des algues est celui de algue_iteration.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Colonie d'algues codées sur 4 bits.
+ * La structure est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct colonie_swar_struct *colonie_swar;
+
+/*!
+ * \brief Création d'une colonie contenant une algue de taille r->t1 orientée
+ * vers la gauche.
+ * \param r règle d'évolution, recopiée dans la colonie ; tmax - tmin < 8.
+ * \return une nouvelle colonie.
+ */
+colonie_swar colonie_swar_creer(algue_regle const *r);
+
+/*!
+ * \brief Destruction de la colonie.
+ * \param c pointeur vers la colonie à détruire.
+ */
+void colonie_swar_detruire(colonie_swar *c);
+
+/*!
+ * \brief Fait évoluer chaque algue de la colonie d'une itération.
+ * \param c colonie à faire évoluer.
+ */
+void colonie_swar_iteration(colonie_swar c);
+
+/*!
+ * \brief Retourne le nombre d'algues de la colonie.
+ * \param c colonie sur laquelle porte la demande.
+ * \return le nombre d'algues.
+ */
+size_t colonie_swar_taille(colonie_swar c);
+
+/*!
+ * \brief Retourne l'algue à la position i.
+ * \param c colonie sur laquelle porte la demande.
+ * \param i position de l'algue, inférieure à la taille de la colonie.
+ * \return l'algue à la position i.
+ */
+algue colonie_swar_valeur(colonie_swar c, size_t i);
+
+/*!
+ * \brief Calcule les statistiques de la colonie.
+ * \param c colonie à compter.
+ * \param iterations nombre d'itérations qui ont produit la colonie.
+ * \param s statistiques à remplir.
+ */
+void colonie_swar_stats(colonie_swar c, unsigned long long iterations,
+                        algue_stats *s);
+
+#endif
@@ -0,0 +1,196 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE /* wait4 */
+#include "algues_flux.h"
+#include "algues_moteurs.h"
+#include "algues_stats.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Mesure de la montée en charge des moteurs de simulation des algues.
+ * Pour NBITER = 10, 20, 30... chaque moteur simule la colonie dans un
+ * processus fils, ce qui isole sa mémoire maximale (ru_maxrss) et permet de
+ * le borner par RLIMIT_AS. Un moteur est arrêté dès que la mémoire prévue
+ * (population donnée par algue_stats_calculer fois octets_par_algue) ou la
+ * population dépasse la limite, ou qu'une simulation échoue.
+ * Chaque fils renvoie une empreinte de sa colonie : tous les moteurs qui ont
+ * simulé un même NBITER doivent avoir la même.
+ * Le résultat est un fichier CSV sur la sortie standard.
+ */
+
+/* Allocations faites par le processus, comptées par les enveloppes
+   de malloc, calloc et realloc (édition de liens avec --wrap) */
+static unsigned long long nb_allocations;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t nb, size_t n);
+void *__real_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n) {
+  nb_allocations++;
+  return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t nb, size_t n) {
+  nb_allocations++;
+  return __real_calloc(nb, n);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+  nb_allocations++;
+  return __real_realloc(p, n);
+}
+
+/* Résultat d'une simulation, transmis du fils au père. */
+typedef struct mesure {
+  unsigned long long population;
+  unsigned long long algues_iterations; /* somme des populations traitées */
+  unsigned long long allocations;
+  double secondes;
+  uint64_t empreinte;
+} mesure;
+
+/* Empreinte FNV-1a des octets des algues (cf algue_octet). */
+static void empreinte_ajouter(algue const *a, void *donnees) {
+  uint64_t *h = donnees;
+  *h ^= algue_octet(a->taille, a->orientation);
+  *h *= 0x100000001B3u;
+}
+
+/* Simulation dans le fils : n itérations chronométrées, puis empreinte. */
+static void simuler(moteur_algues const *m, unsigned int n, mesure *r) {
+  algue_regle const regle = REGLE_DEFAUT;
+  struct timespec debut, fin;
+  unsigned long long allocations = nb_allocations;
+  void *c = m->creer(&regle);
+  r->algues_iterations = 0;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned int i = 0; i < n; i++) {
+    r->algues_iterations += m->taille(c);
+    m->iteration(c);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &fin);
+  r->allocations = nb_allocations - allocations;
+  r->secondes = (double)(fin.tv_sec - debut.tv_sec) +
+                (double)(fin.tv_nsec - debut.tv_nsec) * 1e-9;
+  r->population = m->taille(c);
+  r->empreinte = 0xCBF29CE484222325u;
+  m->parcourir(c, &empreinte_ajouter, &r->empreinte);
+  m->detruire(&c);
+}
+
+/*
+ * Lance la simulation dans un fils dont l'espace d'adressage est borné.
+ * Renvoie false si le fils a échoué ; rss reçoit sa mémoire maximale en ko.
+ */
+static bool mesurer(moteur_algues const *m, unsigned int n,
+                    unsigned long long memoire, mesure *r, long *rss) {
+  int tube[2];
+  if (pipe(tube) != 0) {
+    return false;
+  }
+  fflush(stdout);
+  pid_t fils = fork();
+  if (fils < 0) {
+    close(tube[0]);
+    close(tube[1]);
+    return false;
+  }
+  if (fils == 0) {
+    close(tube[0]);
+    // Marge pour le code, la pile et les bibliothèques
+    struct rlimit limite = {memoire + (64u << 20), memoire + (64u << 20)};
+    setrlimit(RLIMIT_AS, &limite);
+    simuler(m, n, r);
+    bool ecrit = write(tube[1], r, sizeof(*r)) == (ssize_t)sizeof(*r);
+    _exit(ecrit ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+  close(tube[1]);
+  bool lu = read(tube[0], r, sizeof(*r)) == (ssize_t)sizeof(*r);
+  close(tube[0]);
+  int statut;
+  struct rusage usage;
+  if (wait4(fils, &statut, 0, &usage) != fils) {
+    return false;
+  }
+  *rss = usage.ru_maxrss;
+  return lu && WIFEXITED(statut) && WEXITSTATUS(statut) == EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned long long memoire_mo = 1024;
+  unsigned long long iterations_max = 1000;
+  if (argc > 1) {
+    memoire_mo = strtoull(argv[1], NULL, 10);
+  }
+  if (argc > 2) {
+    iterations_max = strtoull(argv[2], NULL, 10);
+  }
+  if (argc > 3 || memoire_mo == 0 || iterations_max > UINT32_MAX) {
+    fprintf(stderr, "usage : %s [MEMOIRE_MO [ITERATIONS_MAX]]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  unsigned long long memoire = memoire_mo << 20;
+  algue_regle const regle = REGLE_DEFAUT;
+  bool actif[NB_MOTEURS_ALGUES];
+  bool identiques = true;
+  for (unsigned int k = 0; k < NB_MOTEURS_ALGUES; k++) {
+    actif[k] = true;
+  }
+  printf("moteur,iterations,population,secondes,rss_max_ko,allocations,"
+         "ns_par_algue_iteration,empreinte\n");
+  for (unsigned int n = 10; n <= iterations_max; n += 10) {
+    algue_stats s;
+    algue_stats_calculer(&regle, n, 0, &s);
+    bool reference = false;
+    uint64_t empreinte = 0;
+    unsigned int nb_actifs = 0;
+    for (unsigned int k = 0; k < NB_MOTEURS_ALGUES; k++) {
+      moteur_algues const *m = &moteurs_algues[k];
+      // Même le moteur dag, de mémoire négligeable, doit parcourir la
+      // colonie pour son empreinte : la population est bornée par la mémoire.
+      unsigned long long octets =
+          m->octets_par_algue > 0 ? m->octets_par_algue : 1;
+      if (actif[k] && (!s.exact || s.population > memoire / octets)) {
+        actif[k] = false;
+      }
+      if (!actif[k]) {
+        continue;
+      }
+      nb_actifs++;
+      mesure r;
+      long rss;
+      if (!mesurer(m, n, memoire, &r, &rss)) {
+        fprintf(stderr, "%s : échec à %u itérations\n", m->nom, n);
+        actif[k] = false;
+        continue;
+      }
+      printf("%s,%u,%llu,%.6f,%ld,%llu,%.3f,%016llx\n", m->nom, n,
+             r.population, r.secondes, rss, r.allocations,
+             r.algues_iterations == 0
+                 ? 0.0
+                 : r.secondes * 1e9 / (double)r.algues_iterations,
+             (unsigned long long)r.empreinte);
+      if (!reference) {
+        reference = true;
+        empreinte = r.empreinte;
+      } else if (r.empreinte != empreinte) {
+        fprintf(stderr, "%s : colonie différente à %u itérations\n", m->nom,
+                n);
+        identiques = false;
+      }
+    }
+    if (nb_actifs == 0) {
+      break;
+    }
+  }
+  return identiques ? EXIT_SUCCESS : EXIT_FAILURE;
+}
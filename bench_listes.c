@@ -0,0 +1,679 @@
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Mesure du coût des opérations d'un module de listes, comparé à un tableau
+ * dynamique d'entiers.
+ * Le programme est compilé une fois par module : avec BENCH_INT pour
+ * listes_int (et le tableau de référence), avec BENCH_POD pour les listes
+ * génériques d'entiers stockés dans les maillons, sans pour listes_generiques.
+ * Le résultat est un fichier CSV sur la sortie standard, une ligne par
+ * (module, opération, taille) avec la médiane et le 99e centile du temps par
+ * opération en nanosecondes.
+ * Le parcours est aussi mesuré sur une liste aux maillons dispersés dans le
+ * tas, avant et après sa compaction, et pour les listes génériques par 1, 2
+ * puis 4 lecteurs concurrents pendant qu'un écrivain la modifie.
+ * La destruction d'une liste est mesurée du point de vue de l'appelant, par
+ * liste_detruire puis par liste_detruire_differe.
+ * Les opérations ensemblistes de listes_int sont comparées à une
+ * intersection écrite avec deux courants.
+ * Le tri des listes génériques est comparé à une copie des valeurs dans un
+ * tableau trié par qsort puis recopié dans la liste.
+ */
+
+#ifdef BENCH_INT
+#include "listes_int.h"
+#define MODULE "listes_int"
+#define INSERER(inserer, l, v) inserer(l, v)
+/* les mesures sont écrites avec les noms des listes génériques */
+typedef liste_int liste;
+#define liste_insertion_debut liste_int_insertion_debut
+#define liste_insertion_fin liste_int_insertion_fin
+#define liste_insertion_apres liste_int_insertion_apres
+#define liste_suppression_debut liste_int_suppression_debut
+#define liste_suppression_fin liste_int_suppression_fin
+#define liste_suppression_apres liste_int_suppression_apres
+#define liste_courant_init liste_int_courant_init
+#define liste_courant_suivant liste_int_courant_suivant
+#define liste_decalage liste_int_decalage
+#define liste_valeur_courant liste_int_valeur_courant
+#define liste_affichage liste_int_affichage
+#define liste_detruire liste_int_detruire
+#define liste_compacter liste_int_compacter
+#define liste_detruire_differe liste_int_detruire_differe
+#define liste_destructions_attendre liste_int_destructions_attendre
+static liste bench_creer(void) { return liste_int_creer(); }
+#elif defined(BENCH_POD)
+#include "listes_generiques.h"
+#define MODULE "listes_generiques_pod"
+#define INSERER(inserer, l, v)                                                 \
+  do {                                                                         \
+    int v_ = (v);                                                              \
+    inserer(l, &v_);                                                           \
+  } while (0)
+static liste bench_creer(void) { return liste_creer_int(); }
+#else
+#include "listes_generiques.h"
+#define MODULE "listes_generiques"
+#define INSERER(inserer, l, v)                                                 \
+  do {                                                                         \
+    int v_ = (v);                                                              \
+    inserer(l, &v_);                                                           \
+  } while (0)
+
+static void copier_int(void *val, void **pt) {
+  *pt = malloc(sizeof(int));
+  memcpy(*pt, val, sizeof(int));
+}
+
+static void afficher_int(FILE *f, void *val) { fprintf(f, "%d ", *(int *)val); }
+
+static void detruire_int(void **pt) {
+  free(*pt);
+  *pt = NULL;
+}
+
+static liste bench_creer(void) {
+  return liste_creer(&copier_int, &afficher_int, &detruire_int);
+}
+#endif
+
+/* Échantillons non mesurés avant chaque série */
+#define ECHAUFFEMENT 3
+/* Nombre d'opérations en O(1) par échantillon */
+#define OPERATIONS 1000
+/* Taille au-delà de laquelle l'affichage n'est pas mesuré */
+#define AFFICHAGE_MAX 1000000
+
+/* Nombre d'échantillons mesurés par série */
+static unsigned int repetitions = 21;
+/* Destination des affichages mesurés */
+static FILE *nul;
+/* Empêche le compilateur de supprimer les parcours */
+static volatile long puits;
+
+/* Temps écoulé depuis debut, en nanosecondes. */
+static double ns_depuis(struct timespec const *debut) {
+  struct timespec fin;
+  clock_gettime(CLOCK_MONOTONIC, &fin);
+  return (double)(fin.tv_sec - debut->tv_sec) * 1e9 +
+         (double)(fin.tv_nsec - debut->tv_nsec);
+}
+
+static int comparer_doubles(void const *a, void const *b) {
+  double x = *(double const *)a, y = *(double const *)b;
+  return (x > y) - (x < y);
+}
+
+/* Trie les échantillons et écrit la ligne CSV de la série. */
+static void rapporter(char const *module, char const *operation,
+                      unsigned long taille, unsigned long operations,
+                      double *ns) {
+  qsort(ns, repetitions, sizeof(double), &comparer_doubles);
+  unsigned int p99 = (unsigned int)((repetitions * 99 + 99) / 100) - 1;
+  printf("%s,%s,%lu,%lu,%u,%.2f,%.2f\n", module, operation, taille,
+         operations, repetitions, ns[repetitions / 2], ns[p99]);
+}
+
+/*
+ * Une série : ECHAUFFEMENT puis repetitions appels à mesurer, qui renvoie le
+ * temps d'un échantillon de operations opérations.
+ */
+#define SERIE(module, operation, taille, operations, mesure)                   \
+  do {                                                                         \
+    double ns_[repetitions];                                                   \
+    for (unsigned int r_ = 0; r_ < ECHAUFFEMENT + repetitions; r_++) {         \
+      double t_ = (mesure) / (double)(operations);                             \
+      if (r_ >= ECHAUFFEMENT) {                                                \
+        ns_[r_ - ECHAUFFEMENT] = t_;                                           \
+      }                                                                        \
+    }                                                                          \
+    rapporter(module, operation, taille, operations, ns_);                     \
+  } while (0)
+
+/* Place le courant au milieu de la liste. */
+static void liste_milieu(liste l, unsigned long n) {
+  liste_courant_init(l);
+  liste_decalage(l, (int)(n / 2));
+}
+
+static double liste_insertion_debut_k(liste l, unsigned long k) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    INSERER(liste_insertion_debut, l, (int)i);
+  }
+  double ns = ns_depuis(&debut);
+  for (unsigned long i = 0; i < k; i++) {
+    liste_suppression_debut(l);
+  }
+  return ns;
+}
+
+static double liste_insertion_fin_k(liste l, unsigned long k) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    INSERER(liste_insertion_fin, l, (int)i);
+  }
+  double ns = ns_depuis(&debut);
+  for (unsigned long i = 0; i < k; i++) {
+    liste_suppression_fin(l);
+  }
+  return ns;
+}
+
+/* Le courant est au milieu : les insertions se font juste après lui. */
+static double liste_insertion_milieu_k(liste l, unsigned long k) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    INSERER(liste_insertion_apres, l, (int)i);
+  }
+  double ns = ns_depuis(&debut);
+  for (unsigned long i = 0; i < k; i++) {
+    liste_suppression_apres(l);
+  }
+  return ns;
+}
+
+static double liste_suppression_milieu_k(liste l, unsigned long k) {
+  for (unsigned long i = 0; i < k; i++) {
+    INSERER(liste_insertion_apres, l, (int)i);
+  }
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    liste_suppression_apres(l);
+  }
+  return ns_depuis(&debut);
+}
+
+static double liste_parcours_n(liste l, unsigned long n) {
+  struct timespec debut;
+  long somme = 0;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_courant_init(l);
+  for (unsigned long i = 0; i < n; i++) {
+#ifdef BENCH_INT
+    somme += liste_valeur_courant(l);
+#else
+    somme += *(int *)liste_valeur_courant(l);
+#endif
+    liste_courant_suivant(l);
+  }
+  double ns = ns_depuis(&debut);
+  puits = somme;
+  return ns;
+}
+
+static double liste_decalage_n(liste l, unsigned long n) {
+  struct timespec debut;
+  liste_courant_init(l);
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_decalage(l, (int)n);
+  return ns_depuis(&debut);
+}
+
+static double liste_affichage_n(liste l) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_affichage(nul, l);
+  fflush(nul);
+  return ns_depuis(&debut);
+}
+
+/* Mesure toutes les opérations du module sur une liste de n entiers. */
+static void mesurer_liste(unsigned long n) {
+  liste l = bench_creer();
+  for (unsigned long i = 0; i < n; i++) {
+    INSERER(liste_insertion_fin, l, (int)i);
+  }
+  SERIE(MODULE, "insertion_debut", n, OPERATIONS,
+        liste_insertion_debut_k(l, OPERATIONS));
+  SERIE(MODULE, "insertion_fin", n, OPERATIONS,
+        liste_insertion_fin_k(l, OPERATIONS));
+  liste_milieu(l, n);
+  SERIE(MODULE, "insertion_milieu", n, OPERATIONS,
+        liste_insertion_milieu_k(l, OPERATIONS));
+  liste_milieu(l, n);
+  SERIE(MODULE, "suppression_milieu", n, OPERATIONS,
+        liste_suppression_milieu_k(l, OPERATIONS));
+  SERIE(MODULE, "parcours", n, n, liste_parcours_n(l, n));
+  SERIE(MODULE, "decalage", n, n, liste_decalage_n(l, n));
+  if (n <= AFFICHAGE_MAX) {
+    SERIE(MODULE, "affichage", n, n, liste_affichage_n(l));
+  }
+  liste_detruire(&l);
+}
+
+/*
+ * Construit une liste de n entiers aux maillons dispersés : chaque insertion
+ * se fait après un courant avancé de 0 à 7 positions, si bien que des
+ * éléments voisins dans le parcours ont été alloués à des moments éloignés.
+ */
+static liste liste_fragmentee(unsigned long n) {
+  unsigned long long x = 88172645463325252ULL;
+  liste l = bench_creer();
+  INSERER(liste_insertion_fin, l, 0);
+  liste_courant_init(l);
+  for (unsigned long i = 1; i < n; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    liste_decalage(l, (int)(x & 7));
+    INSERER(liste_insertion_apres, l, (int)i);
+  }
+  return l;
+}
+
+static double liste_compacter_n(liste l) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_compacter(l);
+  return ns_depuis(&debut);
+}
+
+/* Parcours d'une liste fragmentée, puis de la même une fois compactée. */
+static void mesurer_compactage(unsigned long n) {
+  liste l = liste_fragmentee(n);
+  SERIE(MODULE, "parcours_fragmente", n, n, liste_parcours_n(l, n));
+  liste_compacter(l);
+  SERIE(MODULE, "parcours_compacte", n, n, liste_parcours_n(l, n));
+  SERIE(MODULE, "compactage", n, n, liste_compacter_n(l));
+  liste_detruire(&l);
+}
+
+/*
+ * Temps de destruction d'une liste de n entiers vu par l'appelant, avec
+ * liste_detruire ou liste_detruire_differe ; la destruction différée est
+ * achevée hors mesure.
+ */
+static double liste_destruction_n(unsigned long n, bool differee) {
+  liste l = bench_creer();
+  for (unsigned long i = 0; i < n; i++) {
+    INSERER(liste_insertion_fin, l, (int)i);
+  }
+  liste_courant_init(l);
+  INSERER(liste_insertion_apres, l, -1);
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  if (differee) {
+    liste_detruire_differe(&l);
+  } else {
+    liste_detruire(&l);
+  }
+  double ns = ns_depuis(&debut);
+  liste_destructions_attendre();
+  return ns;
+}
+
+static void mesurer_destruction(unsigned long n) {
+  SERIE(MODULE, "destruction", n, n, liste_destruction_n(n, false));
+  SERIE(MODULE, "destruction_differee", n, n, liste_destruction_n(n, true));
+}
+
+#ifndef BENCH_INT
+static int comparer_int(void const *a, void const *b) {
+  return (*(int const *)a > *(int const *)b) -
+         (*(int const *)a < *(int const *)b);
+}
+
+/* Donne des valeurs aléatoires aux n éléments de la liste. */
+static void liste_melanger(liste l, unsigned long n) {
+  static unsigned long long x = 88172645463325252ULL;
+  liste_courant_init(l);
+  for (unsigned long i = 0; i < n; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *(int *)liste_valeur_courant(l) = (int)(x >> 33);
+    liste_courant_suivant(l);
+  }
+}
+
+static double liste_tri_n(liste l, unsigned long n) {
+  liste_melanger(l, n);
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_trier(l, &comparer_int);
+  return ns_depuis(&debut);
+}
+
+/* Tri par copie des valeurs dans un tableau, qsort et recopie. */
+static double liste_tri_copie_n(liste l, unsigned long n) {
+  liste_melanger(l, n);
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  int *valeurs = malloc(n * sizeof(int));
+  assert(valeurs != NULL);
+  liste_courant_init(l);
+  for (unsigned long i = 0; i < n; i++) {
+    valeurs[i] = *(int *)liste_valeur_courant(l);
+    liste_courant_suivant(l);
+  }
+  qsort(valeurs, n, sizeof(int), &comparer_int);
+  liste_courant_init(l);
+  for (unsigned long i = 0; i < n; i++) {
+    *(int *)liste_valeur_courant(l) = valeurs[i];
+    liste_courant_suivant(l);
+  }
+  free(valeurs);
+  return ns_depuis(&debut);
+}
+
+/* Tri d'une liste de n entiers aléatoires. */
+static void mesurer_tri(unsigned long n) {
+  liste l = bench_creer();
+  for (unsigned long i = 0; i < n; i++) {
+    INSERER(liste_insertion_fin, l, (int)i);
+  }
+  SERIE(MODULE, "tri", n, n, liste_tri_n(l, n));
+  SERIE(MODULE, "tri_copie", n, n, liste_tri_copie_n(l, n));
+  liste_detruire(&l);
+}
+
+/* Taille minimale des listes lues par des lecteurs concurrents */
+#define LECTURE_CONCURRENTE_MIN 10000
+
+/* Liste partagée par l'écrivain et les lecteurs d'un échantillon. */
+typedef struct partage {
+  liste l;
+  unsigned long n;
+  volatile int fin; /* demande d'arrêt de l'écrivain */
+} partage;
+
+/*
+ * Écrivain : insère et supprime sans cesse après le courant, placé au milieu.
+ * Des insertions en fin pourraient allonger indéfiniment les parcours.
+ */
+static void *ecrire(void *arg) {
+  partage *p = arg;
+  int v = 0;
+  while (!p->fin) {
+    INSERER(liste_insertion_apres, p->l, v++);
+    liste_suppression_apres(p->l);
+  }
+  return NULL;
+}
+
+/* Lecteur : un parcours complet de la liste. */
+static void *lire(void *arg) {
+  partage *p = arg;
+  lecteur r = liste_lecteur_creer(p->l);
+  long somme = 0;
+  liste_lecture_debut(r);
+  for (int *v = liste_lecture_premier(r); v != NULL;
+       v = liste_lecture_suivant(r)) {
+    somme += *v;
+  }
+  liste_lecture_fin(r);
+  liste_lecteur_detruire(&r);
+  puits = somme;
+  return NULL;
+}
+
+/* k lecteurs parcourent chacun la liste pendant que l'écrivain la modifie. */
+static double liste_lecture_concurrente(partage *p, unsigned int k) {
+  pthread_t ecrivain, lecteurs[4];
+  struct timespec debut;
+  p->fin = 0;
+  pthread_create(&ecrivain, NULL, &ecrire, p);
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned int i = 0; i < k; i++) {
+    pthread_create(&lecteurs[i], NULL, &lire, p);
+  }
+  for (unsigned int i = 0; i < k; i++) {
+    pthread_join(lecteurs[i], NULL);
+  }
+  double ns = ns_depuis(&debut);
+  p->fin = 1;
+  pthread_join(ecrivain, NULL);
+  return ns;
+}
+
+/*
+ * Temps par élément lu, tous lecteurs confondus : il diminue avec le nombre
+ * de lecteurs tant que la lecture passe à l'échelle.
+ */
+static void mesurer_lecture_concurrente(unsigned long n) {
+  partage p = {bench_creer(), n, 0};
+  for (unsigned long i = 0; i < n; i++) {
+    INSERER(liste_insertion_fin, p.l, (int)i);
+  }
+  liste_milieu(p.l, n);
+  liste_concurrente(p.l, true);
+  SERIE(MODULE, "lecture_concurrente_1", n, n,
+        liste_lecture_concurrente(&p, 1));
+  SERIE(MODULE, "lecture_concurrente_2", n, 2 * n,
+        liste_lecture_concurrente(&p, 2));
+  SERIE(MODULE, "lecture_concurrente_4", n, 4 * n,
+        liste_lecture_concurrente(&p, 4));
+  liste_concurrente(p.l, false);
+  liste_detruire(&p.l);
+}
+#else
+/* Tableau dynamique d'entiers, référence des mesures. */
+typedef struct tableau {
+  int *valeurs;
+  unsigned long taille;
+  unsigned long capacite;
+} tableau;
+
+static void tableau_inserer(tableau *t, unsigned long position, int v) {
+  if (t->taille == t->capacite) {
+    t->capacite = t->capacite == 0 ? 16 : 2 * t->capacite;
+    t->valeurs = realloc(t->valeurs, t->capacite * sizeof(int));
+    assert(t->valeurs != NULL);
+  }
+  memmove(t->valeurs + position + 1, t->valeurs + position,
+          (t->taille - position) * sizeof(int));
+  t->valeurs[position] = v;
+  t->taille++;
+}
+
+static void tableau_supprimer(tableau *t, unsigned long position) {
+  memmove(t->valeurs + position, t->valeurs + position + 1,
+          (t->taille - position - 1) * sizeof(int));
+  t->taille--;
+}
+
+/* Insertions de k valeurs à une position fixe, puis retour à la taille n. */
+static double tableau_insertion_k(tableau *t, unsigned long position,
+                                  unsigned long k) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    tableau_inserer(t, position, (int)i);
+  }
+  double ns = ns_depuis(&debut);
+  t->taille -= k;
+  return ns;
+}
+
+static double tableau_suppression_k(tableau *t, unsigned long position,
+                                    unsigned long k) {
+  for (unsigned long i = 0; i < k; i++) {
+    tableau_inserer(t, t->taille, (int)i);
+  }
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < k; i++) {
+    tableau_supprimer(t, position);
+  }
+  return ns_depuis(&debut);
+}
+
+static double tableau_parcours(tableau const *t) {
+  struct timespec debut;
+  long somme = 0;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (unsigned long i = 0; i < t->taille; i++) {
+    somme += t->valeurs[i];
+  }
+  double ns = ns_depuis(&debut);
+  puits = somme;
+  return ns;
+}
+
+/* Le décalage d'une position dans un tableau est un simple calcul d'indice */
+static double tableau_decalage(tableau const *t, unsigned long n) {
+  struct timespec debut;
+  volatile unsigned long position = 0;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  position = (position + n) % t->taille;
+  return ns_depuis(&debut);
+}
+
+static double tableau_affichage(tableau const *t) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  fprintf(nul, "Liste de %lu éléments : [ ", t->taille);
+  for (unsigned long i = 0; i < t->taille; i++) {
+    fprintf(nul, "%d ", t->valeurs[i]);
+  }
+  fprintf(nul, "]");
+  fflush(nul);
+  return ns_depuis(&debut);
+}
+
+/* Mesure les mêmes opérations sur un tableau dynamique de n entiers. */
+static void mesurer_tableau(unsigned long n) {
+  tableau t = {NULL, 0, 0};
+  for (unsigned long i = 0; i < n; i++) {
+    tableau_inserer(&t, t.taille, (int)i);
+  }
+  // Une insertion en tête ou au milieu déplace O(n) entiers : le nombre
+  // d'opérations par échantillon est réduit pour les grandes tailles.
+  unsigned long k = 10000000 / n;
+  k = k < 1 ? 1 : k > OPERATIONS ? OPERATIONS : k;
+  SERIE("tableau", "insertion_debut", n, k, tableau_insertion_k(&t, 0, k));
+  SERIE("tableau", "insertion_fin", n, OPERATIONS,
+        tableau_insertion_k(&t, n, OPERATIONS));
+  SERIE("tableau", "insertion_milieu", n, k,
+        tableau_insertion_k(&t, n / 2 + 1, k));
+  SERIE("tableau", "suppression_milieu", n, k,
+        tableau_suppression_k(&t, n / 2 + 1, k));
+  SERIE("tableau", "parcours", n, n, tableau_parcours(&t));
+  SERIE("tableau", "decalage", n, n, tableau_decalage(&t, n));
+  if (n <= AFFICHAGE_MAX) {
+    SERIE("tableau", "affichage", n, n, tableau_affichage(&t));
+  }
+  free(t.valeurs);
+}
+/* Ensemble des multiples de pas, de n éléments. */
+static liste_int ensemble_multiples(unsigned long n, int pas) {
+  liste_int l = liste_int_creer();
+  for (unsigned long i = 0; i < n; i++) {
+    liste_int_insertion_fin(l, (int)i * pas);
+  }
+  return l;
+}
+
+static double ensemble_intersection(liste_int a, liste_int b) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_int i = liste_int_intersection(a, b);
+  double ns = ns_depuis(&debut);
+  liste_int_detruire(&i);
+  return ns;
+}
+
+static double ensemble_union(liste_int a, liste_int b) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_int u = liste_int_union(a, b);
+  double ns = ns_depuis(&debut);
+  liste_int_detruire(&u);
+  return ns;
+}
+
+/* Intersection écrite avec deux courants, référence des mesures. */
+static double ensemble_intersection_courants(liste_int a, liste_int b) {
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  liste_int i = liste_int_creer();
+  int na = liste_int_taille(a), nb = liste_int_taille(b);
+  liste_int_courant_init(a);
+  liste_int_courant_init(b);
+  while (na > 0 && nb > 0) {
+    int x = liste_int_valeur_courant(a), y = liste_int_valeur_courant(b);
+    if (x == y) {
+      liste_int_insertion_fin(i, x);
+    }
+    if (x <= y) {
+      liste_int_courant_suivant(a);
+      na--;
+    }
+    if (y <= x) {
+      liste_int_courant_suivant(b);
+      nb--;
+    }
+  }
+  double ns = ns_depuis(&debut);
+  liste_int_detruire(&i);
+  return ns;
+}
+
+/*
+ * Opérations ensemblistes sur des ensembles de n éléments, puis d'un
+ * ensemble de n / 256 éléments avec un de n : le nombre d'opérations est le
+ * nombre total d'éléments en entrée.
+ */
+static void mesurer_ensembles(unsigned long n) {
+  liste_int a = ensemble_multiples(n, 2);
+  liste_int b = ensemble_multiples(n, 3);
+  liste_int petit = ensemble_multiples(n / 256 + 1, 512);
+  SERIE(MODULE, "intersection", n, 2 * n, ensemble_intersection(a, b));
+  SERIE(MODULE, "intersection_courants", n, 2 * n,
+        ensemble_intersection_courants(a, b));
+  SERIE(MODULE, "union", n, 2 * n, ensemble_union(a, b));
+  SERIE(MODULE, "intersection_petit", n, n + n / 256 + 1,
+        ensemble_intersection(petit, b));
+  SERIE(MODULE, "intersection_petit_courants", n, n + n / 256 + 1,
+        ensemble_intersection_courants(petit, b));
+  liste_int_detruire(&a);
+  liste_int_detruire(&b);
+  liste_int_detruire(&petit);
+}
+
+#endif
+
+int main(int argc, char *argv[]) {
+  unsigned long taille_max = 1000000;
+  if (argc > 1) {
+    taille_max = strtoul(argv[1], NULL, 10);
+  }
+  if (argc > 2) {
+    repetitions = (unsigned int)strtoul(argv[2], NULL, 10);
+  }
+  if (argc > 3 || taille_max < 10 || repetitions == 0) {
+    fprintf(stderr, "usage : %s [TAILLE_MAX [REPETITIONS]]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  nul = fopen("/dev/null", "w");
+  assert(nul != NULL);
+  printf("module,operation,taille,operations,repetitions,mediane_ns,p99_ns\n");
+  for (unsigned long n = 10; n <= taille_max; n *= 10) {
+    mesurer_liste(n);
+    mesurer_compactage(n);
+    mesurer_destruction(n);
+#ifdef BENCH_INT
+    mesurer_tableau(n);
+    mesurer_ensembles(n);
+#else
+    mesurer_tri(n);
+    if (n >= LECTURE_CONCURRENTE_MIN) {
+      mesurer_lecture_concurrente(n);
+    }
+#endif
+    fflush(stdout);
+  }
+  fclose(nul);
+  return 0;
+}
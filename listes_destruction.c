@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include "listes_destruction.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <time.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Débit par défaut de la destruction différée, en maillons par
+ * seconde. */
+#define DESTRUCTION_DEBIT_DEFAUT 20000000UL
+
+/*!
+ * \brief File des listes en attente et son thread. debut n'est utilisé que
+ * par le thread.
+ */
+static struct {
+  destruction_attente *file; /* listes en attente, chaînées par suivante */
+  bool en_cours;         /* une liste retirée de la file est en destruction */
+  bool demarree;         /* le thread a été démarré */
+  unsigned long debit;   /* maillons par seconde, 0 sans limite */
+  unsigned int attentes; /* appels de listes_destructions_attendre en cours :
+                            le débit n'est plus limité */
+  struct timespec debut; /* fin de la dernière pause */
+  pthread_mutex_t verrou;
+  pthread_cond_t travail; /* une liste a été ajoutée à la file */
+  pthread_cond_t fini;    /* la file est vide et aucune liste en cours */
+} destruction = {NULL,
+                 false,
+                 false,
+                 DESTRUCTION_DEBIT_DEFAUT,
+                 0,
+                 {0, 0},
+                 PTHREAD_MUTEX_INITIALIZER,
+                 PTHREAD_COND_INITIALIZER,
+                 PTHREAD_COND_INITIALIZER};
+
+void listes_destruction_lot(unsigned long nb) {
+  unsigned long debit = __atomic_load_n(&destruction.debit, __ATOMIC_RELAXED);
+  struct timespec *debut = &destruction.debut;
+  struct timespec fin;
+  clock_gettime(CLOCK_MONOTONIC, &fin);
+  if (debit != 0 &&
+      __atomic_load_n(&destruction.attentes, __ATOMIC_RELAXED) == 0) {
+    long long prevu = (long long)(nb * 1e9 / debit);
+    long long ecoule = (fin.tv_sec - debut->tv_sec) * 1000000000LL +
+                       (fin.tv_nsec - debut->tv_nsec);
+    if (ecoule < prevu) {
+      struct timespec pause = {(time_t)((prevu - ecoule) / 1000000000LL),
+                               (long)((prevu - ecoule) % 1000000000LL)};
+      nanosleep(&pause, NULL);
+      clock_gettime(CLOCK_MONOTONIC, &fin);
+    }
+  }
+  *debut = fin;
+}
+
+/*! \brief Thread de la destruction différée, qui vide la file. */
+static void *destruction_boucle(void *arg) {
+  (void)arg;
+  pthread_mutex_lock(&destruction.verrou);
+  for (;;) {
+    while (destruction.file == NULL) {
+      pthread_cond_wait(&destruction.travail, &destruction.verrou);
+    }
+    destruction_attente *a = destruction.file;
+    destruction.file = a->suivante;
+    destruction.en_cours = true;
+    pthread_mutex_unlock(&destruction.verrou);
+    clock_gettime(CLOCK_MONOTONIC, &destruction.debut);
+    a->liberer(a->liste);
+    pthread_mutex_lock(&destruction.verrou);
+    destruction.en_cours = false;
+    if (destruction.file == NULL) {
+      pthread_cond_broadcast(&destruction.fini);
+    }
+  }
+  return NULL;
+}
+
+bool listes_destruction_confier(destruction_attente *a) {
+  assert(a != NULL && a->liste != NULL && a->liberer != NULL);
+  pthread_mutex_lock(&destruction.verrou);
+  if (!destruction.demarree) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, &destruction_boucle, NULL) != 0) {
+      pthread_mutex_unlock(&destruction.verrou);
+      return false;
+    }
+    pthread_detach(thread);
+    destruction.demarree = true;
+  }
+  a->suivante = destruction.file;
+  destruction.file = a;
+  pthread_cond_signal(&destruction.travail);
+  pthread_mutex_unlock(&destruction.verrou);
+  return true;
+}
+
+void listes_destructions_attendre(void) {
+  pthread_mutex_lock(&destruction.verrou);
+  __atomic_add_fetch(&destruction.attentes, 1, __ATOMIC_RELAXED);
+  while (destruction.file != NULL || destruction.en_cours) {
+    pthread_cond_wait(&destruction.fini, &destruction.verrou);
+  }
+  __atomic_sub_fetch(&destruction.attentes, 1, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&destruction.verrou);
+}
+
+void listes_destruction_debit(unsigned long maillons_par_seconde) {
+  __atomic_store_n(&destruction.debit, maillons_par_seconde, __ATOMIC_RELAXED);
+}
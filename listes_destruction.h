@@ -0,0 +1,63 @@
+#ifndef LISTES_DESTRUCTION
+#define LISTES_DESTRUCTION
+
+#include <stdbool.h>
+
+/*! \file
+ * \brief Module de destruction différée des listes.
+ *
+ * Les listes de listes_int et de listes_generiques confiées à leur
+ * destruction différée attendent dans une seule file, vidée par un seul
+ * thread démarré au premier appel. Chaque module fournit la fonction qui
+ * libère ses listes ; elle signale ses maillons libérés par lots, et le
+ * débit commun aux deux modules est limité entre les lots.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Maillons libérés entre deux pauses de la destruction différée. */
+#define DESTRUCTION_LOT 16384
+
+/*!
+ * \brief Place d'une liste dans la file de destruction, dans la structure
+ * même de la liste : la confier ne demande aucune allocation.
+ */
+typedef struct destruction_attente {
+  void *liste;                           /* liste à libérer */
+  void (*liberer)(void *liste);          /* libère la liste et ses maillons */
+  struct destruction_attente *suivante;  /* suivante dans la file */
+} destruction_attente;
+
+/*!
+ * \brief Ajoute une liste à la file, en démarrant le thread au premier appel.
+ * \param a place de la liste, dont liste et liberer sont renseignés ; elle
+ * doit rester valide jusqu'à l'appel de liberer.
+ * \return false si le thread n'a pas pu être démarré : la liste n'est pas
+ * dans la file et doit être détruite tout de suite.
+ */
+bool listes_destruction_confier(destruction_attente *a);
+
+/*!
+ * \brief Appelée par les fonctions liberer après chaque lot de
+ * DESTRUCTION_LOT maillons : attend, si le débit est limité et que personne
+ * n'attend la fin des destructions, que le lot ait pris le temps prévu par le
+ * débit depuis le lot précédent ou le début de la liste.
+ * \param nb maillons libérés depuis l'appel précédent.
+ */
+void listes_destruction_lot(unsigned long nb);
+
+/*!
+ * \brief Attend que toutes les listes de la file soient libérées ; pendant
+ * l'attente, le débit n'est plus limité.
+ */
+void listes_destructions_attendre(void);
+
+/*!
+ * \brief Débit maximal commun aux deux modules, 20 millions de maillons par
+ * seconde par défaut.
+ * \param maillons_par_seconde nouveau débit, 0 pour ne pas le limiter.
+ */
+void listes_destruction_debit(unsigned long maillons_par_seconde);
+
+#endif
@@ -0,0 +1,820 @@
+#define _POSIX_C_SOURCE 200809L
+#include "listes_externes.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Taille maximale d'un segment en octets. */
+#define SEGMENT_OCTETS (1024 * 1024)
+/*! \brief Nombre minimal de segments en mémoire, écritures comprises. */
+#define TAMPONS_MIN 8
+/*! \brief Segments du budget laissés aux écritures en cours. */
+#define TAMPONS_ECRITURE 2
+/*! \brief Budget par défaut en octets. */
+#define BUDGET_DEFAUT ((size_t)64 * 1024 * 1024)
+
+/*! \brief État d'un segment, lu sans verrou par le thread principal. */
+#define ETAT(s) __atomic_load_n(&(s)->etat, __ATOMIC_ACQUIRE)
+/*! \brief Changement d'état d'un segment. */
+#define ETAT_FIXER(s, v) __atomic_store_n(&(s)->etat, (v), __ATOMIC_RELEASE)
+
+/*!
+ * \brief Où se trouvent les valeurs d'un segment. Seul le thread
+ * d'entrées-sorties fait passer un segment de SEGMENT_LECTURE à
+ * SEGMENT_PRESENT et de SEGMENT_ECRITURE à SEGMENT_DISQUE ; tous les autres
+ * changements sont faits par le thread principal.
+ */
+typedef enum segment_etat {
+  SEGMENT_DISQUE,  /* seulement dans le fichier */
+  SEGMENT_LECTURE, /* en cours de lecture anticipée */
+  SEGMENT_PRESENT, /* en mémoire */
+  SEGMENT_ECRITURE /* évincé, en cours d'écriture dans le fichier */
+} segment_etat;
+
+/*!
+ * \brief Segment de valeurs consécutives de la liste. Les places libres du
+ * segment forment un trou à l'endroit de la dernière insertion ou
+ * suppression : les valeurs d'indice au moins trou sont rangées à la fin du
+ * tampon. Insérer derrière le courant pendant un parcours ne déplace ainsi
+ * que les valeurs dépassées depuis l'insertion précédente.
+ * Les segments en mémoire ou en cours de lecture sont chaînés du plus
+ * récemment utilisé au plus ancien (LRU) par le seul thread principal.
+ */
+typedef struct segment {
+  char *donnees;         /* valeurs, NULL si le segment est sur le disque */
+  unsigned int nb;       /* nombre de valeurs */
+  unsigned int trou;     /* indice du début du trou, au plus nb */
+  long emplacement;      /* emplacement dans le fichier, -1 s'il n'en a pas */
+  segment_etat etat;     /* accédé par ETAT et ETAT_FIXER */
+  bool modifie;          /* différent de sa copie dans le fichier */
+  unsigned int epingle;  /* le segment ne peut pas être évincé si non nul */
+  bool dans_lru;         /* chaîné par recent et ancien */
+  struct segment *recent; /* voisin plus récemment utilisé */
+  struct segment *ancien; /* voisin moins récemment utilisé */
+  struct segment *file;   /* suivant dans la file des entrées-sorties */
+} segment;
+
+/*! \brief Place d'une valeur : son segment et son indice dans le segment. */
+typedef struct position {
+  size_t segment;
+  unsigned int indice;
+} position;
+
+/*!
+ * \brief Les segments sont rangés dans l'ordre de la liste dans un tableau
+ * qui ne contient que leurs descripteurs ; un segment vidé est retiré.
+ * Les champs après verrou sont partagés avec le thread d'entrées-sorties.
+ */
+struct externe_struct {
+  size_t taille_valeur;
+  unsigned int capacite; /* valeurs par segment */
+  size_t octets;         /* taille d'un segment : capacite * taille_valeur */
+  segment **segments;
+  size_t nb_segments;
+  size_t max_segments; /* taille du tableau segments */
+  size_t taille;       /* nombre de valeurs */
+  bool a_courant;
+  position courant;
+  int fd;        /* fichier de débordement */
+  long *libres;  /* emplacements du fichier rendus par des segments retirés */
+  size_t nb_libres;
+  size_t max_libres;
+  long nb_emplacements;     /* emplacements utilisés au moins une fois */
+  segment *recent;          /* tête du LRU */
+  segment *ancien;          /* queue du LRU, le premier évincé */
+  unsigned long long nb_allocations;
+  bool thread_lance;        /* sinon les entrées-sorties sont synchrones */
+  pthread_t thread;
+  pthread_mutex_t verrou;
+  size_t max_tampons;  /* segments en mémoire permis par le budget */
+  size_t nb_tampons;   /* segments en mémoire, écritures comprises */
+  size_t nb_ecritures; /* segments en cours d'écriture */
+  segment *file_tete;  /* entrées-sorties demandées */
+  segment *file_queue;
+  bool fin;                /* le thread doit s'arrêter */
+  pthread_cond_t travail;  /* une entrée-sortie a été demandée */
+  pthread_cond_t fait;     /* une entrée-sortie est terminée */
+};
+
+/*!
+ * \brief Lit ou écrit entièrement un segment à son emplacement ; une erreur
+ * du fichier est fatale, comme une allocation qui échoue.
+ */
+static void transferer(externe e, segment *s, bool lecture) {
+  off_t debut = (off_t)s->emplacement * (off_t)e->octets;
+  size_t fait = 0;
+  while (fait < e->octets) {
+    ssize_t n = lecture ? pread(e->fd, s->donnees + fait, e->octets - fait,
+                                debut + (off_t)fait)
+                        : pwrite(e->fd, s->donnees + fait, e->octets - fait,
+                                 debut + (off_t)fait);
+    if (n <= 0) {
+      abort();
+    }
+    fait += (size_t)n;
+  }
+}
+
+/*!
+ * \brief Fin d'une entrée-sortie, sous le verrou : un segment écrit libère
+ * sa mémoire.
+ */
+static void transfert_fini(externe e, segment *s) {
+  if (ETAT(s) == SEGMENT_ECRITURE) {
+    free(s->donnees);
+    s->donnees = NULL;
+    e->nb_ecritures--;
+    e->nb_tampons--;
+    ETAT_FIXER(s, SEGMENT_DISQUE);
+  } else {
+    ETAT_FIXER(s, SEGMENT_PRESENT);
+  }
+  pthread_cond_broadcast(&e->fait);
+}
+
+/*! \brief Boucle du thread d'entrées-sorties. */
+static void *entrees_sorties(void *arg) {
+  externe e = arg;
+  pthread_mutex_lock(&e->verrou);
+  for (;;) {
+    while (e->file_tete == NULL && !e->fin) {
+      pthread_cond_wait(&e->travail, &e->verrou);
+    }
+    if (e->file_tete == NULL) {
+      break;
+    }
+    segment *s = e->file_tete;
+    e->file_tete = s->file;
+    if (e->file_tete == NULL) {
+      e->file_queue = NULL;
+    }
+    bool lecture = ETAT(s) == SEGMENT_LECTURE;
+    pthread_mutex_unlock(&e->verrou);
+    transferer(e, s, lecture);
+    pthread_mutex_lock(&e->verrou);
+    transfert_fini(e, s);
+  }
+  pthread_mutex_unlock(&e->verrou);
+  return NULL;
+}
+
+/*!
+ * \brief Confie au thread, sous le verrou, la lecture ou l'écriture d'un
+ * segment selon son état ; sans thread, elle est faite tout de suite.
+ */
+static void transfert_demander(externe e, segment *s) {
+  if (!e->thread_lance) {
+    transferer(e, s, ETAT(s) == SEGMENT_LECTURE);
+    transfert_fini(e, s);
+    return;
+  }
+  s->file = NULL;
+  if (e->file_queue != NULL) {
+    e->file_queue->file = s;
+  } else {
+    e->file_tete = s;
+  }
+  e->file_queue = s;
+  pthread_cond_signal(&e->travail);
+}
+
+/*! \brief Attend, sous le verrou, que le segment n'ait plus de transfert. */
+static void transfert_attendre(externe e, segment *s) {
+  while (ETAT(s) == SEGMENT_LECTURE || ETAT(s) == SEGMENT_ECRITURE) {
+    pthread_cond_wait(&e->fait, &e->verrou);
+  }
+}
+
+/*! \brief Retire un segment du LRU s'il y est. */
+static void lru_retirer(externe e, segment *s) {
+  if (!s->dans_lru) {
+    return;
+  }
+  if (s->recent != NULL) {
+    s->recent->ancien = s->ancien;
+  } else {
+    e->recent = s->ancien;
+  }
+  if (s->ancien != NULL) {
+    s->ancien->recent = s->recent;
+  } else {
+    e->ancien = s->recent;
+  }
+  s->dans_lru = false;
+}
+
+/*! \brief Place un segment en tête du LRU. */
+static void lru_toucher(externe e, segment *s) {
+  if (e->recent == s) {
+    return;
+  }
+  lru_retirer(e, s);
+  s->recent = NULL;
+  s->ancien = e->recent;
+  if (e->recent != NULL) {
+    e->recent->recent = s;
+  } else {
+    e->ancien = s;
+  }
+  e->recent = s;
+  s->dans_lru = true;
+}
+
+/*! \brief Emplacement libre du fichier pour un segment. */
+static long emplacement_prendre(externe e) {
+  if (e->nb_libres > 0) {
+    return e->libres[--e->nb_libres];
+  }
+  return e->nb_emplacements++;
+}
+
+/*! \brief Rend l'emplacement d'un segment retiré. */
+static void emplacement_rendre(externe e, long emplacement) {
+  if (e->nb_libres == e->max_libres) {
+    e->max_libres = e->max_libres == 0 ? 16 : 2 * e->max_libres;
+    e->libres = realloc(e->libres, e->max_libres * sizeof(long));
+    assert(e->libres != NULL);
+  }
+  e->libres[e->nb_libres++] = emplacement;
+}
+
+/*!
+ * \brief Évince, sous le verrou, un segment en mémoire : il est libéré s'il
+ * est identique à sa copie, confié au thread pour être écrit sinon.
+ */
+static void segment_evincer(externe e, segment *s) {
+  lru_retirer(e, s);
+  if (!s->modifie) {
+    free(s->donnees);
+    s->donnees = NULL;
+    e->nb_tampons--;
+    ETAT_FIXER(s, SEGMENT_DISQUE);
+    return;
+  }
+  if (s->emplacement < 0) {
+    s->emplacement = emplacement_prendre(e);
+  }
+  s->modifie = false;
+  e->nb_ecritures++;
+  ETAT_FIXER(s, SEGMENT_ECRITURE);
+  transfert_demander(e, s);
+}
+
+/*!
+ * \brief Mémoire d'un segment à charger ou à créer. Les segments les moins
+ * récemment utilisés sont évincés pour rester dans le budget, quelques
+ * places étant laissées aux écritures en cours.
+ * \param e stockage.
+ * \param attendre faux pour une lecture anticipée, qui est abandonnée plutôt
+ * que d'attendre la fin d'une écriture.
+ * \return la mémoire, NULL si attendre est faux et le budget atteint.
+ */
+static char *tampon_reserver(externe e, bool attendre) {
+  pthread_mutex_lock(&e->verrou);
+  while (e->nb_tampons - e->nb_ecritures + TAMPONS_ECRITURE >=
+         e->max_tampons) {
+    segment *victime = e->ancien;
+    while (victime != NULL &&
+           (ETAT(victime) != SEGMENT_PRESENT || victime->epingle > 0)) {
+      victime = victime->recent;
+    }
+    if (victime == NULL) {
+      break;
+    }
+    segment_evincer(e, victime);
+  }
+  while (attendre && e->nb_tampons >= e->max_tampons && e->nb_ecritures > 0) {
+    pthread_cond_wait(&e->fait, &e->verrou);
+  }
+  if (!attendre && e->nb_tampons >= e->max_tampons) {
+    pthread_mutex_unlock(&e->verrou);
+    return NULL;
+  }
+  /* tous les segments peuvent être épinglés : le budget est alors dépassé */
+  e->nb_tampons++;
+  e->nb_allocations++;
+  pthread_mutex_unlock(&e->verrou);
+  char *tampon = malloc(e->octets);
+  assert(tampon != NULL);
+  return tampon;
+}
+
+/*!
+ * \brief Met un segment en mémoire, en attendant sa lecture anticipée ou en
+ * le lisant.
+ * \return ses valeurs.
+ */
+static char *segment_charger(externe e, segment *s) {
+  if (ETAT(s) != SEGMENT_PRESENT) {
+    pthread_mutex_lock(&e->verrou);
+    transfert_attendre(e, s);
+    pthread_mutex_unlock(&e->verrou);
+    if (ETAT(s) == SEGMENT_DISQUE) {
+      s->donnees = tampon_reserver(e, true);
+      transferer(e, s, true);
+      s->modifie = false;
+      ETAT_FIXER(s, SEGMENT_PRESENT);
+    }
+  }
+  lru_toucher(e, s);
+  return s->donnees;
+}
+
+/*!
+ * \brief Demande la lecture anticipée du segment d'indice i s'il est sur le
+ * disque et que le budget le permet.
+ */
+static void segment_precharger(externe e, size_t i) {
+  if (i >= e->nb_segments) {
+    return;
+  }
+  segment *s = e->segments[i];
+  if (ETAT(s) != SEGMENT_DISQUE) {
+    return;
+  }
+  char *tampon = tampon_reserver(e, false);
+  if (tampon == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&e->verrou);
+  s->donnees = tampon;
+  s->modifie = false;
+  ETAT_FIXER(s, SEGMENT_LECTURE);
+  transfert_demander(e, s);
+  pthread_mutex_unlock(&e->verrou);
+  lru_toucher(e, s);
+}
+
+/*! \brief Précharge le segment qui suit celui d'indice i, en tournant. */
+static void segment_precharger_suivant(externe e, size_t i) {
+  segment_precharger(e, i + 1 == e->nb_segments ? 0 : i + 1);
+}
+
+/*!
+ * \brief Création d'un segment vide en mémoire, rangé à l'indice i.
+ */
+static segment *segment_creer(externe e, size_t i) {
+  segment *s = malloc(sizeof(segment));
+  assert(s != NULL);
+  s->donnees = tampon_reserver(e, true);
+  s->nb = 0;
+  s->trou = 0;
+  s->emplacement = -1;
+  s->etat = SEGMENT_PRESENT;
+  s->modifie = true;
+  s->epingle = 0;
+  s->dans_lru = false;
+  s->recent = s->ancien = s->file = NULL;
+  if (e->nb_segments == e->max_segments) {
+    e->max_segments = e->max_segments == 0 ? 16 : 2 * e->max_segments;
+    e->segments = realloc(e->segments, e->max_segments * sizeof(segment *));
+    assert(e->segments != NULL);
+  }
+  memmove(e->segments + i + 1, e->segments + i,
+          (e->nb_segments - i) * sizeof(segment *));
+  e->segments[i] = s;
+  e->nb_segments++;
+  if (e->a_courant && e->courant.segment >= i) {
+    e->courant.segment++;
+  }
+  lru_toucher(e, s);
+  return s;
+}
+
+/*! \brief Retire le segment vide d'indice i. */
+static void segment_retirer(externe e, size_t i) {
+  segment *s = e->segments[i];
+  assert(s->nb == 0);
+  pthread_mutex_lock(&e->verrou);
+  transfert_attendre(e, s);
+  if (s->donnees != NULL) {
+    free(s->donnees);
+    e->nb_tampons--;
+  }
+  pthread_mutex_unlock(&e->verrou);
+  lru_retirer(e, s);
+  if (s->emplacement >= 0) {
+    emplacement_rendre(e, s->emplacement);
+  }
+  memmove(e->segments + i, e->segments + i + 1,
+          (e->nb_segments - i - 1) * sizeof(segment *));
+  e->nb_segments--;
+  if (e->a_courant && e->courant.segment > i) {
+    e->courant.segment--;
+  }
+  free(s);
+}
+
+/*! \brief Adresse de la valeur d'indice i d'un segment chargé. */
+static char *segment_adresse(externe e, segment *s, unsigned int i) {
+  size_t place = i < s->trou ? i : (size_t)i + e->capacite - s->nb;
+  return s->donnees + place * e->taille_valeur;
+}
+
+/*! \brief Adresse de la valeur à la position p, dont le segment est chargé. */
+static char *valeur_adresse(externe e, position p) {
+  return segment_adresse(e, e->segments[p.segment], p.indice);
+}
+
+/*! \brief Déplace le trou d'un segment chargé devant l'indice i. */
+static void trou_deplacer(externe e, segment *s, unsigned int i) {
+  size_t libres = e->capacite - s->nb;
+  size_t tv = e->taille_valeur;
+  if (i < s->trou) {
+    memmove(s->donnees + (i + libres) * tv, s->donnees + (size_t)i * tv,
+            (size_t)(s->trou - i) * tv);
+  } else if (i > s->trou) {
+    memmove(s->donnees + (size_t)s->trou * tv,
+            s->donnees + (s->trou + libres) * tv, (size_t)(i - s->trou) * tv);
+  }
+  s->trou = i;
+}
+
+/*!
+ * \brief Insertion d'une valeur à la position p, les suivantes étant
+ * décalées ; p.indice peut valoir le nombre de valeurs du segment. Un
+ * segment plein est coupé en deux, sauf pour une insertion à l'une de ses
+ * extrémités qui commence un nouveau segment.
+ * \return la position de la valeur insérée.
+ */
+static position inserer(externe e, position p, void const *val) {
+  if (e->nb_segments == 0) {
+    segment_creer(e, 0);
+    p.segment = 0;
+    p.indice = 0;
+  }
+  segment *s = e->segments[p.segment];
+  segment_charger(e, s);
+  if (s->nb == e->capacite) {
+    s->epingle++;
+    if (p.indice == e->capacite) {
+      segment_creer(e, p.segment + 1);
+      p.segment++;
+      p.indice = 0;
+    } else if (p.indice == 0) {
+      segment_creer(e, p.segment);
+    } else {
+      /* un segment plein n'a pas de trou */
+      segment *n = segment_creer(e, p.segment + 1);
+      unsigned int moitie = e->capacite / 2;
+      n->nb = n->trou = e->capacite - moitie;
+      memcpy(n->donnees, s->donnees + (size_t)moitie * e->taille_valeur,
+             (size_t)n->nb * e->taille_valeur);
+      s->nb = s->trou = moitie;
+      if (e->a_courant && e->courant.segment == p.segment &&
+          e->courant.indice >= moitie) {
+        e->courant.segment++;
+        e->courant.indice -= moitie;
+      }
+      if (p.indice > moitie) {
+        p.segment++;
+        p.indice -= moitie;
+      }
+    }
+    s->epingle--;
+    s = e->segments[p.segment];
+  }
+  trou_deplacer(e, s, p.indice);
+  memcpy(s->donnees + (size_t)p.indice * e->taille_valeur, val,
+         e->taille_valeur);
+  s->trou++;
+  s->nb++;
+  s->modifie = true;
+  e->taille++;
+  if (e->a_courant && e->courant.segment == p.segment &&
+      e->courant.indice >= p.indice) {
+    e->courant.indice++;
+  }
+  return p;
+}
+
+/*!
+ * \brief Suppression de la valeur à la position p ; le courant n'existe plus
+ * s'il la désignait.
+ */
+static void supprimer(externe e, position p) {
+  segment *s = e->segments[p.segment];
+  segment_charger(e, s);
+  trou_deplacer(e, s, p.indice + 1);
+  s->trou--;
+  s->nb--;
+  s->modifie = true;
+  e->taille--;
+  if (e->a_courant && e->courant.segment == p.segment) {
+    if (e->courant.indice == p.indice) {
+      e->a_courant = false;
+    } else if (e->courant.indice > p.indice) {
+      e->courant.indice--;
+    }
+  }
+  if (s->nb == 0) {
+    segment_retirer(e, p.segment);
+  }
+}
+
+/*! \brief Position de la dernière valeur d'un stockage non vide. */
+static position derniere(externe e) {
+  position p = {e->nb_segments - 1, 0};
+  p.indice = e->segments[p.segment]->nb - 1;
+  return p;
+}
+
+/*! \brief Position suivante, la tête après le pied. */
+static position suivante(externe e, position p) {
+  if (p.indice + 1 < e->segments[p.segment]->nb) {
+    p.indice++;
+  } else {
+    p.segment = p.segment + 1 == e->nb_segments ? 0 : p.segment + 1;
+    p.indice = 0;
+  }
+  return p;
+}
+
+/*! \brief Position précédente, le pied avant la tête. */
+static position precedente(externe e, position p) {
+  if (p.indice > 0) {
+    p.indice--;
+  } else {
+    p.segment = p.segment == 0 ? e->nb_segments - 1 : p.segment - 1;
+    p.indice = e->segments[p.segment]->nb - 1;
+  }
+  return p;
+}
+
+/*! \brief Valeur à la position p, dont le segment devient modifié. */
+static void *valeur(externe e, position p) {
+  segment *s = e->segments[p.segment];
+  segment_charger(e, s);
+  s->modifie = true;
+  return valeur_adresse(e, p);
+}
+
+externe externe_creer(size_t taille_valeur, char const *repertoire,
+                      size_t budget) {
+  assert(taille_valeur > 0);
+  if (repertoire == NULL) {
+    repertoire = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp";
+  }
+  char const modele[] = "/liste_externe_XXXXXX";
+  char *chemin = malloc(strlen(repertoire) + sizeof(modele));
+  assert(chemin != NULL);
+  strcpy(chemin, repertoire);
+  strcat(chemin, modele);
+  int fd = mkstemp(chemin);
+  if (fd >= 0) {
+    /* le fichier disparaît à sa fermeture */
+    unlink(chemin);
+  }
+  free(chemin);
+  if (fd < 0) {
+    return NULL;
+  }
+  externe e = malloc(sizeof(struct externe_struct));
+  assert(e != NULL);
+  size_t octets = (budget == 0 ? BUDGET_DEFAUT : budget) / TAMPONS_MIN;
+  if (octets > SEGMENT_OCTETS) {
+    octets = SEGMENT_OCTETS;
+  }
+  size_t capacite = octets / taille_valeur;
+  /* deux valeurs au moins, pour pouvoir couper un segment */
+  e->capacite = capacite < 2 ? 2 : (unsigned int)capacite;
+  e->taille_valeur = taille_valeur;
+  e->octets = (size_t)e->capacite * taille_valeur;
+  e->segments = NULL;
+  e->nb_segments = 0;
+  e->max_segments = 0;
+  e->taille = 0;
+  e->a_courant = false;
+  e->fd = fd;
+  e->libres = NULL;
+  e->nb_libres = 0;
+  e->max_libres = 0;
+  e->nb_emplacements = 0;
+  e->recent = e->ancien = NULL;
+  e->nb_allocations = 0;
+  e->nb_tampons = 0;
+  e->nb_ecritures = 0;
+  e->file_tete = e->file_queue = NULL;
+  e->fin = false;
+  pthread_mutex_init(&e->verrou, NULL);
+  pthread_cond_init(&e->travail, NULL);
+  pthread_cond_init(&e->fait, NULL);
+  externe_budget(e, budget);
+  e->thread_lance =
+      pthread_create(&e->thread, NULL, &entrees_sorties, e) == 0;
+  return e;
+}
+
+void externe_detruire(externe *e) {
+  assert(e != NULL && *e != NULL);
+  externe s = *e;
+  if (s->thread_lance) {
+    pthread_mutex_lock(&s->verrou);
+    s->fin = true;
+    pthread_cond_signal(&s->travail);
+    pthread_mutex_unlock(&s->verrou);
+    pthread_join(s->thread, NULL);
+  }
+  for (size_t i = 0; i < s->nb_segments; i++) {
+    free(s->segments[i]->donnees);
+    free(s->segments[i]);
+  }
+  free(s->segments);
+  free(s->libres);
+  close(s->fd);
+  pthread_cond_destroy(&s->fait);
+  pthread_cond_destroy(&s->travail);
+  pthread_mutex_destroy(&s->verrou);
+  free(s);
+  *e = NULL;
+}
+
+void externe_budget(externe e, size_t budget) {
+  assert(e != NULL);
+  size_t tampons = (budget == 0 ? BUDGET_DEFAUT : budget) / e->octets;
+  pthread_mutex_lock(&e->verrou);
+  e->max_tampons = tampons < TAMPONS_MIN ? TAMPONS_MIN : tampons;
+  pthread_mutex_unlock(&e->verrou);
+}
+
+size_t externe_taille(externe e) { return e->taille; }
+
+bool externe_a_courant(externe e) { return e->a_courant; }
+
+unsigned long long externe_nb_allocations(externe e) {
+  return e->nb_allocations;
+}
+
+void externe_inserer_debut(externe e, void const *val) {
+  position p = {0, 0};
+  inserer(e, p, val);
+}
+
+void externe_inserer_fin(externe e, void const *val) {
+  position p = {0, 0};
+  if (e->nb_segments > 0) {
+    p = derniere(e);
+    p.indice++;
+  }
+  inserer(e, p, val);
+}
+
+void externe_inserer_avant(externe e, void const *val) {
+  assert(e->a_courant);
+  inserer(e, e->courant, val);
+}
+
+void externe_inserer_apres(externe e, void const *val) {
+  assert(e->a_courant);
+  position p = e->courant;
+  p.indice++;
+  inserer(e, p, val);
+}
+
+void externe_supprimer_debut(externe e) {
+  assert(e->taille > 0);
+  position p = {0, 0};
+  supprimer(e, p);
+}
+
+void externe_supprimer_fin(externe e) {
+  assert(e->taille > 0);
+  supprimer(e, derniere(e));
+}
+
+void externe_supprimer_avant(externe e) {
+  assert(e->a_courant);
+  supprimer(e, e->taille >= 2 ? precedente(e, e->courant) : e->courant);
+}
+
+void externe_supprimer_apres(externe e) {
+  assert(e->a_courant);
+  supprimer(e, e->taille >= 2 ? suivante(e, e->courant) : e->courant);
+}
+
+void *externe_valeur_tete(externe e) {
+  assert(e->taille > 0);
+  position p = {0, 0};
+  return valeur(e, p);
+}
+
+void *externe_valeur_pied(externe e) {
+  assert(e->taille > 0);
+  return valeur(e, derniere(e));
+}
+
+void *externe_valeur_courant(externe e) {
+  assert(e->a_courant);
+  return valeur(e, e->courant);
+}
+
+bool externe_est_tete(externe e) {
+  assert(e->a_courant);
+  return e->courant.segment == 0 && e->courant.indice == 0;
+}
+
+bool externe_est_pied(externe e) {
+  assert(e->a_courant);
+  position p = derniere(e);
+  return e->courant.segment == p.segment && e->courant.indice == p.indice;
+}
+
+void externe_courant_init(externe e) {
+  e->a_courant = e->taille > 0;
+  e->courant.segment = 0;
+  e->courant.indice = 0;
+  if (e->a_courant) {
+    segment_precharger_suivant(e, 0);
+  }
+}
+
+void externe_courant_suivant(externe e) {
+  assert(e->a_courant);
+  e->courant = suivante(e, e->courant);
+  if (e->courant.indice == 0) {
+    segment_precharger_suivant(e, e->courant.segment);
+  }
+}
+
+void externe_decalage(externe e, int n) {
+  assert(e->a_courant);
+  if (n <= 0) {
+    return;
+  }
+  size_t reste = (size_t)n % e->taille;
+  position p = e->courant;
+  while (reste > 0) {
+    size_t apres = e->segments[p.segment]->nb - 1 - p.indice;
+    if (reste <= apres) {
+      p.indice += (unsigned int)reste;
+      break;
+    }
+    reste -= apres + 1;
+    p.segment = p.segment + 1 == e->nb_segments ? 0 : p.segment + 1;
+    p.indice = 0;
+  }
+  e->courant = p;
+  segment_precharger_suivant(e, p.segment);
+}
+
+void externe_remplacer_courant(externe e, void *const *vals, unsigned int k,
+                               unsigned int position_courant) {
+  assert(e->a_courant && vals != NULL && k > 0 && position_courant < k);
+  memcpy(valeur(e, e->courant), vals[0], e->taille_valeur);
+  /* le courant suit les coupures des segments pendant les insertions */
+  position p = e->courant;
+  for (unsigned int i = 1; i < k; i++) {
+    p.indice++;
+    p = inserer(e, p, vals[i]);
+    if (i == position_courant) {
+      e->courant = p;
+    }
+  }
+}
+
+void externe_afficher(FILE *f, externe e,
+                      void (*afficher)(FILE *f, void *val)) {
+  assert(f != NULL && afficher != NULL);
+  fprintf(f, "[ ");
+  for (size_t i = 0; i < e->nb_segments; i++) {
+    segment *s = e->segments[i];
+    segment_charger(e, s);
+    if (i + 1 < e->nb_segments) {
+      segment_precharger(e, i + 1);
+    }
+    for (unsigned int j = 0; j < s->nb; j++) {
+      afficher(f, segment_adresse(e, s, j));
+    }
+  }
+  fprintf(f, "]");
+}
+
+bool externe_est_valide(externe e) {
+  assert(e != NULL);
+  size_t total = 0;
+  for (size_t i = 0; i < e->nb_segments; i++) {
+    segment *s = e->segments[i];
+    if (s->nb == 0 || s->nb > e->capacite || s->trou > s->nb ||
+        (ETAT(s) == SEGMENT_DISQUE && (s->modifie || s->emplacement < 0))) {
+      return false;
+    }
+    total += s->nb;
+  }
+  if (total != e->taille) {
+    return false;
+  }
+  return !e->a_courant || (e->courant.segment < e->nb_segments &&
+                           e->courant.indice <
+                               e->segments[e->courant.segment]->nb);
+}
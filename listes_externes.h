@@ -0,0 +1,184 @@
+#ifndef LISTES_EXTERNES
+#define LISTES_EXTERNES
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Module de stockage externe des listes de valeurs de taille fixe.
+ *
+ * Les valeurs sont rangées dans l'ordre de la liste par segments de taille
+ * fixe. Les segments les plus récemment utilisés restent en mémoire, dans la
+ * limite d'un budget ; les autres sont écrits dans un fichier de débordement,
+ * effacé dès sa création. Un thread d'entrées-sorties écrit les segments
+ * évincés et lit par anticipation le segment qui suit celui du courant.
+ *
+ * Le stockage garde la tête, le pied et le courant d'une liste circulaire ;
+ * les opérations ont le sens de celles de listes_generiques, qui est le seul
+ * module à l'utiliser. Les pointeurs rendus par les fonctions de valeur
+ * restent valides jusqu'à l'opération suivante, qui peut évincer leur
+ * segment.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Cette structure contient les segments d'une liste externe.
+ * Elle est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct externe_struct *externe;
+
+/*!
+ * \brief Création d'un stockage vide.
+ * \param taille_valeur taille en octets des valeurs, non nulle.
+ * \param repertoire répertoire du fichier de débordement, NULL pour TMPDIR ou
+ * à défaut /tmp.
+ * \param budget mémoire des segments en octets, 0 pour le budget par défaut.
+ * \return le stockage, NULL si le fichier n'a pas pu être créé.
+ */
+externe externe_creer(size_t taille_valeur, char const *repertoire,
+                      size_t budget);
+
+/*!
+ * \brief Destruction du stockage et de son fichier.
+ * \param e pointeur vers le stockage, vaut NULL en sortie.
+ */
+void externe_detruire(externe *e);
+
+/*!
+ * \brief Change le budget mémoire ; les segments en trop sont évincés aux
+ * chargements suivants.
+ * \param e stockage.
+ * \param budget nouveau budget en octets, 0 pour le budget par défaut.
+ */
+void externe_budget(externe e, size_t budget);
+
+/*!
+ * \brief Nombre de valeurs.
+ */
+size_t externe_taille(externe e);
+
+/*!
+ * \brief Vrai si le courant désigne une valeur.
+ */
+bool externe_a_courant(externe e);
+
+/*!
+ * \brief Segments chargés ou créés en mémoire depuis la création.
+ */
+unsigned long long externe_nb_allocations(externe e);
+
+/*!
+ * \brief Insertion en tête.
+ * \param e stockage où insérer.
+ * \param val valeur de taille_valeur octets, recopiée.
+ */
+void externe_inserer_debut(externe e, void const *val);
+
+/*!
+ * \brief Insertion en pied.
+ * \param e stockage où insérer.
+ * \param val valeur de taille_valeur octets, recopiée.
+ */
+void externe_inserer_fin(externe e, void const *val);
+
+/*!
+ * \brief Insertion avant le courant, qui reste sur sa valeur.
+ * \param e stockage où insérer.
+ * \param val valeur de taille_valeur octets, recopiée.
+ */
+void externe_inserer_avant(externe e, void const *val);
+
+/*!
+ * \brief Insertion après le courant.
+ * \param e stockage où insérer.
+ * \param val valeur de taille_valeur octets, recopiée.
+ */
+void externe_inserer_apres(externe e, void const *val);
+
+/*!
+ * \brief Suppression de la tête d'un stockage non vide.
+ */
+void externe_supprimer_debut(externe e);
+
+/*!
+ * \brief Suppression du pied d'un stockage non vide.
+ */
+void externe_supprimer_fin(externe e);
+
+/*!
+ * \brief Suppression de la valeur avant le courant, le pied pour la tête, ou
+ * du courant s'il est seul.
+ */
+void externe_supprimer_avant(externe e);
+
+/*!
+ * \brief Suppression de la valeur après le courant, la tête pour le pied, ou
+ * du courant s'il est seul.
+ */
+void externe_supprimer_apres(externe e);
+
+/*!
+ * \brief Valeur de tête d'un stockage non vide, modifiable en place : son
+ * segment est considéré comme modifié.
+ */
+void *externe_valeur_tete(externe e);
+
+/*!
+ * \brief Valeur de pied d'un stockage non vide, modifiable en place.
+ */
+void *externe_valeur_pied(externe e);
+
+/*!
+ * \brief Valeur du courant, modifiable en place.
+ */
+void *externe_valeur_courant(externe e);
+
+/*!
+ * \brief Vrai si le courant est la tête.
+ */
+bool externe_est_tete(externe e);
+
+/*!
+ * \brief Vrai si le courant est le pied.
+ */
+bool externe_est_pied(externe e);
+
+/*!
+ * \brief Place le courant sur la tête, ou nulle part si le stockage est
+ * vide, et lit par anticipation le deuxième segment.
+ */
+void externe_courant_init(externe e);
+
+/*!
+ * \brief Passe le courant à la valeur suivante, la tête après le pied ; en
+ * entrant dans un segment, le segment suivant est lu par anticipation.
+ */
+void externe_courant_suivant(externe e);
+
+/*!
+ * \brief Avance le courant de n positions en tournant ; ne fait rien pour
+ * n négatif ou nul.
+ */
+void externe_decalage(externe e, int n);
+
+/*!
+ * \brief Remplace la valeur courante par vals[0] suivie de vals[1..k-1] ; le
+ * courant passe sur vals[position].
+ */
+void externe_remplacer_courant(externe e, void *const *vals, unsigned int k,
+                               unsigned int position);
+
+/*!
+ * \brief Affiche les valeurs sous la forme \verbatim[ 1 2 3 ]\endverbatim.
+ */
+void externe_afficher(FILE *f, externe e, void (*afficher)(FILE *f, void *val));
+
+/*!
+ * \brief Vérifie la cohérence des segments et du courant.
+ */
+bool externe_est_valide(externe e);
+
+#endif
@@ -1,14 +1,89 @@
+#define _POSIX_C_SOURCE 200809L
 #include "listes_generiques.h"
+#include "listes_destruction.h"
+#include "listes_externes.h"
+#include "listes_trace.h"
 #include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #define ASSERT_LISTE() assert(l != NULL);
 
+/*! \brief Retraits entre deux tentatives d'avancer l'époque. */
+#define DIFFERES_AVANT_AVANCEE 64
+
+/*!
+ * \brief Écriture d'un pointeur qui peut être lu par un lecteur concurrent :
+ * ce qu'il désigne est entièrement initialisé avant qu'il soit visible.
+ */
+#define PUBLIER(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+/*! \brief Lecture d'un pointeur publié par PUBLIER. */
+#define LIRE(p) __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+
+/*! \brief Marque du suivant du pied d'une liste concurrente, vers la tete. */
+#define FIN ((uintptr_t)1)
+
+/*! \brief Maillon désigné par un suivant, sans sa marque. */
+#define CIBLE(m) ((maillon)((uintptr_t)(m) & ~FIN))
+
+/*! \brief Marque FIN d'un suivant, gardée quand il est remplacé. */
+#define MARQUE_FIN(m) ((uintptr_t)(m) & FIN)
+
+/*! \brief Suivant vers m, portant la marque fin (0 ou FIN). */
+#define AVEC_FIN(m, fin) ((maillon)((uintptr_t)(m) | (fin)))
+
+/*! \brief Taille minimale des suites du tri, complétées par insertion. */
+#define TRI_SUITE_MIN 16
+
+/*! \brief Hauteur maximale de la pile des suites du tri. */
+#define TRI_PILE_MAX 64
+
+/*! \brief Taille minimale d'un segment trié par un thread. */
+#define SEUIL_TRI_PARALLELE 16384
+
+/*! \brief Nombre maximal de maillons recyclés conservés par défaut. */
+#define LISTE_RECYCLAGE_DEFAUT 64
+
 #define ASSERT_LISTE_COURANT()                                                 \
   assert(l != NULL);                                                           \
-  assert(l->courant != NULL);
+  assert(l->externe != NULL ? externe_a_courant(l->externe)                   \
+                            : l->courant != NULL);
+
+/*! \brief Enregistre l'appel dans la trace si la liste est tracée. */
+#define TRACER(l, operation)                                                   \
+  do {                                                                         \
+    if ((l)->trace != 0) {                                                     \
+      listes_trace_appel((l)->trace, (operation), NULL, 0);                    \
+    }                                                                          \
+  } while (0)
+
+/*! \brief Comme TRACER, pour un appel qui a un argument entier. */
+#define TRACER_ARGUMENT(l, operation, argument)                                \
+  do {                                                                         \
+    if ((l)->trace != 0) {                                                     \
+      int const argument_ = (argument);                                        \
+      listes_trace_appel((l)->trace, (operation), &argument_, 1);              \
+    }                                                                          \
+  } while (0)
+
+/*!
+ * \brief Appel d'une fonction publique par une autre, déjà enregistrée : il
+ * n'est pas tracé.
+ */
+#define SANS_TRACE(l, appel)                                                   \
+  do {                                                                         \
+    unsigned long trace_ = (l)->trace;                                         \
+    (l)->trace = 0;                                                            \
+    appel;                                                                     \
+    (l)->trace = trace_;                                                       \
+  } while (0)
 
 /*! \file
  * \brief La documentation pour les parties (types, variables, fonctions…)
@@ -34,22 +109,378 @@ struct maillon_struct {
   maillon precedent;
 };
 
+/* \brief la structure définit 3 champs supplémentaires qui sont des pointeurs
+ * sur fonction.
+ * Elle conserve aussi les maillons supprimés (chaînés par suivant) afin de les
+ * réutiliser lors des insertions suivantes.
+ */
+struct liste_struct {
+  unsigned int taille;
+  maillon tete;
+  maillon pied;
+  maillon courant;
+  void (*copier)(
+      void *val,
+      void **pt); /* pour définir la valeur du maillon à partir d'une recopie */
+  void (*afficher)(
+      FILE *f,
+      void *val); /* pour définir comment on affiche la valeur du maillon */
+  void (*detruire)(void **pt); /* pour définir comment désallouer la mémoire
+                                  relative à la valeur du maillon */
+  maillon recycles;         /* maillons supprimés en attente de réutilisation */
+  unsigned int nb_recycles; /* nombre de maillons dans recycles */
+  unsigned int max_recycles; /* nombre maximal de maillons conservés */
+  size_t taille_valeur; /* taille des valeurs conservées avec leur maillon, 0
+                           si les valeurs sont détruites */
+  unsigned long long nb_allocations; /* maillons alloués et valeurs copiées */
+  bool en_ligne; /* valeurs de taille_valeur octets stockées dans le maillon
+                    même, sans copier ni detruire */
+  struct bloc **blocs; /* blocs où des maillons peuvent se trouver, triés par
+                          adresse */
+  unsigned int nb_blocs;
+  unsigned int capacite_blocs;
+  maillon a_compacter; /* où reprend liste_compacter_etape, NULL pour tete */
+  bool concurrente;     /* des lecteurs peuvent parcourir la liste */
+  unsigned long epoque; /* époque courante, à partir de 1 */
+  maillon differes[3]; /* maillons retirés, par époque modulo 3, chaînés par
+                          precedent */
+  unsigned int nb_differes; /* retraits depuis la dernière avancée */
+  lecteur lecteurs; /* lecteurs inscrits, chaînés par suivant */
+  pthread_mutex_t verrou_lecteurs; /* protège lecteurs */
+  destruction_attente differee;    /* place dans la file de la destruction
+                                      différée */
+  unsigned long trace; /* numéro dans la trace, 0 si la liste n'est pas
+                          tracée */
+  externe externe; /* segments d'une liste externe, NULL sinon : la liste
+                      n'a alors aucun maillon */
+};
+
+/*!
+ * \brief Lecteur concurrent d'une liste. Les lecteurs ne suivent que les
+ * champs suivant. Celui du pied porte la marque FIN tant que la liste est
+ * concurrente : chaque suivant publié dit lui-même s'il mène à la tete, et un
+ * lecteur reconnaît la fin sans rien attendre de l'écrivain. Celui d'un
+ * maillon retiré n'est pas modifié : il mène plus loin dans la liste, ou
+ * porte FIN si le maillon était le pied.
+ * Le rembourrage sépare les époques des lecteurs en lignes de cache.
+ */
+struct lecteur_struct {
+  liste l;
+  unsigned long epoque; /* époque d'entrée en lecture, 0 hors lecture */
+  maillon position;     /* maillon de la dernière valeur retournée */
+  lecteur suivant;
+  char rembourrage[64];
+};
+
+/*!
+ * \brief Bloc de maillons contigus alloué par la compaction ou par
+ * liste_remplacer_courant. Il n'est libéré que lorsque son dernier maillon
+ * l'est. Les listes issues d'une même scission peuvent se partager un bloc et
+ * être modifiées en parallèle : chacune l'inscrit dans ses propres blocs, et
+ * ses deux compteurs sont atomiques. Une fois le bloc libéré, vivants reste à
+ * 0 : son adresse a pu être réutilisée, et les listes qui l'ont encore
+ * inscrit l'en retirent quand elles le rencontrent.
+ */
+typedef struct bloc {
+  char *debut;               /* premier maillon du bloc */
+  char *fin;                 /* juste après le dernier maillon */
+  size_t vivants;            /* maillons du bloc pas encore libérés */
+  unsigned int inscriptions; /* listes où le bloc est inscrit */
+} bloc;
+
+/*!
+ * \brief Nombre de blocs de la liste qui commencent au plus à adresse.
+ * \param l liste dont on cherche le bloc.
+ * \param adresse adresse cherchée.
+ * \return l'indice du premier bloc qui commence après adresse.
+ */
+static unsigned int bloc_position(liste const l, void const *adresse) {
+  unsigned int bas = 0;
+  unsigned int haut = l->nb_blocs;
+  while (bas < haut) {
+    unsigned int milieu = (bas + haut) / 2;
+    if ((uintptr_t)l->blocs[milieu]->debut <= (uintptr_t)adresse) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  return bas;
+}
+
+/*!
+ * \brief Inscription d'un bloc dans les blocs de la liste, triés par adresse.
+ * \param l liste où inscrire.
+ * \param b bloc, dont le compteur d'inscriptions compte déjà celle-ci.
+ */
+static void bloc_inscrire(liste const l, bloc *b) {
+  if (l->nb_blocs == l->capacite_blocs) {
+    l->capacite_blocs = l->capacite_blocs == 0 ? 16 : 2 * l->capacite_blocs;
+    l->blocs = realloc(l->blocs, l->capacite_blocs * sizeof(bloc *));
+    assert(l->blocs != NULL);
+  }
+  unsigned int i = bloc_position(l, b->debut);
+  memmove(l->blocs + i + 1, l->blocs + i, (l->nb_blocs - i) * sizeof(bloc *));
+  l->blocs[i] = b;
+  l->nb_blocs++;
+}
+
+/*!
+ * \brief Retire une inscription ; le bloc est oublié avec la dernière.
+ * \param b bloc inscrit.
+ */
+static void bloc_oublier(bloc *b) {
+  if (__atomic_sub_fetch(&b->inscriptions, 1, __ATOMIC_ACQ_REL) == 0) {
+    free(b);
+  }
+}
+
+/*!
+ * \brief Retrait du bloc d'indice i des blocs de la liste.
+ */
+static void bloc_desinscrire(liste const l, unsigned int i) {
+  bloc *b = l->blocs[i];
+  memmove(l->blocs + i, l->blocs + i + 1,
+          (l->nb_blocs - i - 1) * sizeof(bloc *));
+  l->nb_blocs--;
+  bloc_oublier(b);
+}
+
+/*!
+ * \brief Retrait de tous les blocs de la liste, à sa destruction.
+ */
+static void blocs_oublier(liste const l) {
+  for (unsigned int i = 0; i < l->nb_blocs; i++) {
+    bloc_oublier(l->blocs[i]);
+  }
+  free(l->blocs);
+  l->blocs = NULL;
+  l->nb_blocs = l->capacite_blocs = 0;
+}
+
+/*!
+ * \brief Allocation d'un bloc de nb emplacements, inscrit dans la liste.
+ * \param l liste à laquelle sont destinés les maillons.
+ * \param nb nombre de maillons du bloc, non nul.
+ * \param emplacement taille d'un emplacement (cf. maillon_emplacement).
+ * \return la mémoire du bloc.
+ */
+static char *bloc_allouer(liste const l, size_t nb, size_t emplacement) {
+  char *memoire = malloc(nb * emplacement);
+  bloc *b = malloc(sizeof(bloc));
+  assert(memoire != NULL && b != NULL);
+  b->debut = memoire;
+  b->fin = memoire + nb * emplacement;
+  b->vivants = nb;
+  b->inscriptions = 1;
+  bloc_inscrire(l, b);
+  return memoire;
+}
+
+/*!
+ * \brief Désallocation de la mémoire d'un maillon : s'il fait partie d'un
+ * bloc, celui-ci n'est libéré qu'avec son dernier maillon.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à désallouer.
+ */
+static void maillon_memoire_liberer(liste const l, maillon m) {
+  while (l->nb_blocs > 0) {
+    unsigned int i = bloc_position(l, m);
+    if (i == 0) {
+      break;
+    }
+    bloc *b = l->blocs[i - 1];
+    if (__atomic_load_n(&b->vivants, __ATOMIC_ACQUIRE) == 0) {
+      /* libéré depuis une autre liste : il peut en cacher un plus ancien */
+      bloc_desinscrire(l, i - 1);
+      continue;
+    }
+    if ((uintptr_t)m >= (uintptr_t)b->fin) {
+      break;
+    }
+    if (__atomic_sub_fetch(&b->vivants, 1, __ATOMIC_ACQ_REL) == 0) {
+      free(b->debut);
+      bloc_desinscrire(l, i - 1);
+    }
+    return;
+  }
+  free(m);
+}
+
+/*!
+ * \brief Les blocs de s passent à l ; un bloc inscrit dans les deux ne l'est
+ * plus qu'une fois, et les blocs déjà libérés sont oubliés.
+ * \param l liste qui reçoit les blocs.
+ * \param s liste qui les cède.
+ */
+static void blocs_transferer(liste const l, liste const s) {
+  if (s->nb_blocs == 0) {
+    return;
+  }
+  unsigned int capacite = l->nb_blocs + s->nb_blocs;
+  bloc **blocs = malloc(capacite * sizeof(bloc *));
+  assert(blocs != NULL);
+  unsigned int nb = 0;
+  unsigned int i = 0;
+  unsigned int j = 0;
+  while (i < l->nb_blocs || j < s->nb_blocs) {
+    bloc *b;
+    if (j == s->nb_blocs ||
+        (i < l->nb_blocs &&
+         (uintptr_t)l->blocs[i]->debut <= (uintptr_t)s->blocs[j]->debut)) {
+      b = l->blocs[i++];
+    } else {
+      b = s->blocs[j++];
+    }
+    if (__atomic_load_n(&b->vivants, __ATOMIC_ACQUIRE) == 0 ||
+        (nb > 0 && blocs[nb - 1] == b)) {
+      bloc_oublier(b);
+    } else {
+      blocs[nb++] = b;
+    }
+  }
+  free(l->blocs);
+  free(s->blocs);
+  l->blocs = blocs;
+  l->nb_blocs = nb;
+  l->capacite_blocs = capacite;
+  s->blocs = NULL;
+  s->nb_blocs = s->capacite_blocs = 0;
+}
+
 /*!
  * \brief Création d'un maillon dont la valeur est val .
  * suivant et precedent doivent pointer sur ce maillon.
+ * Un maillon recyclé de la liste est réutilisé s'il en existe un ; si sa valeur
+ * a été conservée, la nouvelle valeur y est simplement recopiée.
+ * \param l liste à laquelle est destiné le maillon.
  * \param val un pointeur vers la valeur à stocker dans le maillon.
- * \param copier un pointeur vers une fonction qui définit la valeur du maillon
- * à partir d'une recopie.
  * \return nouveau maillon stockant val et bouclant sur lui-même.
  */
-static maillon maillon_creer(void *val, void (*copier)(void *val, void **pt)) {
-  assert(copier != NULL && val != NULL);
-  maillon m = malloc(sizeof(struct maillon_struct));
-  copier(val, &(m->val));
+static maillon maillon_creer(liste const l, void *val) {
+  assert(l != NULL && val != NULL);
+  maillon m = l->recycles;
+  if (m != NULL) {
+    l->recycles = m->suivant;
+    l->nb_recycles--;
+    if (m->val != NULL) {
+      memcpy(m->val, val, l->taille_valeur);
+    } else {
+      l->copier(val, &(m->val));
+      l->nb_allocations++;
+    }
+  } else if (l->en_ligne) {
+    m = malloc(sizeof(struct maillon_struct) + l->taille_valeur);
+    m->val = m + 1;
+    memcpy(m->val, val, l->taille_valeur);
+    l->nb_allocations++;
+  } else {
+    m = malloc(sizeof(struct maillon_struct));
+    l->copier(val, &(m->val));
+    l->nb_allocations += 2;
+  }
   m->precedent = m->suivant = m;
   return m;
 }
 
+/*!
+ * \brief Désallocation d'un maillon et de sa valeur, sauf si elle est stockée
+ * dans le maillon.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à désallouer.
+ */
+static void maillon_liberer(liste const l, maillon m) {
+  if (!l->en_ligne && m->val != NULL) {
+    l->detruire(&(m->val));
+  }
+  maillon_memoire_liberer(l, m);
+}
+
+/*!
+ * \brief Le maillon, qui n'est plus atteignable, est conservé pour être
+ * réutilisé tant que la limite de recyclage n'est pas atteinte, sinon il est
+ * désalloué. Sa valeur n'est conservée que si taille_valeur est connue.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à ranger.
+ */
+static void maillon_ranger(liste const l, maillon m) {
+  if (l->nb_recycles < l->max_recycles) {
+    if (l->taille_valeur == 0) {
+      l->detruire(&(m->val));
+      m->val = NULL;
+    }
+    m->suivant = l->recycles;
+    l->recycles = m;
+    l->nb_recycles++;
+  } else {
+    maillon_liberer(l, m);
+  }
+}
+
+/*!
+ * \brief Range tous les maillons retirés à une époque donnée (modulo 3).
+ */
+static void differes_ranger(liste const l, unsigned int i) {
+  maillon m = l->differes[i];
+  l->differes[i] = NULL;
+  while (m != NULL) {
+    maillon precedent = m->precedent;
+    maillon_ranger(l, m);
+    m = precedent;
+  }
+}
+
+/*!
+ * \brief Passe à l'époque suivante si tous les lecteurs en cours de lecture
+ * ont commencé pendant l'époque courante. Aucun ne peut alors plus atteindre
+ * les maillons retirés deux époques plus tôt, qui sont rangés.
+ * \param l liste concurrente.
+ * \return true ssi l'époque a avancé.
+ */
+static bool epoque_avancer(liste const l) {
+  unsigned long epoque = l->epoque;
+  /* les retraits sont visibles avant la lecture des époques des lecteurs */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  pthread_mutex_lock(&l->verrou_lecteurs);
+  for (lecteur r = l->lecteurs; r != NULL; r = r->suivant) {
+    unsigned long e = __atomic_load_n(&r->epoque, __ATOMIC_SEQ_CST);
+    if (e != 0 && e != epoque) {
+      pthread_mutex_unlock(&l->verrou_lecteurs);
+      return false;
+    }
+  }
+  pthread_mutex_unlock(&l->verrou_lecteurs);
+  __atomic_store_n(&l->epoque, epoque + 1, __ATOMIC_SEQ_CST);
+  differes_ranger(l, (unsigned int)((epoque + 1) % 3));
+  return true;
+}
+
+/*!
+ * \brief Retrait d'un maillon déjà détaché de la liste chaînée.
+ * Sans lecteur concurrent il est rangé tout de suite ; sinon il est différé
+ * jusqu'à ce qu'aucun lecteur ne puisse plus l'atteindre.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à retirer.
+ */
+static void maillon_recycler(liste const l, maillon m) {
+  assert(l != NULL && m != NULL);
+  if (m == l->a_compacter) {
+    /* la compaction reprendra au suivant, sauf si m était le pied */
+    l->a_compacter = CIBLE(m->suivant) == l->tete ? NULL : CIBLE(m->suivant);
+  }
+  if (!l->concurrente) {
+    maillon_ranger(l, m);
+    return;
+  }
+  unsigned int i = (unsigned int)(l->epoque % 3);
+  m->precedent = l->differes[i];
+  l->differes[i] = m;
+  if (++l->nb_differes >= DIFFERES_AVANT_AVANCEE) {
+    l->nb_differes = 0;
+    epoque_avancer(l);
+  }
+}
+
 /*!
  * \brief Test pour savoir si le maillon est unique ( bouclant sur lui-même et
  * correspondant à une liste de taille 1 ).
@@ -57,29 +488,25 @@ static maillon maillon_creer(void *val, void (*copier)(void *val, void **pt)) {
  */
 static bool maillon_est_unique(maillon m) {
   assert(m != NULL);
-  return m == m->precedent && m == m->suivant;
+  return m == m->precedent && m == CIBLE(m->suivant);
 }
 
 /*!
  * \brief Destruction de toute la liste chaînée.
+ * \param l liste à laquelle appartient la liste chaînée.
  * \param m pointeur sur un maillon de la liste chaînée à détruire.
- * \param detruire une pointeur vers une fonction qui définit comment désallouer
- * la mémoire relative à la valeur du maillon
 */
-static void maillon_detruire(maillon *m, void (*detruire)(void **pt)) {
-  assert(detruire != NULL);
+static void maillon_detruire(liste const l, maillon *m) {
   assert(m != NULL && *m != NULL);
   maillon start = *m;
   maillon courant = (*m)->suivant;
   maillon suivant;
   while (courant != start) {
     suivant = courant->suivant;
-    detruire(&(courant->val));
-    free(courant);
+    maillon_liberer(l, courant);
     courant = suivant;
   }
-  detruire(&(courant->val));
-  free(courant);
+  maillon_liberer(l, courant);
   *m = NULL;
 }
 
@@ -108,96 +535,97 @@ static void maillon_afficher(FILE *const f, maillon m_debut, maillon m_fin,
 
 /*!
  * \brief Ajout d'un élément avant le maillon.
+ * \param l liste à laquelle appartient le maillon.
  * \param m maillon avant lequel on doit insérer.
  * \param _val un pointeur vers la valeur entière à insérer.
- * \param copier un pointeur vers une fonction qui définit la valeur du maillon
- * à partir d'une recopie.
  */
-static void maillon_ajouter_avant(maillon m, void *_val,
-                                  void (*copier)(void *val, void **pt)) {
+static void maillon_ajouter_avant(liste const l, maillon m, void *_val) {
   assert(m != NULL);
   assert(_val != NULL);
-  assert(copier != NULL);
-  maillon nouveau = maillon_creer(_val, copier);
+  maillon nouveau = maillon_creer(l, _val);
   nouveau->precedent = m->precedent;
   nouveau->suivant = m;
-  m->precedent->suivant = nouveau;
+  PUBLIER(m->precedent->suivant,
+          AVEC_FIN(nouveau, MARQUE_FIN(m->precedent->suivant)));
   m->precedent = nouveau;
 }
 
 /*!
  * \brief Ajout d'un élément après le maillon.
+ * \param l liste à laquelle appartient le maillon.
  * \param m maillon après lequel on doit insérer.
  * \param _val un pointeur vers la valeur entière à insérer.
- * \param copier un pointeur vers une fonction qui définit la valeur du maillon
  */
-static void maillon_ajouter_apres(maillon m, void *_val,
-                                  void (*copier)(void *val, void **pt)) {
-  assert(m != NULL && _val != NULL && copier != NULL);
-  maillon nouveau = maillon_creer(_val, copier);
+static void maillon_ajouter_apres(liste const l, maillon m, void *_val) {
+  assert(m != NULL && _val != NULL);
+  maillon nouveau = maillon_creer(l, _val);
   nouveau->suivant = m->suivant;
   nouveau->precedent = m;
-  m->suivant->precedent = nouveau;
-  m->suivant = nouveau;
+  CIBLE(m->suivant)->precedent = nouveau;
+  PUBLIER(m->suivant, nouveau);
 }
 
 /*!
 * \brief Suppression du maillon d'avant s'il existe (c.-à-d. si la liste
 * correspondante ne contient qu'un maillon on ne fait rien).
+* Le maillon supprimé est recyclé.
+* \param l liste à laquelle appartient le maillon.
 * \param m maillon avant lequel on doit supprimer.
-* \param copier un pointeur vers une fonction qui définit comment désallouer la
-* mémoire relative à la valeur du maillon
 */
-static void maillon_supprimer_avant(maillon m, void (*detruire)(void **pt)) {
-  assert(m != NULL && detruire != NULL);
+static void maillon_supprimer_avant(liste const l, maillon m) {
+  assert(m != NULL);
   if (!maillon_est_unique(m)) {
     maillon avant = m->precedent;
-    avant->precedent->suivant = m;
+    /* si avant était la tete ou le pied, m le remplace auprès du pied */
+    PUBLIER(avant->precedent->suivant,
+            AVEC_FIN(m, MARQUE_FIN(avant->precedent->suivant) |
+                            MARQUE_FIN(avant->suivant)));
     m->precedent = avant->precedent;
-    detruire(&(avant->val));
-    free(avant);
+    maillon_recycler(l, avant);
   }
 }
 
 /*! \brief suppression du maillon d'après s'il existe (c.-à-d. si la liste
  * correspondante ne contient qu'un maillon on ne fait rien).
+ * Le maillon supprimé est recyclé.
+ * \param l liste à laquelle appartient le maillon.
  * \param m maillon après lequel on doit supprimer.
- * \param copier un pointeur vers une fonction qui définit comment désallouer la
- * mémoire relative à la valeur du maillon
 */
-static void maillon_supprimer_apres(maillon m, void (*detruire)(void **pt)) {
-  assert(m != NULL && detruire != NULL);
+static void maillon_supprimer_apres(liste const l, maillon m) {
+  assert(m != NULL);
   if (!maillon_est_unique(m)) {
-    maillon apres = m->suivant;
-    apres->suivant->precedent = m;
-    m->suivant = apres->suivant;
-    detruire(&(apres->val));
-    free(apres);
+    maillon apres = CIBLE(m->suivant);
+    CIBLE(apres->suivant)->precedent = m;
+    PUBLIER(m->suivant,
+            AVEC_FIN(apres->suivant, MARQUE_FIN(m->suivant)));
+    maillon_recycler(l, apres);
   }
 }
 
-/* \brief la structure définit 3 champs supplémentaires qui sont des pointeurs
- * sur fonction.
+/*!
+ * \brief Valeur enregistrée dans la trace : l'entier lui-même pour une liste
+ * d'entiers stockés dans les maillons, 0 pour les autres.
  */
-struct liste_struct {
-  unsigned int taille;
-  maillon tete;
-  maillon pied;
-  maillon courant;
-  void (*copier)(
-      void *val,
-      void **pt); /* pour définir la valeur du maillon à partir d'une recopie */
-  void (*afficher)(
-      FILE *f,
-      void *val); /* pour définir comment on affiche la valeur du maillon */
-  void (*detruire)(void **pt); /* pour définir comment désallouer la mémoire
-                                  relative à la valeur du maillon */
-};
+static int trace_valeur(liste const l, void const *val) {
+  return l->en_ligne && l->taille_valeur == sizeof(int) ? *(int const *)val
+                                                         : 0;
+}
 
-liste liste_creer(void (*_copier)(void *val, void **pt),
-                  void (*_afficher)(FILE *f, void *val),
-                  void (*_detruire)(void **pt)) {
-  assert(_copier != NULL && _afficher != NULL && _detruire != NULL);
+/*!
+ * \brief La liste, modifiée par une opération qui n'a pas d'équivalent dans
+ * listes_int, n'est plus tracée.
+ */
+static void trace_abandonner(liste const l) {
+  TRACER(l, TRACE_ABANDON);
+  l->trace = 0;
+}
+
+/*!
+ * \brief Allocation d'une liste vide, sans vérification des fonctions.
+ */
+static liste liste_allouer(void (*_copier)(void *val, void **pt),
+                           void (*_afficher)(FILE *f, void *val),
+                           void (*_detruire)(void **pt)) {
   liste l = malloc(sizeof(struct liste_struct));
   l->tete = NULL;
   l->courant = NULL;
@@ -205,16 +633,156 @@ liste liste_creer(void (*_copier)(void *val, void **pt),
   l->copier = _copier;
   l->afficher = _afficher;
   l->detruire = _detruire;
+  l->taille = 0;
+  l->recycles = NULL;
+  l->nb_recycles = 0;
+  l->max_recycles = LISTE_RECYCLAGE_DEFAUT;
+  l->taille_valeur = 0;
+  l->nb_allocations = 0;
+  l->en_ligne = false;
+  l->blocs = NULL;
+  l->nb_blocs = 0;
+  l->capacite_blocs = 0;
+  l->a_compacter = NULL;
+  l->concurrente = false;
+  l->epoque = 1;
+  l->differes[0] = l->differes[1] = l->differes[2] = NULL;
+  l->nb_differes = 0;
+  l->lecteurs = NULL;
+  pthread_mutex_init(&l->verrou_lecteurs, NULL);
+  l->differee.suivante = NULL;
+  l->trace = 0;
+  l->externe = NULL;
   return l;
 }
 
+liste liste_creer(void (*_copier)(void *val, void **pt),
+                  void (*_afficher)(FILE *f, void *val),
+                  void (*_detruire)(void **pt)) {
+  assert(_copier != NULL && _afficher != NULL && _detruire != NULL);
+  liste l = liste_allouer(_copier, _afficher, _detruire);
+  l->trace = listes_trace_creation(TRACE_MODULE_GENERIQUES);
+  return l;
+}
+
+liste liste_creer_pod(size_t taille_valeur,
+                      void (*_afficher)(FILE *f, void *val)) {
+  assert(taille_valeur > 0 && _afficher != NULL);
+  liste l = liste_allouer(NULL, _afficher, NULL);
+  l->taille_valeur = taille_valeur;
+  l->en_ligne = true;
+  l->trace = listes_trace_creation(TRACE_MODULE_POD);
+  return l;
+}
+
+/*! \brief Affichage d'un entier des listes créées par liste_creer_int. */
+static void afficher_entier(FILE *f, void *val) {
+  fprintf(f, "%d ", *(int *)val);
+}
+
+liste liste_creer_int(void) {
+  return liste_creer_pod(sizeof(int), &afficher_entier);
+}
+
+liste liste_creer_externe(size_t taille_valeur,
+                          void (*_afficher)(FILE *f, void *val),
+                          char const *repertoire, size_t budget) {
+  assert(taille_valeur > 0 && _afficher != NULL);
+  externe e = externe_creer(taille_valeur, repertoire, budget);
+  if (e == NULL) {
+    return NULL;
+  }
+  liste l = liste_allouer(NULL, _afficher, NULL);
+  l->taille_valeur = taille_valeur;
+  l->en_ligne = true;
+  l->max_recycles = 0;
+  l->externe = e;
+  l->trace = listes_trace_creation(TRACE_MODULE_POD);
+  return l;
+}
+
+void liste_externe_budget(liste l, size_t budget) {
+  ASSERT_LISTE();
+  assert(l->externe != NULL);
+  externe_budget(l->externe, budget);
+}
+
 void liste_detruire(liste *l) {
   ASSERT_LISTE();
-  maillon_detruire(&(*l)->tete, (*l)->detruire);
+  TRACER(*l, TRACE_DETRUIRE);
+  assert((*l)->lecteurs == NULL);
+  for (unsigned int i = 0; i < 3; i++) {
+    differes_ranger(*l, i);
+  }
+  if ((*l)->tete != NULL) {
+    (*l)->pied->suivant = (*l)->tete;
+    maillon_detruire(*l, &(*l)->tete);
+  }
+  liste_recyclage_reduire(*l, 0);
+  blocs_oublier(*l);
+  if ((*l)->externe != NULL) {
+    externe_detruire(&(*l)->externe);
+  }
+  pthread_mutex_destroy(&(*l)->verrou_lecteurs);
   free(*l);
   *l = NULL;
 }
 
+/*!
+ * \brief Libère une liste retirée de la file, par lots de DESTRUCTION_LOT
+ * maillons : ses valeurs, ses maillons différés et recyclés, puis la liste.
+ * Ses maillons s'arrêtent à NULL.
+ */
+static void destruction_liberer(void *a_liberer) {
+  liste const l = a_liberer;
+  maillon m = l->tete;
+  unsigned long nb = 0;
+  while (m != NULL) {
+    maillon suivant = m->suivant;
+    maillon_liberer(l, m);
+    m = suivant;
+    if (++nb == DESTRUCTION_LOT) {
+      listes_destruction_lot(nb);
+      nb = 0;
+    }
+  }
+  for (unsigned int i = 0; i < 3; i++) {
+    differes_ranger(l, i);
+  }
+  liste_recyclage_reduire(l, 0);
+  blocs_oublier(l);
+  pthread_mutex_destroy(&l->verrou_lecteurs);
+  free(l);
+}
+
+void liste_detruire_differe(liste *l) {
+  ASSERT_LISTE();
+  TRACER(*l, TRACE_DETRUIRE_DIFFERE);
+  assert((*l)->lecteurs == NULL);
+  if ((*l)->externe != NULL) {
+    /* seul le fichier est à fermer : rien à différer */
+    (*l)->trace = 0;
+    liste_detruire(l);
+    return;
+  }
+  if ((*l)->tete != NULL) {
+    (*l)->pied->suivant = NULL;
+  }
+  (*l)->differee.liste = *l;
+  (*l)->differee.liberer = &destruction_liberer;
+  if (!listes_destruction_confier(&(*l)->differee)) {
+    /* sans thread, la liste est détruite tout de suite */
+    destruction_liberer(*l);
+  }
+  *l = NULL;
+}
+
+void liste_destructions_attendre(void) { listes_destructions_attendre(); }
+
+void liste_destruction_debit(unsigned long maillons_par_seconde) {
+  listes_destruction_debit(maillons_par_seconde);
+}
+
 /*!
  * \brief Pour ajouter une valeur à une liste vide.
  * \param l liste où ajouter.
@@ -223,8 +791,11 @@ void liste_detruire(liste *l) {
 static void liste_ajouter_a_vide(liste const l, int *const val) {
   ASSERT_LISTE();
   assert(val != NULL);
-  maillon m = maillon_creer(val, l->copier);
-  l->tete = m;
+  maillon m = maillon_creer(l, val);
+  if (l->concurrente) {
+    m->suivant = AVEC_FIN(m, FIN);
+  }
+  PUBLIER(l->tete, m);
   l->pied = m;
   l->taille = 1;
 }
@@ -232,23 +803,33 @@ static void liste_ajouter_a_vide(liste const l, int *const val) {
 /*! \brief Pour enlever la dernière valeur. */
 static void liste_enlever_dernier(liste const l) {
   ASSERT_LISTE();
-  maillon_detruire(&l->tete, l->detruire);
-  l->tete = NULL;
+  maillon_recycler(l, l->tete);
+  PUBLIER(l->tete, NULL);
   l->pied = NULL;
+  l->courant = NULL;
   l->taille = 0;
 }
 
 bool liste_est_vide(liste const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_EST_VIDE);
+  if (l->externe != NULL) {
+    return externe_taille(l->externe) == 0;
+  }
   return l->tete == NULL && l->courant == NULL && l->pied == NULL;
 }
 
 void liste_insertion_debut(liste l, void *val) {
   ASSERT_LISTE();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_DEBUT, trace_valeur(l, val));
   assert(val != NULL);
-  if (!liste_est_vide(l)) {
-    maillon_ajouter_avant(l->tete, val, l->copier);
-    l->tete = l->tete->precedent;
+  if (l->externe != NULL) {
+    externe_inserer_debut(l->externe, val);
+    return;
+  }
+  if (l->tete != NULL) {
+    maillon_ajouter_avant(l, l->tete, val);
+    PUBLIER(l->tete, l->tete->precedent);
     l->taille++;
   } else {
     liste_ajouter_a_vide(l, val);
@@ -257,9 +838,14 @@ void liste_insertion_debut(liste l, void *val) {
 
 void liste_insertion_fin(liste l, void *val) {
   ASSERT_LISTE();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_FIN, trace_valeur(l, val));
   assert(val != NULL);
-  if (!liste_est_vide(l)) {
-    maillon_ajouter_apres(l->pied, val, l->copier);
+  if (l->externe != NULL) {
+    externe_inserer_fin(l->externe, val);
+    return;
+  }
+  if (l->tete != NULL) {
+    maillon_ajouter_apres(l, l->pied, val);
     l->pied = l->pied->suivant;
     l->taille++;
   } else {
@@ -269,18 +855,28 @@ void liste_insertion_fin(liste l, void *val) {
 
 void liste_insertion_avant(liste l, void *val) {
   ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_AVANT, trace_valeur(l, val));
   assert(val != NULL);
-  maillon_ajouter_avant(l->courant, val, l->copier);
+  if (l->externe != NULL) {
+    externe_inserer_avant(l->externe, val);
+    return;
+  }
+  maillon_ajouter_avant(l, l->courant, val);
   l->taille++;
   if (l->courant == l->tete) {
-    l->tete = l->courant->precedent;
+    PUBLIER(l->tete, l->courant->precedent);
   }
 }
 
 void liste_insertion_apres(liste l, void *val) {
   ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_APRES, trace_valeur(l, val));
   assert(val != NULL);
-  maillon_ajouter_apres(l->courant, val, l->copier);
+  if (l->externe != NULL) {
+    externe_inserer_apres(l->externe, val);
+    return;
+  }
+  maillon_ajouter_apres(l, l->courant, val);
   l->taille++;
   if (l->courant == l->pied) {
     l->pied = l->courant->suivant;
@@ -289,9 +885,14 @@ void liste_insertion_apres(liste l, void *val) {
 
 void liste_suppression_debut(liste l) {
   ASSERT_LISTE();
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_avant(l->tete->suivant, l->detruire);
-    l->tete = l->pied->suivant;
+  TRACER(l, TRACE_SUPPRESSION_DEBUT);
+  if (l->externe != NULL) {
+    externe_supprimer_debut(l->externe);
+    return;
+  }
+  if (l->taille >= 2) {
+    maillon_supprimer_avant(l, l->tete->suivant);
+    PUBLIER(l->tete, CIBLE(l->pied->suivant));
     l->taille--;
   } else {
     liste_enlever_dernier(l);
@@ -300,8 +901,13 @@ void liste_suppression_debut(liste l) {
 
 void liste_suppression_fin(liste l) {
   ASSERT_LISTE();
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_apres(l->pied->precedent, l->detruire);
+  TRACER(l, TRACE_SUPPRESSION_FIN);
+  if (l->externe != NULL) {
+    externe_supprimer_fin(l->externe);
+    return;
+  }
+  if (l->taille >= 2) {
+    maillon_supprimer_apres(l, l->pied->precedent);
     l->pied = l->tete->precedent;
     l->taille--;
   } else {
@@ -311,9 +917,17 @@ void liste_suppression_fin(liste l) {
 
 void liste_suppression_avant(liste l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_SUPPRESSION_AVANT);
+  if (l->externe != NULL) {
+    externe_supprimer_avant(l->externe);
+    return;
+  }
   assert(l->courant != NULL);
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_avant(l->courant, l->detruire);
+  if (l->taille >= 2) {
+    if (l->courant->precedent == l->tete) {
+      PUBLIER(l->tete, l->courant);
+    }
+    maillon_supprimer_avant(l, l->courant);
     l->taille--;
     if (l->courant == l->tete) {
       l->pied = l->tete->precedent;
@@ -325,12 +939,22 @@ void liste_suppression_avant(liste l) {
 
 void liste_suppression_apres(liste l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_SUPPRESSION_APRES);
+  if (l->externe != NULL) {
+    externe_supprimer_apres(l->externe);
+    return;
+  }
   assert(l->courant != NULL);
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_apres(l->courant, l->detruire);
+  if (l->taille >= 2) {
+    /* le pied est mis à jour après le retrait, cf. maillon_recycler */
+    bool pied = CIBLE(l->courant->suivant) == l->pied;
+    maillon_supprimer_apres(l, l->courant);
+    if (pied) {
+      l->pied = l->courant;
+    }
     l->taille--;
     if (l->courant == l->pied) {
-      l->tete = l->pied->suivant;
+      PUBLIER(l->tete, CIBLE(l->pied->suivant));
     }
   } else {
     liste_enlever_dernier(l);
@@ -340,54 +964,886 @@ void liste_suppression_apres(liste l) {
 void liste_affichage(FILE *f, liste l) {
   assert(f != NULL);
   ASSERT_LISTE();
+  TRACER(l, TRACE_AFFICHAGE);
+  if (l->externe != NULL) {
+    fprintf(f, "Liste de %zu éléments : ", externe_taille(l->externe));
+    externe_afficher(f, l->externe, l->afficher);
+    return;
+  }
   fprintf(f, "Liste de %d éléments : ", l->taille);
   maillon_afficher(f, l->tete, l->pied, l->afficher);
 }
 
 void liste_decalage(liste l, int n) {
   ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_DECALAGE, n);
+  if (l->externe != NULL) {
+    externe_decalage(l->externe, n);
+    return;
+  }
   for (int i = 0; i < n; i++) {
-    l->courant = l->courant->suivant;
+    l->courant = CIBLE(l->courant->suivant);
   }
 }
 
 unsigned int liste_taille(liste l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_TAILLE);
+  if (l->externe != NULL) {
+    assert(externe_taille(l->externe) <= UINT_MAX);
+    return (unsigned int)externe_taille(l->externe);
+  }
+  return l->taille;
+}
+
+size_t liste_taille_etendue(liste l) {
+  ASSERT_LISTE();
+  TRACER(l, TRACE_TAILLE);
+  if (l->externe != NULL) {
+    return externe_taille(l->externe);
+  }
   return l->taille;
 }
 
 // TODO assert ?
 void *liste_valeur_tete(liste l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_VALEUR_TETE);
+  if (l->externe != NULL) {
+    return externe_valeur_tete(l->externe);
+  }
   return l->tete->val;
 }
 
 void *liste_valeur_pied(liste l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_VALEUR_PIED);
+  if (l->externe != NULL) {
+    return externe_valeur_pied(l->externe);
+  }
   return l->pied->val;
 }
 
 void *liste_valeur_courant(liste l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_VALEUR_COURANT);
+  if (l->externe != NULL) {
+    return externe_valeur_courant(l->externe);
+  }
   return l->courant->val;
 }
 
 bool liste_est_tete(liste l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_EST_TETE);
+  if (l->externe != NULL) {
+    return externe_est_tete(l->externe);
+  }
   return l->courant == l->tete;
 }
 
 bool liste_est_pied(liste l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_EST_PIED);
+  if (l->externe != NULL) {
+    return externe_est_pied(l->externe);
+  }
   return l->courant == l->pied;
 }
 
 void liste_courant_init(liste l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_COURANT_INIT);
+  if (l->externe != NULL) {
+    externe_courant_init(l->externe);
+    return;
+  }
   l->courant = l->tete;
 }
 
 void liste_courant_suivant(liste l) {
   ASSERT_LISTE_COURANT();
-  l->courant = l->courant->suivant;
+  TRACER(l, TRACE_COURANT_SUIVANT);
+  if (l->externe != NULL) {
+    externe_courant_suivant(l->externe);
+    return;
+  }
+  l->courant = CIBLE(l->courant->suivant);
+}
+
+void liste_recyclage(liste l, unsigned int max_recycles, size_t taille_valeur) {
+  ASSERT_LISTE();
+  if (l->externe != NULL) {
+    /* une liste externe n'a pas de maillon à recycler */
+    return;
+  }
+  /* les valeurs en ligne font partie du maillon */
+  assert(!l->en_ligne || taille_valeur == l->taille_valeur);
+  if (taille_valeur != l->taille_valeur) {
+    /* les maillons conservés ne correspondent plus au mode demandé */
+    liste_recyclage_reduire(l, 0);
+    l->taille_valeur = taille_valeur;
+  }
+  l->max_recycles = max_recycles;
+  liste_recyclage_reduire(l, max_recycles);
+}
+
+void liste_recyclage_reduire(liste l, unsigned int n) {
+  ASSERT_LISTE();
+  while (l->nb_recycles > n) {
+    maillon m = l->recycles;
+    l->recycles = m->suivant;
+    l->nb_recycles--;
+    maillon_liberer(l, m);
+  }
+}
+
+unsigned int liste_nb_recycles(liste l) {
+  ASSERT_LISTE();
+  return l->nb_recycles;
+}
+
+unsigned long long liste_nb_allocations(liste l) {
+  ASSERT_LISTE();
+  if (l->externe != NULL) {
+    return externe_nb_allocations(l->externe);
+  }
+  return l->nb_allocations;
+}
+
+liste liste_scinder(liste l, unsigned int n) {
+  ASSERT_LISTE();
+  trace_abandonner(l);
+  assert(l->externe == NULL);
+  assert(n <= l->taille);
+  assert(!l->concurrente);
+  liste suite = liste_allouer(l->copier, l->afficher, l->detruire);
+  suite->max_recycles = l->max_recycles;
+  suite->taille_valeur = l->taille_valeur;
+  suite->en_ligne = l->en_ligne;
+  /* les maillons de suite peuvent être dans tous les blocs de l */
+  for (unsigned int i = 0; i < l->nb_blocs; i++) {
+    __atomic_add_fetch(&l->blocs[i]->inscriptions, 1, __ATOMIC_RELAXED);
+    bloc_inscrire(suite, l->blocs[i]);
+  }
+  l->courant = NULL;
+  l->a_compacter = NULL;
+  if (n == l->taille) {
+    return suite;
+  }
+  if (n == 0) {
+    suite->tete = l->tete;
+    suite->pied = l->pied;
+    suite->taille = l->taille;
+    l->tete = l->pied = NULL;
+    l->taille = 0;
+    return suite;
+  }
+  /* dernier maillon conservé, atteint par le plus court des deux sens */
+  maillon dernier;
+  if (n <= l->taille / 2) {
+    dernier = l->tete;
+    for (unsigned int i = 1; i < n; i++) {
+      dernier = dernier->suivant;
+    }
+  } else {
+    dernier = l->pied;
+    for (unsigned int i = l->taille; i > n; i--) {
+      dernier = dernier->precedent;
+    }
+  }
+  suite->tete = dernier->suivant;
+  suite->pied = l->pied;
+  suite->taille = l->taille - n;
+  suite->pied->suivant = suite->tete;
+  suite->tete->precedent = suite->pied;
+  l->pied = dernier;
+  l->taille = n;
+  l->pied->suivant = l->tete;
+  l->tete->precedent = l->pied;
+  return suite;
+}
+
+void liste_concatener(liste l, liste *suite) {
+  ASSERT_LISTE();
+  trace_abandonner(l);
+  assert(suite != NULL && *suite != NULL);
+  liste s = *suite;
+  assert(l->externe == NULL && s->externe == NULL);
+  assert(s->en_ligne == l->en_ligne);
+  assert(!l->concurrente && !s->concurrente);
+  if (s->tete != NULL) {
+    if (l->tete == NULL) {
+      l->tete = s->tete;
+      l->pied = s->pied;
+    } else {
+      l->pied->suivant = s->tete;
+      s->tete->precedent = l->pied;
+      s->pied->suivant = l->tete;
+      l->tete->precedent = s->pied;
+      l->pied = s->pied;
+    }
+    l->taille += s->taille;
+    s->tete = s->pied = NULL;
+  }
+  l->nb_allocations += s->nb_allocations;
+  /* les maillons recyclés de s sont libérés avant qu'elle ne cède ses blocs */
+  liste_recyclage_reduire(s, 0);
+  blocs_transferer(l, s);
+  liste_detruire(suite);
+}
+
+bool liste_est_valide(liste l) {
+  ASSERT_LISTE();
+  if (l->externe != NULL) {
+    return l->taille == 0 && l->tete == NULL && l->nb_recycles == 0 &&
+           externe_est_valide(l->externe);
+  }
+  if (l->taille == 0) {
+    return l->tete == NULL && l->pied == NULL && l->courant == NULL;
+  }
+  if (l->tete == NULL || l->pied == NULL || l->tete->precedent != l->pied) {
+    return false;
+  }
+  bool courant_trouve = l->courant == NULL;
+  bool a_compacter_trouve = l->a_compacter == NULL;
+  maillon m = l->tete;
+  for (unsigned int i = 0; i < l->taille; i++) {
+    if (m == NULL || m->val == NULL || m->suivant == NULL ||
+        CIBLE(m->suivant)->precedent != m ||
+        (MARQUE_FIN(m->suivant) != 0) != (l->concurrente && m == l->pied)) {
+      return false;
+    }
+    courant_trouve = courant_trouve || m == l->courant;
+    a_compacter_trouve = a_compacter_trouve || m == l->a_compacter;
+    m = CIBLE(m->suivant);
+  }
+  // Après taille maillons, l'anneau doit être refermé exactement
+  if (m != l->tete || !courant_trouve || !a_compacter_trouve) {
+    return false;
+  }
+  unsigned int nb_recycles = 0;
+  for (m = l->recycles; m != NULL; m = m->suivant) {
+    nb_recycles++;
+    if (nb_recycles > l->nb_recycles) {
+      return false;
+    }
+  }
+  return nb_recycles == l->nb_recycles && nb_recycles <= l->max_recycles;
+}
+
+/*!
+ * \brief Taille d'un emplacement de maillon dans un bloc, valeur en ligne
+ * comprise, arrondie pour que chaque maillon reste aligné.
+ * \param l liste compactée.
+ */
+static size_t maillon_emplacement(liste l) {
+  size_t taille = sizeof(struct maillon_struct);
+  if (l->en_ligne) {
+    taille += l->taille_valeur;
+  }
+  return (taille + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+}
+
+/*!
+ * \brief Déplace un maillon de la liste vers un emplacement libre, sans
+ * recopie de la valeur sauf si elle est en ligne, puis libère l'ancien.
+ * \param l liste à laquelle appartient le maillon.
+ * \param m maillon à déplacer.
+ * \param n emplacement qui le remplace.
+ */
+static void maillon_deplacer(liste l, maillon m, maillon n) {
+  if (l->en_ligne) {
+    n->val = n + 1;
+    memcpy(n->val, m->val, l->taille_valeur);
+  } else {
+    n->val = m->val;
+  }
+  if (maillon_est_unique(m)) {
+    n->precedent = n->suivant = n;
+  } else {
+    n->precedent = m->precedent;
+    n->suivant = m->suivant;
+    n->precedent->suivant = n;
+    n->suivant->precedent = n;
+  }
+  if (l->tete == m) {
+    l->tete = n;
+  }
+  if (l->pied == m) {
+    l->pied = n;
+  }
+  if (l->courant == m) {
+    l->courant = n;
+  }
+  maillon_memoire_liberer(l, m);
+}
+
+bool liste_compacter_etape(liste l, unsigned int k) {
+  ASSERT_LISTE();
+  TRACER_ARGUMENT(l, TRACE_COMPACTER_ETAPE, (int)k);
+  assert(k > 0);
+  assert(l->externe == NULL);
+  /* les maillons déplacés seraient libérés sous les lecteurs */
+  assert(!l->concurrente);
+  if (l->tete == NULL) {
+    l->a_compacter = NULL;
+    return true;
+  }
+  maillon m = l->a_compacter != NULL ? l->a_compacter : l->tete;
+  unsigned int nb = 1;
+  for (maillon p = m; p != l->pied && nb < k; p = p->suivant) {
+    nb++;
+  }
+  size_t emplacement = maillon_emplacement(l);
+  char *memoire = bloc_allouer(l, nb, emplacement);
+  bool fini = false;
+  for (unsigned int i = 0; i < nb; i++) {
+    maillon suivant = m->suivant;
+    fini = m == l->pied;
+    maillon_deplacer(l, m, (maillon)(memoire + i * emplacement));
+    m = suivant;
+  }
+  l->a_compacter = fini ? NULL : m;
+  return fini;
+}
+
+void liste_compacter(liste l) {
+  ASSERT_LISTE();
+  TRACER(l, TRACE_COMPACTER);
+  assert(l->externe == NULL);
+  l->a_compacter = NULL;
+  if (l->taille > 0) {
+    SANS_TRACE(l, liste_compacter_etape(l, l->taille));
+  }
+}
+
+/*!
+ * \brief Insertion d'un maillon détaché après un maillon de la liste.
+ */
+static void maillon_lier_apres(maillon m, maillon nouveau) {
+  nouveau->precedent = m;
+  nouveau->suivant = m->suivant;
+  m->suivant->precedent = nouveau;
+  PUBLIER(m->suivant, nouveau);
+}
+
+/*!
+ * \brief Enregistre un appel à liste_remplacer_courant.
+ */
+static void trace_remplacer(liste const l, void *const *vals, unsigned int k,
+                            unsigned int position) {
+  int *arguments = malloc((k + 2) * sizeof(int));
+  assert(arguments != NULL);
+  arguments[0] = (int)k;
+  arguments[1] = (int)position;
+  for (unsigned int i = 0; i < k; i++) {
+    arguments[i + 2] = trace_valeur(l, vals[i]);
+  }
+  listes_trace_appel(l->trace, TRACE_REMPLACER_COURANT, arguments, k + 2);
+  free(arguments);
+}
+
+void liste_remplacer_courant(liste l, void *const *vals, unsigned int k,
+                             unsigned int position) {
+  ASSERT_LISTE_COURANT();
+  assert(vals != NULL && k > 0 && position < k);
+  if (l->trace != 0) {
+    trace_remplacer(l, vals, k, position);
+  }
+  if (l->externe != NULL) {
+    externe_remplacer_courant(l->externe, vals, k, position);
+    return;
+  }
+  /* la valeur courante est écrasée sur place */
+  assert(!l->concurrente);
+  maillon m = l->courant;
+  if (l->taille_valeur != 0) {
+    memcpy(m->val, vals[0], l->taille_valeur);
+  } else {
+    l->detruire(&(m->val));
+    l->copier(vals[0], &(m->val));
+    l->nb_allocations++;
+  }
+  maillon dernier = m;
+  unsigned int i = 1;
+  /* les maillons recyclés d'abord, les autres alloués ensemble */
+  for (; i < k && (l->recycles != NULL || i + 1 == k); i++) {
+    maillon_lier_apres(dernier, maillon_creer(l, vals[i]));
+    dernier = dernier->suivant;
+    if (i == position) {
+      l->courant = dernier;
+    }
+  }
+  if (i < k) {
+    size_t emplacement = maillon_emplacement(l);
+    char *memoire = bloc_allouer(l, k - i, emplacement);
+    l->nb_allocations++;
+    for (; i < k; i++, memoire += emplacement) {
+      maillon n = (maillon)memoire;
+      if (l->en_ligne) {
+        n->val = n + 1;
+        memcpy(n->val, vals[i], l->taille_valeur);
+      } else {
+        l->copier(vals[i], &(n->val));
+        l->nb_allocations++;
+      }
+      maillon_lier_apres(dernier, n);
+      dernier = n;
+      if (i == position) {
+        l->courant = n;
+      }
+    }
+  }
+  if (l->pied == m) {
+    l->pied = dernier;
+  }
+  l->taille += k - 1;
+}
+
+void liste_concurrente(liste l, bool concurrente) {
+  ASSERT_LISTE();
+  assert(!concurrente || l->externe == NULL);
+  if (!concurrente && l->concurrente) {
+    assert(l->lecteurs == NULL);
+    for (unsigned int i = 0; i < 3; i++) {
+      differes_ranger(l, i);
+    }
+  }
+  if (l->tete != NULL) {
+    /* aucun lecteur n'existe encore, ou plus */
+    l->pied->suivant = AVEC_FIN(l->tete, concurrente ? FIN : 0);
+  }
+  l->concurrente = concurrente;
+}
+
+void liste_synchroniser(liste l) {
+  ASSERT_LISTE();
+  assert(l->concurrente);
+  /* trois avancées rangent les maillons différés des trois époques */
+  for (unsigned int avancees = 0; avancees < 3;) {
+    if (epoque_avancer(l)) {
+      avancees++;
+    } else {
+      sched_yield();
+    }
+  }
+}
+
+lecteur liste_lecteur_creer(liste l) {
+  ASSERT_LISTE();
+  assert(l->concurrente);
+  lecteur r = malloc(sizeof(struct lecteur_struct));
+  r->l = l;
+  r->epoque = 0;
+  r->position = NULL;
+  pthread_mutex_lock(&l->verrou_lecteurs);
+  r->suivant = l->lecteurs;
+  l->lecteurs = r;
+  pthread_mutex_unlock(&l->verrou_lecteurs);
+  return r;
+}
+
+void liste_lecteur_detruire(lecteur *r) {
+  assert(r != NULL && *r != NULL && (*r)->epoque == 0);
+  liste l = (*r)->l;
+  pthread_mutex_lock(&l->verrou_lecteurs);
+  lecteur *p = &l->lecteurs;
+  while (*p != *r) {
+    p = &(*p)->suivant;
+  }
+  *p = (*r)->suivant;
+  pthread_mutex_unlock(&l->verrou_lecteurs);
+  free(*r);
+  *r = NULL;
+}
+
+void liste_lecture_debut(lecteur r) {
+  assert(r != NULL && r->epoque == 0);
+  __atomic_store_n(&r->epoque, __atomic_load_n(&r->l->epoque, __ATOMIC_ACQUIRE),
+                   __ATOMIC_SEQ_CST);
+  /* l'époque est visible de l'écrivain avant toute lecture de maillon */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void liste_lecture_fin(lecteur r) {
+  assert(r != NULL && r->epoque != 0);
+  r->position = NULL;
+  __atomic_store_n(&r->epoque, 0, __ATOMIC_RELEASE);
+}
+
+void *liste_lecture_premier(lecteur r) {
+  assert(r != NULL && r->epoque != 0);
+  r->position = LIRE(r->l->tete);
+  return r->position == NULL ? NULL : r->position->val;
+}
+
+void *liste_lecture_suivant(lecteur r) {
+  assert(r != NULL && r->epoque != 0 && r->position != NULL);
+  maillon m = LIRE(r->position->suivant);
+  if (MARQUE_FIN(m) != 0) {
+    r->position = NULL;
+    return NULL;
+  }
+  r->position = CIBLE(m);
+  return r->position->val;
+}
+
+unsigned int liste_lecture_taille(lecteur r) {
+  assert(r != NULL);
+  return __atomic_load_n(&r->l->taille, __ATOMIC_RELAXED);
+}
+
+/*!
+ * \brief Fusion stable de deux chaînes triées terminées par NULL : à valeurs
+ * égales, les maillons de a passent en premier.
+ * \param a première chaîne, de la partie initiale de la liste.
+ * \param b seconde chaîne.
+ * \param comparer fonction de comparaison des valeurs.
+ * \param fin (pointeur vers le) dernier maillon de la fusion, ou NULL.
+ * \return la tête de la chaîne fusionnée.
+ */
+static maillon chaine_fusionner(maillon a, maillon b,
+                                int (*comparer)(void const *, void const *),
+                                maillon *fin) {
+  struct maillon_struct tete;
+  maillon dernier = &tete;
+  while (a != NULL && b != NULL) {
+    if (comparer(b->val, a->val) < 0) {
+      dernier->suivant = b;
+      b = b->suivant;
+    } else {
+      dernier->suivant = a;
+      a = a->suivant;
+    }
+    dernier = dernier->suivant;
+  }
+  dernier->suivant = a != NULL ? a : b;
+  if (fin != NULL) {
+    while (dernier->suivant != NULL) {
+      dernier = dernier->suivant;
+    }
+    *fin = dernier;
+  }
+  return tete.suivant;
+}
+
+/*! \brief Suite triée en cours de fusion par chaine_trier. */
+typedef struct suite_triee {
+  maillon tete;
+  unsigned int taille;
+} suite_triee;
+
+/*!
+ * \brief Détache la suite triée qui commence au début de la chaîne : la plus
+ * longue suite croissante, ou strictement décroissante (alors retournée),
+ * complétée par insertion jusqu'à TRI_SUITE_MIN maillons.
+ * \param chaine (pointeur vers la) chaîne, avancée après la suite.
+ * \param comparer fonction de comparaison des valeurs.
+ * \return la suite détachée.
+ */
+static suite_triee chaine_suite(maillon *chaine,
+                                int (*comparer)(void const *, void const *)) {
+  maillon tete = *chaine;
+  maillon fin = tete;
+  maillon m = tete->suivant;
+  unsigned int taille = 1;
+  if (m != NULL && comparer(m->val, tete->val) < 0) {
+    /* suite strictement décroissante : la retourner reste stable */
+    tete->suivant = NULL;
+    while (m != NULL && comparer(m->val, tete->val) < 0) {
+      maillon suivant = m->suivant;
+      m->suivant = tete;
+      tete = m;
+      m = suivant;
+      taille++;
+    }
+  } else {
+    while (m != NULL && comparer(m->val, fin->val) >= 0) {
+      fin = m;
+      m = m->suivant;
+      taille++;
+    }
+  }
+  /* insertion des maillons suivants, après leurs égaux pour la stabilité */
+  while (m != NULL && taille < TRI_SUITE_MIN) {
+    maillon suivant = m->suivant;
+    if (comparer(m->val, fin->val) >= 0) {
+      fin->suivant = m;
+      fin = m;
+    } else if (comparer(m->val, tete->val) < 0) {
+      m->suivant = tete;
+      tete = m;
+    } else {
+      maillon p = tete;
+      while (comparer(m->val, p->suivant->val) >= 0) {
+        p = p->suivant;
+      }
+      m->suivant = p->suivant;
+      p->suivant = m;
+    }
+    m = suivant;
+    taille++;
+  }
+  fin->suivant = NULL;
+  *chaine = m;
+  suite_triee s = {tete, taille};
+  return s;
+}
+
+/*!
+ * \brief Tri fusion naturel ascendant d'une chaîne terminée par NULL.
+ * Les suites déjà triées sont empilées puis fusionnées deux à deux en gardant
+ * des tailles décroissantes dans la pile (comme le tri de Tim Peters) : la
+ * pile reste de hauteur logarithmique et les fusions équilibrées.
+ * \param chaine chaîne à trier, non vide.
+ * \param comparer fonction de comparaison des valeurs.
+ * \return la tête de la chaîne triée.
+ */
+static maillon chaine_trier(maillon chaine,
+                            int (*comparer)(void const *, void const *)) {
+  suite_triee pile[TRI_PILE_MAX];
+  unsigned int hauteur = 0;
+  while (chaine != NULL) {
+    assert(hauteur < TRI_PILE_MAX);
+    pile[hauteur++] = chaine_suite(&chaine, comparer);
+    while (hauteur > 1) {
+      unsigned int n = hauteur - 2;
+      if ((n > 0 && pile[n - 1].taille <= pile[n].taille + pile[n + 1].taille) ||
+          (n > 1 && pile[n - 2].taille <= pile[n - 1].taille + pile[n].taille)) {
+        if (pile[n - 1].taille < pile[n + 1].taille) {
+          n--;
+        }
+      } else if (pile[n].taille > pile[n + 1].taille) {
+        break;
+      }
+      pile[n].tete =
+          chaine_fusionner(pile[n].tete, pile[n + 1].tete, comparer, NULL);
+      pile[n].taille += pile[n + 1].taille;
+      memmove(pile + n + 1, pile + n + 2,
+              (hauteur - n - 2) * sizeof(suite_triee));
+      hauteur--;
+    }
+  }
+  while (hauteur > 1) {
+    pile[hauteur - 2].tete = chaine_fusionner(
+        pile[hauteur - 2].tete, pile[hauteur - 1].tete, comparer, NULL);
+    hauteur--;
+  }
+  return pile[0].tete;
+}
+
+/*!
+ * \brief Données partagées par les threads d'un tri parallèle.
+ * La liste est découpée en nb_threads segments triés chacun par un thread,
+ * dont les maillons sont ensuite rangés dans un tableau. Les segments sont
+ * fusionnés deux à deux dans l'autre tableau, chaque fusion étant partagée
+ * entre tous les threads, jusqu'à ce qu'il n'en reste qu'un.
+ */
+typedef struct tri_parallele {
+  int (*comparer)(void const *, void const *);
+  unsigned int nb_threads;
+  unsigned int taille;
+  maillon *segments;      /* chaîne de chaque segment */
+  unsigned int *debuts;   /* début de chaque segment, puis la taille */
+  maillon *tableaux[2];   /* maillons avant et après une passe de fusion */
+  unsigned int resultat;  /* tableau qui contient le résultat */
+  pthread_barrier_t barriere;
+} tri_parallele;
+
+/*! \brief Travail d'un thread du tri parallèle : son numéro. */
+typedef struct trieur {
+  tri_parallele *t;
+  unsigned int numero;
+} trieur;
+
+/*!
+ * \brief Nombre d'éléments de a parmi les d premiers de la fusion stable de
+ * a et b (recherche dichotomique sur le chemin de fusion).
+ */
+static unsigned int fusion_partage(maillon const *a, unsigned int na,
+                                   maillon const *b, unsigned int nb,
+                                   unsigned int d,
+                                   int (*comparer)(void const *,
+                                                   void const *)) {
+  unsigned int bas = d > nb ? d - nb : 0;
+  unsigned int haut = d < na ? d : na;
+  while (bas < haut) {
+    unsigned int milieu = bas + (haut - bas) / 2;
+    /* a[milieu] précède-t-il b[d - milieu - 1] ? */
+    if (comparer(b[d - milieu - 1]->val, a[milieu]->val) >= 0) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  return bas;
+}
+
+/*!
+ * \brief Fusionne les positions [debut, fin[ de la fusion de deux suites
+ * triées adjacentes source[g..m[ et source[m..d[ dans destination.
+ */
+static void fusion_morceau(maillon const *source, maillon *destination,
+                           unsigned int g, unsigned int m, unsigned int d,
+                           unsigned int debut, unsigned int fin,
+                           int (*comparer)(void const *, void const *)) {
+  maillon const *a = source + g;
+  maillon const *b = source + m;
+  unsigned int na = m - g, nb = d - m;
+  unsigned int i = fusion_partage(a, na, b, nb, debut - g, comparer);
+  unsigned int j = debut - g - i;
+  for (unsigned int k = debut; k < fin; k++) {
+    if (j < nb && (i == na || comparer(b[j]->val, a[i]->val) < 0)) {
+      destination[k] = b[j++];
+    } else {
+      destination[k] = a[i++];
+    }
+  }
+}
+
+/*! \brief Point d'entrée d'un thread du tri parallèle. */
+static void *trier_segment(void *arg) {
+  trieur *w = arg;
+  tri_parallele *t = w->t;
+  unsigned int n = t->nb_threads;
+  unsigned int s = w->numero;
+  /* tri du segment puis rangement de ses maillons */
+  maillon m = chaine_trier(t->segments[s], t->comparer);
+  for (unsigned int i = t->debuts[s]; i < t->debuts[s + 1]; i++) {
+    t->tableaux[0][i] = m;
+    m = m->suivant;
+  }
+  /* les positions de sortie sont réparties également entre les threads */
+  unsigned int debut =
+      (unsigned int)((unsigned long long)t->taille * s / n);
+  unsigned int fin =
+      (unsigned int)((unsigned long long)t->taille * (s + 1) / n);
+  unsigned int source = 0;
+  for (unsigned int largeur = 1; largeur < n; largeur *= 2) {
+    pthread_barrier_wait(&t->barriere);
+    maillon *src = t->tableaux[source];
+    maillon *dst = t->tableaux[1 - source];
+    for (unsigned int p = 0; p < n; p += 2 * largeur) {
+      unsigned int g = t->debuts[p];
+      unsigned int mi = t->debuts[p + largeur < n ? p + largeur : n];
+      unsigned int d = t->debuts[p + 2 * largeur < n ? p + 2 * largeur : n];
+      unsigned int k0 = debut > g ? debut : g;
+      unsigned int k1 = fin < d ? fin : d;
+      if (k0 < k1) {
+        fusion_morceau(src, dst, g, mi, d, k0, k1, t->comparer);
+      }
+    }
+    source = 1 - source;
+  }
+  if (s == 0) {
+    t->resultat = source;
+  }
+  return NULL;
+}
+
+/*!
+ * \brief Rechaîne en anneau les maillons de la chaîne triée.
+ * \param l liste dont la chaîne remplace l'anneau.
+ * \param m tête de la chaîne triée de l->taille maillons.
+ */
+static void liste_rechainer(liste const l, maillon m) {
+  l->tete = m;
+  for (unsigned int i = 1; i < l->taille; i++) {
+    m->suivant->precedent = m;
+    m = m->suivant;
+  }
+  l->pied = m;
+  m->suivant = l->tete;
+  l->tete->precedent = m;
+}
+
+void liste_trier_parallele(liste l,
+                           int (*comparer)(void const *, void const *),
+                           unsigned int nb_threads) {
+  ASSERT_LISTE();
+  assert(comparer != NULL && nb_threads > 0);
+  trace_abandonner(l);
+  assert(l->externe == NULL);
+  assert(!l->concurrente);
+  l->a_compacter = NULL;
+  if (l->taille < 2) {
+    return;
+  }
+  l->pied->suivant = NULL;
+  if (nb_threads <= 1 || l->taille / nb_threads < SEUIL_TRI_PARALLELE) {
+    liste_rechainer(l, chaine_trier(l->tete, comparer));
+    return;
+  }
+  tri_parallele t;
+  t.comparer = comparer;
+  t.nb_threads = nb_threads;
+  t.taille = l->taille;
+  t.segments = malloc(nb_threads * sizeof(maillon));
+  t.debuts = malloc((nb_threads + 1) * sizeof(unsigned int));
+  t.tableaux[0] = malloc(l->taille * sizeof(maillon));
+  t.tableaux[1] = malloc(l->taille * sizeof(maillon));
+  assert(t.segments != NULL && t.debuts != NULL && t.tableaux[0] != NULL &&
+         t.tableaux[1] != NULL);
+  pthread_barrier_init(&t.barriere, NULL, nb_threads);
+  // Découpage en segments contigus terminés par NULL
+  maillon m = l->tete;
+  for (unsigned int s = 0; s < nb_threads; s++) {
+    t.debuts[s] =
+        (unsigned int)((unsigned long long)l->taille * s / nb_threads);
+    unsigned int fin =
+        (unsigned int)((unsigned long long)l->taille * (s + 1) / nb_threads);
+    t.segments[s] = m;
+    for (unsigned int i = t.debuts[s] + 1; i < fin; i++) {
+      m = m->suivant;
+    }
+    maillon suivant = m->suivant;
+    m->suivant = NULL;
+    m = suivant;
+  }
+  t.debuts[nb_threads] = l->taille;
+  // Les threads avancent ensemble de passe en passe (barrière) : ils sont
+  // tous lancés, le thread courant prenant le segment 0.
+  trieur *trieurs = malloc(nb_threads * sizeof(trieur));
+  pthread_t *threads = malloc(nb_threads * sizeof(pthread_t));
+  for (unsigned int s = 0; s < nb_threads; s++) {
+    trieurs[s].t = &t;
+    trieurs[s].numero = s;
+  }
+  for (unsigned int s = 1; s < nb_threads; s++) {
+    int erreur = pthread_create(&threads[s], NULL, &trier_segment, &trieurs[s]);
+    assert(erreur == 0);
+    (void)erreur;
+  }
+  trier_segment(&trieurs[0]);
+  for (unsigned int s = 1; s < nb_threads; s++) {
+    pthread_join(threads[s], NULL);
+  }
+  // Rechaînage dans l'ordre du tableau résultat
+  maillon *tri = t.tableaux[t.resultat];
+  for (unsigned int i = 0; i < l->taille; i++) {
+    tri[i]->suivant = tri[i + 1 < l->taille ? i + 1 : 0];
+    tri[i]->precedent = tri[i > 0 ? i - 1 : l->taille - 1];
+  }
+  l->tete = tri[0];
+  l->pied = tri[l->taille - 1];
+  pthread_barrier_destroy(&t.barriere);
+  free(threads);
+  free(trieurs);
+  free(t.tableaux[0]);
+  free(t.tableaux[1]);
+  free(t.debuts);
+  free(t.segments);
+}
+
+void liste_trier(liste l, int (*comparer)(void const *, void const *)) {
+  /* sysconf coûte plus que le tri d'une petite liste : il est appelé une fois */
+  static long nb_processeurs = 0;
+  long nb = __atomic_load_n(&nb_processeurs, __ATOMIC_RELAXED);
+  if (nb == 0) {
+    nb = sysconf(_SC_NPROCESSORS_ONLN);
+    nb = nb > 1 ? nb : 1;
+    __atomic_store_n(&nb_processeurs, nb, __ATOMIC_RELAXED);
+  }
+  liste_trier_parallele(l, comparer, (unsigned int)nb);
 }
@@ -1,6 +1,7 @@
 #ifndef LISTES_GENERIQUES
 #define LISTES_GENERIQUES
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
 /*! \file
@@ -40,12 +41,98 @@ liste liste_creer(void (*_copie)(void *val, void **pt),
                   void (*_afficher)(FILE *f, void *val),
                   void (*_detruire)(void **pt));
 
+/*!
+ * \brief Création d'une liste vide de valeurs simples : des blocs de
+ * taille_valeur octets sans pointeur interne (entiers, réels, structures
+ * plates…).
+ * Chaque valeur est recopiée dans son maillon même : une insertion ne fait
+ * qu'une allocation et aucun appel de fonction de copie ou de destruction.
+ * Les valeurs sont alignées comme des pointeurs.
+ * La liste s'utilise ensuite comme les autres ; son recyclage garde toujours
+ * les valeurs (liste_recyclage doit être appelée avec taille_valeur).
+ * \param taille_valeur taille en octets des valeurs, non nulle.
+ * \param _afficher une fonction qui définit comment on affiche la valeur du
+ * maillon.
+ * \return une nouvelle liste vide.
+ */
+liste liste_creer_pod(size_t taille_valeur,
+                      void (*_afficher)(FILE *f, void *val));
+
+/*!
+ * \brief Création d'une liste vide d'entiers, stockés comme par
+ * liste_creer_pod et affichés comme \verbatim1 2 3 \endverbatim.
+ * Les valeurs s'insèrent et se lisent par des pointeurs sur int.
+ * \return une nouvelle liste vide.
+ */
+liste liste_creer_int(void);
+
+/*!
+ * \brief Création d'une liste externe vide de valeurs simples de
+ * taille_valeur octets, comme liste_creer_pod, pour les listes plus grandes
+ * que la mémoire. Les valeurs sont rangées par segments de taille fixe dans
+ * l'ordre de la liste ; seuls les segments les plus récemment utilisés
+ * restent en mémoire, dans la limite du budget, les autres sont écrits dans
+ * un fichier temporaire du répertoire, effacé dès sa création. Pendant un
+ * parcours par courant, le segment suivant est lu par anticipation dans un
+ * thread dédié, qui écrit aussi les segments évincés.
+ * Un pointeur rendu par liste_valeur_tete, liste_valeur_pied ou
+ * liste_valeur_courant reste valide jusqu'à l'opération suivante sur la
+ * liste ; la valeur peut être modifiée en place, son segment sera réécrit.
+ * Une liste externe ne peut être ni scindée, ni concaténée, ni compactée, ni
+ * triée, ni parcourue par des lecteurs concurrents ; elle ne recycle rien et
+ * sa destruction différée est immédiate. Sa taille peut dépasser UINT_MAX :
+ * elle se lit alors par liste_taille_etendue, liste_taille la refuse.
+ * \param taille_valeur taille en octets des valeurs, non nulle.
+ * \param _afficher une fonction qui définit comment on affiche une valeur.
+ * \param repertoire répertoire du fichier de débordement, NULL pour TMPDIR
+ * ou à défaut /tmp.
+ * \param budget mémoire des segments en octets, 0 pour 64 Mo ; les segments
+ * font au plus 1 Mo et un huitième du budget.
+ * \return une nouvelle liste vide, NULL si le fichier n'a pas pu être créé.
+ */
+liste liste_creer_externe(size_t taille_valeur,
+                          void (*_afficher)(FILE *f, void *val),
+                          char const *repertoire, size_t budget);
+
+/*!
+ * \brief Change le budget mémoire d'une liste externe ; les segments en trop
+ * sont évincés aux chargements suivants.
+ * \param l liste créée par liste_creer_externe.
+ * \param budget nouveau budget en octets, 0 pour 64 Mo.
+ */
+void liste_externe_budget(liste l, size_t budget);
+
 /*!
  * \brief Destruction de la liste.
  * \param l pointeur vers la liste à détruire.
  */
 void liste_detruire(liste *l);
 
+/*!
+ * \brief Destruction différée de la liste : elle est détachée en temps
+ * constant puis libérée, valeurs comprises, par un thread dédié démarré au
+ * premier appel, sans dépasser le débit fixé par liste_destruction_debit. La
+ * fonction detruire de la liste est donc appelée depuis ce thread. La file,
+ * le thread et le débit sont communs avec liste_int_detruire_differe.
+ * \param l pointeur vers la liste à détruire, sans lecteur, vaut NULL en
+ * sortie.
+ */
+void liste_detruire_differe(liste *l);
+
+/*!
+ * \brief Attend que toutes les listes confiées à liste_detruire_differe
+ * ou à liste_int_detruire_differe soient libérées ; pendant l'attente, le débit n'est plus limité. À appeler
+ * avant la fin du programme.
+ */
+void liste_destructions_attendre(void);
+
+/*!
+ * \brief Débit maximal de la destruction différée, commun aux deux modules
+ * de listes, 20 millions de maillons par seconde par défaut.
+ * \param maillons_par_seconde nouveau débit, 0 pour ne pas le limiter.
+ */
+void liste_destruction_debit(unsigned long maillons_par_seconde);
+
 /*!
  * \brief Pour savoir si une liste est vide ou non.
  * \param l liste à tester.
@@ -154,6 +241,14 @@ void liste_decalage(liste l, int n);
  */
 unsigned int liste_taille(liste l);
 
+/*!
+ * \brief Retourne la taille de la liste, sans limite : seule une liste
+ * externe peut avoir plus de UINT_MAX éléments, que liste_taille refuse.
+ * \param l liste sur laquelle porte la demande.
+ * \return le nombre d'éléments dans la liste.
+ */
+size_t liste_taille_etendue(liste l);
+
 /*!
  * \brief Retourne la valeur de tete.
  * \param l liste sur laquelle porte la demande.
@@ -189,4 +284,214 @@ bool liste_est_tete(liste l);
  */
 bool liste_est_pied(liste l);
 
+/*!
+ * \brief Paramètre le recyclage des maillons de la liste.
+ * Les maillons supprimés sont conservés (au plus max_recycles) et réutilisés
+ * par les insertions suivantes au lieu d'être désalloués puis réalloués.
+ * Par défaut une liste conserve au plus 64 maillons.
+ * Si taille_valeur est non nul, les valeurs sont des blocs de taille_valeur
+ * octets sans pointeur interne : elles sont alors conservées avec leur maillon
+ * et les insertions suivantes les réutilisent par simple recopie au lieu
+ * d'appeler copier et detruire.
+ * Les maillons déjà conservés au-delà de max_recycles sont libérés.
+ * \param l liste à paramétrer.
+ * \param max_recycles nombre maximal de maillons conservés (0 pour désactiver
+ * le recyclage).
+ * \param taille_valeur taille en octets des valeurs, 0 si inconnue.
+ */
+void liste_recyclage(liste l, unsigned int max_recycles, size_t taille_valeur);
+
+/*!
+ * \brief Libère les maillons recyclés pour n'en conserver que n au plus.
+ * \param l liste dont on réduit les maillons conservés.
+ * \param n nombre de maillons à conserver.
+ */
+void liste_recyclage_reduire(liste l, unsigned int n);
+
+/*!
+ * \brief Retourne le nombre de maillons actuellement conservés.
+ * \param l liste sur laquelle porte la demande.
+ * \return le nombre de maillons recyclés disponibles.
+ */
+unsigned int liste_nb_recycles(liste l);
+
+/*!
+ * \brief Retourne le nombre d'allocations faites par la liste depuis sa
+ * création : un maillon alloué et chaque valeur copiée par la fonction de
+ * copie comptent pour une. Les insertions qui réutilisent un maillon recyclé
+ * et sa valeur n'allouent rien. Pour une liste externe, ce sont les segments
+ * créés ou chargés en mémoire.
+ * \param l liste sur laquelle porte la demande.
+ * \return le nombre d'allocations.
+ */
+unsigned long long liste_nb_allocations(liste l);
+
+/*!
+ * \brief Scinde la liste en deux : les n premiers éléments restent dans l,
+ * les suivants sont déplacés, sans recopie, dans une nouvelle liste.
+ * La nouvelle liste a les mêmes fonctions et le même recyclage que l.
+ * Le parcours de l doit être réinitialisé.
+ * \param l liste à scinder.
+ * \param n nombre d'éléments conservés dans l, au plus sa taille.
+ * \return la liste des éléments suivants (éventuellement vide).
+ */
+liste liste_scinder(liste l, unsigned int n);
+
+/*!
+ * \brief Ajoute en fin de l les éléments de suite, sans recopie et en temps
+ * constant, puis détruit suite.
+ * Les deux listes doivent avoir les mêmes fonctions.
+ * \param l liste à compléter.
+ * \param suite (pointeur vers la) liste à ajouter, vaut NULL en sortie.
+ */
+void liste_concatener(liste l, liste *suite);
+
+/*!
+ * \brief Remplace l'élément courant par k éléments, dans l'ordre de vals.
+ * Le maillon courant est réutilisé pour vals[0] (sa valeur est simplement
+ * écrasée si taille_valeur est connue) ; les k - 1 autres viennent des
+ * maillons recyclés, puis d'une seule allocation pour ceux qui manquent.
+ * tete et pied sont mis à jour.
+ * \param l liste parcourue.
+ * \param vals pointeurs vers les k valeurs, recopiées.
+ * \param k nombre de valeurs, non nul.
+ * \param position indice dans vals de l'élément qui devient courant.
+ */
+void liste_remplacer_courant(liste l, void *const *vals, unsigned int k,
+                             unsigned int position);
+
+/*!
+ * \brief Réalloue les maillons de la liste dans un seul bloc contigu, dans
+ * l'ordre du parcours, pour que celui-ci profite des caches après de
+ * nombreuses insertions et suppressions.
+ * Les valeurs ne sont pas recopiées (sauf les valeurs en ligne, cf.
+ * liste_creer_pod) ; tete, pied et courant désignent toujours les mêmes
+ * éléments. Le bloc est libéré avec son dernier maillon.
+ * \param l liste à compacter.
+ */
+void liste_compacter(liste l);
+
+/*!
+ * \brief Compaction incrémentale : déplace au plus k maillons dans un nouveau
+ * bloc, en reprenant le parcours là où l'appel précédent s'est arrêté (à la
+ * tete au premier appel). Les éléments insérés entre deux appels avant ce
+ * point attendent le passage suivant.
+ * \param l liste à compacter.
+ * \param k nombre maximal de maillons déplacés, non nul.
+ * \return true si le pied a été atteint : l'appel suivant repart de tete.
+ */
+bool liste_compacter_etape(liste l, unsigned int k);
+
+/*!
+ * \brief Tri stable de la liste par un tri fusion naturel : les suites déjà
+ * triées (ou strictement décroissantes) sont repérées puis fusionnées.
+ * Les maillons sont rechaînés : les valeurs ne sont ni copiées ni détruites et
+ * courant désigne toujours le même élément. Une grande liste est triée par
+ * segments en parallèle, sur autant de threads que de processeurs, puis
+ * fusionnée en parallèle.
+ * Interdit sur une liste concurrente.
+ * \param l liste à trier.
+ * \param comparer fonction de comparaison de deux valeurs, comme pour qsort.
+ */
+void liste_trier(liste l, int (*comparer)(void const *a, void const *b));
+
+/*!
+ * \brief Comme liste_trier, avec au plus nb_threads threads. Le tri parallèle
+ * utilise deux tableaux de taille pointeurs.
+ * \param l liste à trier.
+ * \param comparer fonction de comparaison de deux valeurs, comme pour qsort.
+ * \param nb_threads nombre de threads, 1 pour un tri séquentiel sans
+ * allocation.
+ */
+void liste_trier_parallele(liste l,
+                           int (*comparer)(void const *a, void const *b),
+                           unsigned int nb_threads);
+
+/*!
+ * \brief Vérifie les invariants de la liste : taille maillons chaînés en
+ * anneau dans les deux sens depuis la tête, pied juste avant la tête, courant
+ * nul ou dans l'anneau, et nombre de maillons recyclés cohérent.
+ * Le coût est linéaire ; la fonction est destinée aux assertions.
+ * \param l liste à vérifier.
+ * \return true ssi tous les invariants sont respectés.
+ */
+bool liste_est_valide(liste l);
+
+/*!
+ * \brief Lecteur concurrent d'une liste, utilisé par un seul thread.
+ * Il est caché et ne doit jamais être manipulé directement.
+ */
+typedef struct lecteur_struct *lecteur;
+
+/*!
+ * \brief Active ou désactive les lectures concurrentes.
+ * Une liste concurrente a un seul écrivain, le thread qui utilise les autres
+ * fonctions du module, et des lecteurs qui la parcourent vers le pied sans
+ * verrou ni attente (cf. liste_lecteur_creer). Les maillons supprimés ne sont
+ * recyclés qu'une fois qu'aucune lecture commencée avant leur suppression
+ * n'est en cours. liste_scinder, liste_concatener, liste_compacter et
+ * liste_remplacer_courant sont interdites sur une liste concurrente.
+ * La désactivation demande qu'aucun lecteur n'existe.
+ * \param l liste concernée.
+ * \param concurrente true pour activer.
+ */
+void liste_concurrente(liste l, bool concurrente);
+
+/*!
+ * \brief Attend que les lectures en cours se terminent, puis recycle les
+ * maillons supprimés jusque-là. Appelée par l'écrivain.
+ * \param l liste concurrente.
+ */
+void liste_synchroniser(liste l);
+
+/*!
+ * \brief Inscrit un lecteur sur une liste concurrente.
+ * \param l liste concurrente à lire.
+ * \return le nouveau lecteur, hors lecture.
+ */
+lecteur liste_lecteur_creer(liste l);
+
+/*!
+ * \brief Désinscrit un lecteur hors lecture.
+ * \param r (pointeur vers le) lecteur, vaut NULL en sortie.
+ */
+void liste_lecteur_detruire(lecteur *r);
+
+/*!
+ * \brief Commence une lecture : les maillons atteints restent valides
+ * jusqu'à liste_lecture_fin. Une lecture doit être courte, car elle retarde
+ * le recyclage des maillons supprimés.
+ * \param r lecteur hors lecture.
+ */
+void liste_lecture_debut(lecteur r);
+
+/*!
+ * \brief Termine une lecture ; les valeurs obtenues ne doivent plus être
+ * utilisées.
+ * \param r lecteur en cours de lecture.
+ */
+void liste_lecture_fin(lecteur r);
+
+/*!
+ * \brief Place le lecteur sur la tete.
+ * \param r lecteur en cours de lecture.
+ * \return la valeur de tete, NULL si la liste est vide.
+ */
+void *liste_lecture_premier(lecteur r);
+
+/*!
+ * \brief Avance le lecteur d'un élément. Un élément inséré ou supprimé
+ * pendant le parcours peut être vu ou non ; les autres sont vus dans l'ordre.
+ * \param r lecteur en cours de lecture placé sur un élément.
+ * \return la valeur suivante, NULL après le pied.
+ */
+void *liste_lecture_suivant(lecteur r);
+
+/*!
+ * \brief Taille de la liste, éventuellement déjà dépassée par l'écrivain.
+ * \param r lecteur.
+ * \return le nombre d'éléments.
+ */
+unsigned int liste_lecture_taille(lecteur r);
+
 #endif
@@ -1,13 +1,63 @@
+#define _POSIX_C_SOURCE 200809L
 #include "listes_int.h"
+#include "listes_destruction.h"
+#include "listes_trace.h"
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define ASSERT_LISTE() assert(l != NULL);
 
 #define ASSERT_LISTE_COURANT()                                                 \
   assert(l != NULL);                                                           \
-  assert(l->courant != NULL);
+  assert(l->chainee ? l->courant != NULL : l->rang_courant != AUCUN_RANG);
+
+/*! \brief Rang du courant d'une liste en anneau sans courant. */
+#define AUCUN_RANG UINT_MAX
+
+/*! \brief Enregistre l'appel dans la trace si la liste est tracée. */
+#define TRACER(l, operation)                                                   \
+  do {                                                                         \
+    if ((l)->trace != 0) {                                                     \
+      listes_trace_appel((l)->trace, (operation), NULL, 0);                    \
+    }                                                                          \
+  } while (0)
+
+/*! \brief Comme TRACER, pour un appel qui a un argument entier. */
+#define TRACER_ARGUMENT(l, operation, argument)                                \
+  do {                                                                         \
+    if ((l)->trace != 0) {                                                     \
+      int const argument_ = (argument);                                        \
+      listes_trace_appel((l)->trace, (operation), &argument_, 1);              \
+    }                                                                          \
+  } while (0)
+
+/*!
+ * \brief Appel d'une fonction publique par une autre, déjà enregistrée : il
+ * n'est pas tracé.
+ */
+#define SANS_TRACE(l, appel)                                                   \
+  do {                                                                         \
+    unsigned long trace_ = (l)->trace;                                         \
+    (l)->trace = 0;                                                            \
+    appel;                                                                     \
+    (l)->trace = trace_;                                                       \
+  } while (0)
+
+/*! \brief Capacité initiale de l'anneau, une puissance de 2. */
+#define ANNEAU_CAPACITE_MIN 8
+
+/*!
+ * \brief Rapport de tailles à partir duquel les opérations ensemblistes
+ * cherchent chaque élément du petit ensemble dans le grand par recherche
+ * exponentielle plutôt que de fusionner.
+ */
+#define GALOP_RAPPORT 32
 
 /*! \file
  * \brief La documentation pour les parties (types, variables, fonctions…)
@@ -33,6 +83,90 @@ struct maillon_struct {
  */
 typedef struct maillon_struct *maillon;
 
+/*!
+ * \brief Bloc de maillons contigus alloué par la compaction. Il n'est libéré
+ * que lorsque son dernier maillon l'est.
+ */
+typedef struct bloc {
+  maillon debut;       /* premier maillon du bloc */
+  maillon fin;         /* juste après le dernier maillon */
+  unsigned int vivants; /* maillons du bloc pas encore libérés */
+} bloc;
+
+/*!
+ * \brief Structure pour la liste en étendant la structure maillon.
+ * Quand la liste est vide, il n'y a pas de liste circulaire (et les pointeurs
+ * convernés valent NULL).
+ * Les blocs de la compaction sont triés par adresse.
+ *
+ * Tant qu'aucune insertion ni suppression n'a été faite au milieu, les
+ * valeurs sont dans un tableau circulaire (anneau) et tete, courant et pied
+ * ne sont pas utilisés. La liste passe définitivement en liste chaînée à la
+ * première modification au milieu (liste_int_chainer).
+*/
+struct liste_int_struct {
+  unsigned int taille;
+  maillon tete;
+  maillon courant;
+  maillon pied;
+  bool chainee;              /* false tant que les valeurs sont dans l'anneau */
+  int *anneau;               /* capacite valeurs, la tete à l'indice debut */
+  unsigned int capacite;     /* 0 ou une puissance de 2 */
+  unsigned int debut;        /* indice de la tete dans anneau */
+  unsigned int rang_courant; /* rang du courant depuis la tete, ou AUCUN_RANG */
+  bloc *blocs;
+  unsigned int nb_blocs;
+  unsigned int capacite_blocs;
+  maillon a_compacter; /* où reprend liste_int_compacter_etape, NULL pour
+                          tete */
+  destruction_attente differee; /* place dans la file de la destruction
+                                   différée */
+  unsigned long trace; /* numéro dans la trace, 0 si la liste n'est pas
+                          tracée */
+};
+
+/*!
+ * \brief Nombre de blocs de la liste qui commencent au plus à m.
+ * \param l liste dont on cherche le bloc.
+ * \param m maillon cherché.
+ * \return l'indice du premier bloc qui commence après m.
+ */
+static unsigned int bloc_position(liste_int const l, maillon const m) {
+  unsigned int bas = 0;
+  unsigned int haut = l->nb_blocs;
+  while (bas < haut) {
+    unsigned int milieu = (bas + haut) / 2;
+    if ((uintptr_t)l->blocs[milieu].debut <= (uintptr_t)m) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  return bas;
+}
+
+/*!
+ * \brief Désallocation d'un maillon : s'il fait partie d'un bloc, celui-ci
+ * n'est libéré qu'avec son dernier maillon.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à désallouer.
+ */
+static void maillon_liberer(liste_int const l, maillon const m) {
+  if (l->nb_blocs > 0) {
+    unsigned int i = bloc_position(l, m);
+    if (i > 0 && (uintptr_t)m < (uintptr_t)l->blocs[i - 1].fin) {
+      if (--l->blocs[i - 1].vivants == 0) {
+        free(l->blocs[i - 1].debut);
+        memmove(l->blocs + i - 1, l->blocs + i,
+                (l->nb_blocs - i) * sizeof(bloc));
+        l->nb_blocs--;
+      }
+      return;
+    }
+  }
+  free(m);
+}
+
 /*!
  * \brief Création d'un maillon dont la valeur est _val .
  * suivant et precedent doivent pointer sur ce maillon.
@@ -58,21 +192,36 @@ static bool maillon_est_unique(maillon const m) {
 
 /*!
  * \brief Destruction de toute la liste chaînée.
+ * \param l liste à laquelle appartient la liste chaînée.
  * \param m (pointeur sur un) maillon de la liste chaînée à détruire.
 */
-static void maillon_detruire(maillon *const m) {
+static void maillon_detruire(liste_int const l, maillon *const m) {
   maillon start = *m;
   maillon courant = (*m)->suivant;
   maillon suivant;
   while (courant != start) {
     suivant = courant->suivant;
-    free(courant);
+    maillon_liberer(l, courant);
     courant = suivant;
   }
-  free(courant);
+  maillon_liberer(l, courant);
   *m = NULL;
 }
 
+/*!
+ * \brief Retrait d'un maillon déjà détaché de la liste chaînée : la
+ * compaction incrémentale reprendra à son suivant s'il était son point de
+ * reprise.
+ * \param l liste d'où provient le maillon.
+ * \param m maillon à retirer.
+ */
+static void maillon_retirer(liste_int const l, maillon const m) {
+  if (m == l->a_compacter) {
+    l->a_compacter = m->suivant == l->tete ? NULL : m->suivant;
+  }
+  maillon_liberer(l, m);
+}
+
 /*!
  * \brief Affichage d'un ensemble de maillon à partir d'un début et d'une fin.
  * Le résultat est de la forme \verbatim[ 1 2 3 ]\endverbatim sans saut de
@@ -121,64 +270,175 @@ static void maillon_ajouter_apres(maillon const m, int const _val) {
 /*!
  * \brief Suppression du maillon d'avant s'il existe (c.-à-d. si la liste
  * correspondante ne contient qu'un maillon on ne fait rien).
+ * \param l liste à laquelle appartient le maillon.
  * \param m maillon avant lequel on doit supprimer.
  */
-static void maillon_supprimer_avant(maillon const m) {
+static void maillon_supprimer_avant(liste_int const l, maillon const m) {
   if (!maillon_est_unique(m)) {
     maillon avant = m->precedent;
     avant->precedent->suivant = m;
     m->precedent = avant->precedent;
-    free(avant);
+    maillon_retirer(l, avant);
   }
 }
 
 /*!
  * \brief Suppression du maillon d'après s'il existe (c.-à-d. si la liste
  * correspondante ne contient qu'un maillon on ne fait rien).
+ * \param l liste à laquelle appartient le maillon.
  * \param m maillon après lequel on doit supprimer.
 */
-static void maillon_supprimer_apres(maillon const m) {
+static void maillon_supprimer_apres(liste_int const l, maillon const m) {
   if (!maillon_est_unique(m)) {
     maillon apres = m->suivant;
     apres->suivant->precedent = m;
     m->suivant = apres->suivant;
-    free(apres);
+    maillon_retirer(l, apres);
   }
 }
 
 /*!
- * \brief Structure pour la liste en étendant la structure maillon.
- * Quand la liste est vide, il n'y a pas de liste circulaire (et les pointeurs
- * convernés valent NULL).
-*/
-struct liste_struct {
-  unsigned int taille;
-  maillon tete;
-  maillon courant;
-  maillon pied;
-};
+ * \brief Valeur de rang donné d'une liste en anneau.
+ * \param l liste en anneau.
+ * \param rang rang depuis la tete, inférieur à la taille.
+ * \return l'emplacement de la valeur.
+ */
+static int *anneau_valeur(liste_int const l, unsigned int const rang) {
+  return &l->anneau[(l->debut + rang) & (l->capacite - 1)];
+}
 
-liste liste_creer(void) {
-  liste l = malloc(sizeof(struct liste_struct));
+/*!
+ * \brief Réalloue l'anneau ; la tete revient à l'indice 0.
+ * \param l liste en anneau.
+ * \param capacite nouvelle capacité, une puissance de 2 au moins égale à la
+ * taille.
+ */
+static void anneau_reallouer(liste_int const l, unsigned int const capacite) {
+  int *anneau = malloc(capacite * sizeof(int));
+  assert(anneau != NULL);
+  unsigned int avant_fin = l->capacite - l->debut;
+  if (avant_fin > l->taille) {
+    avant_fin = l->taille;
+  }
+  if (l->taille > 0) {
+    memcpy(anneau, l->anneau + l->debut, avant_fin * sizeof(int));
+    memcpy(anneau + avant_fin, l->anneau,
+           (l->taille - avant_fin) * sizeof(int));
+  }
+  free(l->anneau);
+  l->anneau = anneau;
+  l->capacite = capacite;
+  l->debut = 0;
+}
+
+/*!
+ * \brief Double la capacité de l'anneau s'il est plein.
+ * \param l liste en anneau.
+ */
+static void anneau_reserver(liste_int const l) {
+  if (l->taille == l->capacite) {
+    anneau_reallouer(l, l->capacite == 0 ? ANNEAU_CAPACITE_MIN
+                                         : 2 * l->capacite);
+  }
+}
+
+/*!
+ * \brief Passage de l'anneau à la liste chaînée : les maillons sont alloués
+ * dans un seul bloc, dans l'ordre, et le courant est conservé.
+ * \param l liste à chaîner.
+ */
+static void liste_int_chainer(liste_int const l);
+
+/*!
+ * \brief Allocation d'une liste vide, qui n'est pas tracée.
+ */
+static liste_int liste_int_allouer(void) {
+  liste_int l = malloc(sizeof(struct liste_int_struct));
+  l->taille = 0;
   l->tete = NULL;
   l->courant = NULL;
   l->pied = NULL;
+  l->chainee = false;
+  l->anneau = NULL;
+  l->capacite = 0;
+  l->debut = 0;
+  l->rang_courant = AUCUN_RANG;
+  l->blocs = NULL;
+  l->nb_blocs = 0;
+  l->capacite_blocs = 0;
+  l->a_compacter = NULL;
+  l->differee.suivante = NULL;
+  l->trace = 0;
+  return l;
+}
+
+liste_int liste_int_creer(void) {
+  liste_int l = liste_int_allouer();
+  l->trace = listes_trace_creation(TRACE_MODULE_INT);
   return l;
 }
 
-void liste_detruire(liste *const l) {
+void liste_int_detruire(liste_int *const l) {
   ASSERT_LISTE();
-  maillon_detruire(&(*l)->tete);
+  TRACER(*l, TRACE_DETRUIRE);
+  if ((*l)->tete != NULL) {
+    maillon_detruire(*l, &(*l)->tete);
+  }
+  free((*l)->anneau);
+  free((*l)->blocs);
   free(*l);
   *l = NULL;
 }
 
+/*!
+ * \brief Libère une liste retirée de la file, par lots de DESTRUCTION_LOT
+ * maillons. Son anneau est vide ou ses maillons s'arrêtent à NULL.
+ */
+static void destruction_liberer(void *a_liberer) {
+  liste_int const l = a_liberer;
+  maillon m = l->tete;
+  unsigned long nb = 0;
+  while (m != NULL) {
+    maillon suivant = m->suivant;
+    maillon_liberer(l, m);
+    m = suivant;
+    if (++nb == DESTRUCTION_LOT) {
+      listes_destruction_lot(nb);
+      nb = 0;
+    }
+  }
+  free(l->anneau);
+  free(l->blocs);
+  free(l);
+}
+
+void liste_int_detruire_differe(liste_int *const l) {
+  ASSERT_LISTE();
+  TRACER(*l, TRACE_DETRUIRE_DIFFERE);
+  if ((*l)->tete != NULL) {
+    (*l)->pied->suivant = NULL;
+  }
+  (*l)->differee.liste = *l;
+  (*l)->differee.liberer = &destruction_liberer;
+  if (!listes_destruction_confier(&(*l)->differee)) {
+    /* sans thread, la liste est détruite tout de suite */
+    destruction_liberer(*l);
+  }
+  *l = NULL;
+}
+
+void liste_int_destructions_attendre(void) { listes_destructions_attendre(); }
+
+void liste_int_destruction_debit(unsigned long const maillons_par_seconde) {
+  listes_destruction_debit(maillons_par_seconde);
+}
+
 /*!
  * \brief Pour ajouter une valeur à une liste vide.
  * \param l liste où ajouter.
  * \param val valeur entière à jouter.
  */
-static void liste_ajouter_a_vide(liste const l, int const val) {
+static void liste_int_ajouter_a_vide(liste_int const l, int const val) {
   ASSERT_LISTE();
   maillon m = maillon_creer(val);
   l->tete = m;
@@ -187,43 +447,71 @@ static void liste_ajouter_a_vide(liste const l, int const val) {
 }
 
 /*! \brief Pour enlever la dernière valeur. */
-static void liste_enlever_dernier(liste const l) {
+static void liste_int_enlever_dernier(liste_int const l) {
   ASSERT_LISTE();
-  maillon_detruire(&l->tete);
+  maillon_detruire(l, &l->tete);
+  l->a_compacter = NULL;
   l->tete = NULL;
+  l->courant = NULL;
   l->pied = NULL;
   l->taille = 0;
 }
 
-bool liste_est_vide(liste const l) {
+bool liste_int_est_vide(liste_int const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_EST_VIDE);
+  if (!l->chainee) {
+    return l->taille == 0;
+  }
   return l->tete == NULL && l->courant == NULL && l->pied == NULL;
 }
 
-void liste_insertion_debut(liste const l, int const val) {
+void liste_int_insertion_debut(liste_int const l, int const val) {
   ASSERT_LISTE();
-  if (!liste_est_vide(l)) {
+  TRACER_ARGUMENT(l, TRACE_INSERTION_DEBUT, val);
+  if (!l->chainee) {
+    anneau_reserver(l);
+    l->debut = (l->debut - 1) & (l->capacite - 1);
+    l->anneau[l->debut] = val;
+    l->taille++;
+    if (l->rang_courant != AUCUN_RANG) {
+      l->rang_courant++;
+    }
+  } else if (l->tete != NULL) {
     maillon_ajouter_avant(l->tete, val);
     l->tete = l->tete->precedent;
     l->taille++;
   } else {
-    liste_ajouter_a_vide(l, val);
+    liste_int_ajouter_a_vide(l, val);
   }
 }
 
-void liste_insertion_fin(liste const l, int const val) {
+void liste_int_insertion_fin(liste_int const l, int const val) {
   ASSERT_LISTE();
-  if (!liste_est_vide(l)) {
+  TRACER_ARGUMENT(l, TRACE_INSERTION_FIN, val);
+  if (!l->chainee) {
+    anneau_reserver(l);
+    *anneau_valeur(l, l->taille) = val;
+    l->taille++;
+  } else if (l->tete != NULL) {
     maillon_ajouter_apres(l->pied, val);
     l->pied = l->pied->suivant;
     l->taille++;
   } else {
-    liste_ajouter_a_vide(l, val);
+    liste_int_ajouter_a_vide(l, val);
   }
 }
 
-void liste_insertion_apres(liste const l, int const val) {
-  ASSERT_LISTE();
+void liste_int_insertion_apres(liste_int const l, int const val) {
+  ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_APRES, val);
+  if (!l->chainee) {
+    if (l->rang_courant == l->taille - 1) {
+      SANS_TRACE(l, liste_int_insertion_fin(l, val));
+      return;
+    }
+    liste_int_chainer(l);
+  }
   maillon_ajouter_apres(l->courant, val);
   l->taille++;
   if (l->courant == l->pied) {
@@ -231,8 +519,16 @@ void liste_insertion_apres(liste const l, int const val) {
   }
 }
 
-void liste_insertion_avant(liste const l, int const val) {
-  ASSERT_LISTE();
+void liste_int_insertion_avant(liste_int const l, int const val) {
+  ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_INSERTION_AVANT, val);
+  if (!l->chainee) {
+    if (l->rang_courant == 0) {
+      SANS_TRACE(l, liste_int_insertion_debut(l, val));
+      return;
+    }
+    liste_int_chainer(l);
+  }
   maillon_ajouter_avant(l->courant, val);
   l->taille++;
   if (l->courant == l->tete) {
@@ -240,106 +536,777 @@ void liste_insertion_avant(liste const l, int const val) {
   }
 }
 
-void liste_suppression_debut(liste const l) {
+void liste_int_suppression_debut(liste_int const l) {
   ASSERT_LISTE();
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_avant(l->tete->suivant);
+  TRACER(l, TRACE_SUPPRESSION_DEBUT);
+  if (!l->chainee) {
+    assert(l->taille > 0);
+    l->debut = (l->debut + 1) & (l->capacite - 1);
+    l->taille--;
+    /* le courant supprimé n'existe plus */
+    l->rang_courant = l->rang_courant == 0 || l->rang_courant == AUCUN_RANG
+                          ? AUCUN_RANG
+                          : l->rang_courant - 1;
+  } else if (l->taille >= 2) {
+    maillon_supprimer_avant(l, l->tete->suivant);
     l->tete = l->pied->suivant;
     l->taille--;
   } else {
-    liste_enlever_dernier(l);
+    liste_int_enlever_dernier(l);
   }
 }
 
-void liste_suppression_fin(liste const l) {
+void liste_int_suppression_fin(liste_int const l) {
   ASSERT_LISTE();
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_apres(l->pied->precedent);
+  TRACER(l, TRACE_SUPPRESSION_FIN);
+  if (!l->chainee) {
+    assert(l->taille > 0);
+    l->taille--;
+    if (l->rang_courant == l->taille) {
+      l->rang_courant = AUCUN_RANG;
+    }
+  } else if (l->taille >= 2) {
+    maillon_supprimer_apres(l, l->pied->precedent);
     l->pied = l->tete->precedent;
     l->taille--;
   } else {
-    liste_enlever_dernier(l);
+    liste_int_enlever_dernier(l);
   }
 }
 
-void liste_suppression_avant(liste const l) {
-  ASSERT_LISTE();
-  assert(l->courant != NULL);
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_avant(l->courant);
+void liste_int_suppression_avant(liste_int const l) {
+  ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_SUPPRESSION_AVANT);
+  if (!l->chainee) {
+    /* l'élément avant la tete est le pied */
+    if (l->rang_courant <= 1 || l->taille < 2) {
+      if (l->rang_courant == 0 && l->taille >= 2) {
+        SANS_TRACE(l, liste_int_suppression_fin(l));
+      } else {
+        SANS_TRACE(l, liste_int_suppression_debut(l));
+      }
+      return;
+    }
+    liste_int_chainer(l);
+  }
+  if (l->taille >= 2) {
+    maillon const supprime = l->courant->precedent;
+    maillon_supprimer_avant(l, l->courant);
     l->taille--;
-    if (l->courant == l->tete) {
-      l->pied = l->tete->precedent;
+    if (supprime == l->pied) {
+      l->pied = l->courant->precedent;
+    } else if (supprime == l->tete) {
+      l->tete = l->courant;
     }
   } else {
-    liste_enlever_dernier(l);
+    liste_int_enlever_dernier(l);
   }
 }
 
-void liste_suppression_apres(liste const l) {
-  ASSERT_LISTE();
-  assert(l->courant != NULL);
-  if (liste_taille(l) >= 2) {
-    maillon_supprimer_apres(l->courant);
+void liste_int_suppression_apres(liste_int const l) {
+  ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_SUPPRESSION_APRES);
+  if (!l->chainee) {
+    /* l'élément après le pied est la tete */
+    if (l->rang_courant + 2 >= l->taille) {
+      if (l->rang_courant + 1 == l->taille) {
+        SANS_TRACE(l, liste_int_suppression_debut(l));
+      } else {
+        SANS_TRACE(l, liste_int_suppression_fin(l));
+      }
+      return;
+    }
+    liste_int_chainer(l);
+  }
+  if (l->taille >= 2) {
+    maillon const supprime = l->courant->suivant;
+    maillon_supprimer_apres(l, l->courant);
     l->taille--;
-    if (l->courant == l->pied) {
-      l->tete = l->pied->suivant;
+    if (supprime == l->tete) {
+      l->tete = l->courant->suivant;
+    } else if (supprime == l->pied) {
+      l->pied = l->courant;
     }
   } else {
-    liste_enlever_dernier(l);
+    liste_int_enlever_dernier(l);
   }
 }
 
-void liste_affichage(FILE *const f, liste const l) {
+void liste_int_affichage(FILE *const f, liste_int const l) {
   assert(f != NULL);
   ASSERT_LISTE();
+  TRACER(l, TRACE_AFFICHAGE);
   fprintf(f, "Liste de %d éléments : ", l->taille);
-  maillon_afficher(f, l->tete, l->pied);
+  if (l->chainee) {
+    maillon_afficher(f, l->tete, l->pied);
+    return;
+  }
+  fprintf(f, "[");
+  for (unsigned int i = 0; i < l->taille; i++) {
+    fprintf(f, " %d", *anneau_valeur(l, i));
+  }
+  fprintf(f, " ]");
 }
 
-void liste_courant_init(liste const l) {
+void liste_int_courant_init(liste_int const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_COURANT_INIT);
   l->courant = l->tete;
+  l->rang_courant = l->taille > 0 ? 0 : AUCUN_RANG;
 }
 
-void liste_courant_suivant(liste const l) {
+void liste_int_courant_suivant(liste_int const l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_COURANT_SUIVANT);
+  if (!l->chainee) {
+    l->rang_courant = l->rang_courant + 1 == l->taille ? 0 : l->rang_courant + 1;
+    return;
+  }
   l->courant = l->courant->suivant;
 }
 
-void liste_decalage(liste const l, int n) {
+void liste_int_decalage(liste_int const l, int n) {
   ASSERT_LISTE_COURANT();
+  TRACER_ARGUMENT(l, TRACE_DECALAGE, n);
+  if (!l->chainee) {
+    if (n > 0) {
+      l->rang_courant =
+          (unsigned int)(((unsigned long)l->rang_courant + (unsigned long)n) %
+                         l->taille);
+    }
+    return;
+  }
   for (int i = 0; i < n; i++) {
     l->courant = l->courant->suivant;
   }
 }
 
-int liste_taille(liste const l) {
+int liste_int_taille(liste_int const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_TAILLE);
   return l->taille;
 }
 
-int liste_valeur_tete(liste const l) {
+int liste_int_valeur_tete(liste_int const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_VALEUR_TETE);
+  if (!l->chainee) {
+    assert(l->taille > 0);
+    return *anneau_valeur(l, 0);
+  }
   return l->tete->val;
 }
 
-int liste_valeur_pied(liste const l) {
+int liste_int_valeur_pied(liste_int const l) {
   ASSERT_LISTE();
+  TRACER(l, TRACE_VALEUR_PIED);
+  if (!l->chainee) {
+    assert(l->taille > 0);
+    return *anneau_valeur(l, l->taille - 1);
+  }
   return l->pied->val;
 }
 
-int liste_valeur_courant(liste const l) {
+int liste_int_valeur_courant(liste_int const l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_VALEUR_COURANT);
+  if (!l->chainee) {
+    return *anneau_valeur(l, l->rang_courant);
+  }
   return l->courant->val;
 }
 
-bool liste_est_tete(liste const l) {
+bool liste_int_est_tete(liste_int const l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_EST_TETE);
+  if (!l->chainee) {
+    return l->rang_courant == 0;
+  }
   return l->courant == l->tete;
 }
 
-bool liste_est_pied(liste const l) {
+bool liste_int_est_pied(liste_int const l) {
   ASSERT_LISTE_COURANT();
+  TRACER(l, TRACE_EST_PIED);
+  if (!l->chainee) {
+    return l->rang_courant == l->taille - 1;
+  }
   return l->courant == l->pied;
 }
+
+/*!
+ * \brief Déplace un maillon de la liste vers un emplacement libre, puis
+ * libère l'ancien.
+ * \param l liste à laquelle appartient le maillon.
+ * \param m maillon à déplacer.
+ * \param n emplacement qui le remplace.
+ */
+static void maillon_deplacer(liste_int const l, maillon const m,
+                             maillon const n) {
+  n->val = m->val;
+  if (maillon_est_unique(m)) {
+    n->precedent = n->suivant = n;
+  } else {
+    n->precedent = m->precedent;
+    n->suivant = m->suivant;
+    n->precedent->suivant = n;
+    n->suivant->precedent = n;
+  }
+  if (l->tete == m) {
+    l->tete = n;
+  }
+  if (l->pied == m) {
+    l->pied = n;
+  }
+  if (l->courant == m) {
+    l->courant = n;
+  }
+  maillon_liberer(l, m);
+}
+
+/*!
+ * \brief Allocation d'un bloc de maillons contigus, enregistré dans la liste.
+ * \param l liste à laquelle sont destinés les maillons.
+ * \param nb nombre de maillons du bloc, tous comptés comme utilisés.
+ * \return le premier maillon du bloc.
+ */
+static maillon bloc_allouer(liste_int const l, unsigned int nb) {
+  maillon memoire = malloc(nb * sizeof(struct maillon_struct));
+  assert(memoire != NULL);
+  if (l->nb_blocs == l->capacite_blocs) {
+    l->capacite_blocs = l->capacite_blocs == 0 ? 16 : 2 * l->capacite_blocs;
+    l->blocs = realloc(l->blocs, l->capacite_blocs * sizeof(bloc));
+    assert(l->blocs != NULL);
+  }
+  unsigned int i = bloc_position(l, memoire);
+  memmove(l->blocs + i + 1, l->blocs + i, (l->nb_blocs - i) * sizeof(bloc));
+  l->blocs[i].debut = memoire;
+  l->blocs[i].fin = memoire + nb;
+  l->blocs[i].vivants = nb;
+  l->nb_blocs++;
+  return memoire;
+}
+
+static void liste_int_chainer(liste_int const l) {
+  assert(!l->chainee);
+  l->chainee = true;
+  if (l->taille > 0) {
+    maillon m = bloc_allouer(l, l->taille);
+    for (unsigned int i = 0; i < l->taille; i++) {
+      m[i].val = *anneau_valeur(l, i);
+      m[i].precedent = &m[i == 0 ? l->taille - 1 : i - 1];
+      m[i].suivant = &m[i + 1 == l->taille ? 0 : i + 1];
+    }
+    l->tete = m;
+    l->pied = m + l->taille - 1;
+    l->courant = l->rang_courant == AUCUN_RANG ? NULL : m + l->rang_courant;
+  }
+  free(l->anneau);
+  l->anneau = NULL;
+  l->capacite = 0;
+}
+
+bool liste_int_compacter_etape(liste_int const l, unsigned int const k) {
+  ASSERT_LISTE();
+  TRACER_ARGUMENT(l, TRACE_COMPACTER_ETAPE, (int)k);
+  assert(k > 0);
+  if (!l->chainee) {
+    /* l'anneau est déjà contigu */
+    return true;
+  }
+  if (l->tete == NULL) {
+    l->a_compacter = NULL;
+    return true;
+  }
+  maillon m = l->a_compacter != NULL ? l->a_compacter : l->tete;
+  unsigned int nb = 1;
+  for (maillon p = m; p != l->pied && nb < k; p = p->suivant) {
+    nb++;
+  }
+  maillon memoire = bloc_allouer(l, nb);
+  bool fini = false;
+  for (unsigned int j = 0; j < nb; j++) {
+    maillon suivant = m->suivant;
+    fini = m == l->pied;
+    maillon_deplacer(l, m, memoire + j);
+    m = suivant;
+  }
+  l->a_compacter = fini ? NULL : m;
+  return fini;
+}
+
+void liste_int_compacter(liste_int const l) {
+  ASSERT_LISTE();
+  TRACER(l, TRACE_COMPACTER);
+  l->a_compacter = NULL;
+  if (l->taille > 0) {
+    SANS_TRACE(l, liste_int_compacter_etape(l, l->taille));
+  }
+}
+
+/*!
+ * \brief Enregistre un appel à liste_int_remplacer_courant.
+ */
+static void trace_remplacer(liste_int const l, int const *const vals,
+                            unsigned int const k,
+                            unsigned int const position) {
+  int *arguments = malloc((k + 2) * sizeof(int));
+  assert(arguments != NULL);
+  arguments[0] = (int)k;
+  arguments[1] = (int)position;
+  memcpy(arguments + 2, vals, k * sizeof(int));
+  listes_trace_appel(l->trace, TRACE_REMPLACER_COURANT, arguments, k + 2);
+  free(arguments);
+}
+
+void liste_int_remplacer_courant(liste_int const l, int const *const vals,
+                                 unsigned int const k,
+                                 unsigned int const position) {
+  ASSERT_LISTE_COURANT();
+  assert(vals != NULL && k > 0 && position < k);
+  if (l->trace != 0) {
+    trace_remplacer(l, vals, k, position);
+  }
+  if (!l->chainee) {
+    if (k == 1) {
+      *anneau_valeur(l, l->rang_courant) = vals[0];
+      return;
+    }
+    liste_int_chainer(l);
+  }
+  maillon m = l->courant;
+  m->val = vals[0];
+  maillon dernier = m;
+  if (k > 1) {
+    /* un seul maillon supplémentaire n'a pas besoin de bloc */
+    maillon nouveaux = k == 2 ? maillon_creer(vals[1]) : bloc_allouer(l, k - 1);
+    for (unsigned int i = 1; i < k; i++) {
+      maillon n = nouveaux + (i - 1);
+      n->val = vals[i];
+      n->precedent = dernier;
+      n->suivant = dernier->suivant;
+      dernier->suivant->precedent = n;
+      dernier->suivant = n;
+      dernier = n;
+      if (i == position) {
+        l->courant = n;
+      }
+    }
+  }
+  if (l->pied == m) {
+    l->pied = dernier;
+  }
+  l->taille += k - 1;
+}
+
+/*!
+ * \brief Plus petite capacité d'anneau qui contient n valeurs.
+ */
+static unsigned int anneau_capacite(unsigned int const n) {
+  unsigned int capacite = ANNEAU_CAPACITE_MIN;
+  while (capacite < n) {
+    capacite *= 2;
+  }
+  return capacite;
+}
+
+/*!
+ * \brief Valeurs de la liste dans un tableau : l'anneau lui-même, remis d'un
+ * seul tenant si besoin, ou une copie des valeurs des maillons.
+ * \param l liste.
+ * \param copie (pointeur vers la) copie à libérer, NULL si aucune.
+ * \return les l->taille valeurs dans l'ordre.
+ */
+static int *liste_int_valeurs(liste_int const l, int **const copie) {
+  *copie = NULL;
+  if (!l->chainee) {
+    if (l->capacite == 0) {
+      anneau_reallouer(l, ANNEAU_CAPACITE_MIN);
+    } else if (l->debut + l->taille > l->capacite) {
+      anneau_reallouer(l, l->capacite);
+    }
+    return l->anneau + l->debut;
+  }
+  *copie = malloc((l->taille > 0 ? l->taille : 1) * sizeof(int));
+  assert(*copie != NULL);
+  maillon m = l->tete;
+  for (unsigned int i = 0; i < l->taille; i++) {
+    (*copie)[i] = m->val;
+    m = m->suivant;
+  }
+  return *copie;
+}
+
+/*!
+ * \brief Premier indice i de t[debut..n[ tel que v <= t[i], n s'il n'y en a
+ * pas, par recherche exponentielle depuis debut puis dichotomique.
+ */
+static unsigned int galoper(int const *const t, unsigned int const debut,
+                            unsigned int const n, int const v) {
+  if (debut >= n || t[debut] >= v) {
+    return debut;
+  }
+  /* t[bas] < v */
+  unsigned int bas = debut;
+  unsigned int pas = 1;
+  while (pas < n - bas && t[bas + pas] < v) {
+    bas += pas;
+    pas *= 2;
+  }
+  unsigned int haut = pas < n - bas ? bas + pas : n;
+  bas++;
+  while (bas < haut) {
+    unsigned int milieu = bas + (haut - bas) / 2;
+    if (t[milieu] < v) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  return bas;
+}
+
+/*!
+ * \brief Union de deux tableaux strictement croissants.
+ * \return le nombre de valeurs écrites dans sortie, distincte de a et b.
+ */
+static unsigned int ensemble_union(int const *a, unsigned int na,
+                                   int const *b, unsigned int nb,
+                                   int *const sortie) {
+  unsigned int k = 0, i = 0, j = 0;
+  if (na > nb) {
+    int const *t = a;
+    a = b;
+    b = t;
+    unsigned int n = na;
+    na = nb;
+    nb = n;
+  }
+  if ((unsigned long long)na * GALOP_RAPPORT < nb) {
+    /* les valeurs de b entre deux valeurs de a sont copiées d'un bloc */
+    for (i = 0; i < na; i++) {
+      unsigned int fin = galoper(b, j, nb, a[i]);
+      memcpy(sortie + k, b + j, (fin - j) * sizeof(int));
+      k += fin - j;
+      j = fin < nb && b[fin] == a[i] ? fin + 1 : fin;
+      sortie[k++] = a[i];
+    }
+  } else {
+    while (i < na && j < nb) {
+      int x = a[i], y = b[j];
+      sortie[k++] = x <= y ? x : y;
+      i += x <= y;
+      j += y <= x;
+    }
+    memcpy(sortie + k, a + i, (na - i) * sizeof(int));
+    k += na - i;
+  }
+  memcpy(sortie + k, b + j, (nb - j) * sizeof(int));
+  return k + nb - j;
+}
+
+/*!
+ * \brief Intersection de deux tableaux strictement croissants, par blocs de
+ * 4 valeurs comparées toutes ensemble (SSE2) quand les tailles sont proches.
+ * \return le nombre de valeurs écrites dans sortie, qui peut être a.
+ */
+static unsigned int ensemble_intersection(int const *a, unsigned int na,
+                                          int const *b, unsigned int nb,
+                                          int *const sortie) {
+  unsigned int k = 0, i = 0, j = 0;
+  if ((unsigned long long)na * GALOP_RAPPORT < nb) {
+    for (i = 0; i < na && j < nb; i++) {
+      j = galoper(b, j, nb, a[i]);
+      if (j < nb && b[j] == a[i]) {
+        sortie[k++] = a[i];
+      }
+    }
+    return k;
+  }
+  if ((unsigned long long)nb * GALOP_RAPPORT < na) {
+    for (j = 0; j < nb && i < na; j++) {
+      i = galoper(a, i, na, b[j]);
+      if (i < na && a[i] == b[j]) {
+        sortie[k++] = a[i];
+      }
+    }
+    return k;
+  }
+#ifdef __SSE2__
+  while (i + 4 <= na && j + 4 <= nb) {
+    __m128i va = _mm_loadu_si128((__m128i const *)(a + i));
+    __m128i vb = _mm_loadu_si128((__m128i const *)(b + j));
+    /* chaque valeur de a contre les 4 rotations du bloc de b */
+    __m128i egal = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi32(va, vb),
+            _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+        _mm_or_si128(
+            _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+            _mm_cmpeq_epi32(va,
+                            _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+    int masque = _mm_movemask_ps(_mm_castsi128_ps(egal));
+    int max_a = a[i + 3], max_b = b[j + 3];
+    /* sortie[k] n'écrase au plus que la valeur de a qui y est recopiée */
+    for (unsigned int bit = 0; masque != 0; bit++, masque >>= 1) {
+      if (masque & 1) {
+        sortie[k++] = a[i + bit];
+      }
+    }
+    i += max_a <= max_b ? 4 : 0;
+    j += max_b <= max_a ? 4 : 0;
+  }
+#endif
+  while (i < na && j < nb) {
+    int x = a[i], y = b[j];
+    if (x == y) {
+      sortie[k++] = x;
+    }
+    i += x <= y;
+    j += y <= x;
+  }
+  return k;
+}
+
+/*!
+ * \brief Différence de deux tableaux strictement croissants : les valeurs de
+ * a qui ne sont pas dans b.
+ * \return le nombre de valeurs écrites dans sortie, qui peut être a.
+ */
+static unsigned int ensemble_difference(int const *a, unsigned int na,
+                                        int const *b, unsigned int nb,
+                                        int *const sortie) {
+  unsigned int k = 0, i = 0, j = 0;
+  if ((unsigned long long)nb * GALOP_RAPPORT < na) {
+    /* les valeurs de a entre deux valeurs de b sont déplacées d'un bloc */
+    for (j = 0; j < nb && i < na; j++) {
+      unsigned int fin = galoper(a, i, na, b[j]);
+      memmove(sortie + k, a + i, (fin - i) * sizeof(int));
+      k += fin - i;
+      i = fin < na && a[fin] == b[j] ? fin + 1 : fin;
+    }
+  } else if ((unsigned long long)na * GALOP_RAPPORT < nb) {
+    for (; i < na; i++) {
+      j = galoper(b, j, nb, a[i]);
+      if (j == nb || b[j] != a[i]) {
+        sortie[k++] = a[i];
+      }
+    }
+  } else {
+    while (i < na && j < nb) {
+      int x = a[i], y = b[j];
+      if (x < y) {
+        sortie[k++] = x;
+      }
+      i += x <= y;
+      j += y <= x;
+    }
+  }
+  memmove(sortie + k, a + i, (na - i) * sizeof(int));
+  return k + na - i;
+}
+
+/*!
+ * \brief Nouvelle liste en anneau d'au plus n valeurs, remplie par une
+ * opération ensembliste.
+ */
+static liste_int liste_int_ensemble(
+    liste_int const a, liste_int const b, unsigned int const n,
+    unsigned int (*operation)(int const *, unsigned int, int const *,
+                              unsigned int, int *)) {
+  int *copie_a, *copie_b;
+  int const *va = liste_int_valeurs(a, &copie_a);
+  int const *vb = liste_int_valeurs(b, &copie_b);
+  liste_int resultat = liste_int_allouer();
+  anneau_reallouer(resultat, anneau_capacite(n));
+  resultat->taille = operation(va, a->taille, vb, b->taille, resultat->anneau);
+  free(copie_a);
+  free(copie_b);
+  return resultat;
+}
+
+liste_int liste_int_union(liste_int const a, liste_int const b) {
+  assert(a != NULL && b != NULL);
+  return liste_int_ensemble(a, b, a->taille + b->taille, &ensemble_union);
+}
+
+liste_int liste_int_intersection(liste_int const a, liste_int const b) {
+  assert(a != NULL && b != NULL);
+  return liste_int_ensemble(a, b, a->taille < b->taille ? a->taille : b->taille,
+                            &ensemble_intersection);
+}
+
+liste_int liste_int_difference(liste_int const a, liste_int const b) {
+  assert(a != NULL && b != NULL);
+  return liste_int_ensemble(a, b, a->taille, &ensemble_difference);
+}
+
+/*!
+ * \brief Détache un maillon de la liste chaînée et le libère.
+ * \param l liste chaînée.
+ * \param m maillon à enlever.
+ */
+static void liste_int_enlever(liste_int const l, maillon const m) {
+  if (l->taille == 1) {
+    liste_int_enlever_dernier(l);
+    return;
+  }
+  m->precedent->suivant = m->suivant;
+  m->suivant->precedent = m->precedent;
+  if (m == l->tete) {
+    l->tete = m->suivant;
+  }
+  if (m == l->pied) {
+    l->pied = m->precedent;
+  }
+  maillon_retirer(l, m);
+  l->taille--;
+}
+
+/*!
+ * \brief Garde dans a les valeurs qui sont (ou ne sont pas) dans b.
+ * \param a liste modifiée.
+ * \param b liste des valeurs cherchées.
+ * \param garder_presentes true pour l'intersection, false pour la
+ * différence.
+ */
+static void liste_int_filtrer(liste_int const a, liste_int const b,
+                              bool const garder_presentes) {
+  int *copie_b;
+  int const *vb = liste_int_valeurs(b, &copie_b);
+  if (!a->chainee) {
+    int *copie_a;
+    int *va = liste_int_valeurs(a, &copie_a);
+    a->taille = garder_presentes
+                    ? ensemble_intersection(va, a->taille, vb, b->taille, va)
+                    : ensemble_difference(va, a->taille, vb, b->taille, va);
+    a->rang_courant = AUCUN_RANG;
+  } else {
+    maillon m = a->tete;
+    unsigned int j = 0;
+    for (unsigned int n = a->taille; n > 0; n--) {
+      maillon suivant = m->suivant;
+      j = galoper(vb, j, b->taille, m->val);
+      if ((j < b->taille && vb[j] == m->val) != garder_presentes) {
+        liste_int_enlever(a, m);
+      }
+      m = suivant;
+    }
+    a->courant = NULL;
+  }
+  free(copie_b);
+}
+
+/*!
+ * \brief La liste, modifiée par une opération qui n'a pas d'équivalent dans
+ * listes_generiques, n'est plus tracée.
+ */
+static void trace_abandonner(liste_int const l) {
+  TRACER(l, TRACE_ABANDON);
+  l->trace = 0;
+}
+
+void liste_int_intersecter(liste_int const a, liste_int const b) {
+  assert(a != NULL && b != NULL);
+  trace_abandonner(a);
+  liste_int_filtrer(a, b, true);
+}
+
+void liste_int_retrancher(liste_int const a, liste_int const b) {
+  assert(a != NULL && b != NULL);
+  trace_abandonner(a);
+  liste_int_filtrer(a, b, false);
+}
+
+/*!
+ * \brief Les blocs de la compaction de b passent à a, qui reçoit ses
+ * maillons.
+ */
+static void blocs_transferer(liste_int const a, liste_int const b) {
+  for (unsigned int i = 0; i < b->nb_blocs; i++) {
+    if (a->nb_blocs == a->capacite_blocs) {
+      a->capacite_blocs = a->capacite_blocs == 0 ? 16 : 2 * a->capacite_blocs;
+      a->blocs = realloc(a->blocs, a->capacite_blocs * sizeof(bloc));
+      assert(a->blocs != NULL);
+    }
+    unsigned int k = bloc_position(a, b->blocs[i].debut);
+    memmove(a->blocs + k + 1, a->blocs + k, (a->nb_blocs - k) * sizeof(bloc));
+    a->blocs[k] = b->blocs[i];
+    a->nb_blocs++;
+  }
+  b->nb_blocs = 0;
+}
+
+/*!
+ * \brief Insère un maillon isolé dans la liste chaînée triée a, avant p ou,
+ * si p est NULL, après le pied.
+ */
+static void liste_int_inserer_maillon(liste_int const a, maillon const n,
+                                      maillon const p) {
+  if (a->tete == NULL) {
+    n->precedent = n->suivant = n;
+    a->tete = a->pied = n;
+  } else {
+    maillon apres = p != NULL ? p : a->tete;
+    n->suivant = apres;
+    n->precedent = apres->precedent;
+    apres->precedent->suivant = n;
+    apres->precedent = n;
+    if (p == a->tete) {
+      a->tete = n;
+    }
+    if (p == NULL) {
+      a->pied = n;
+    }
+  }
+  a->taille++;
+}
+
+void liste_int_unir(liste_int const a, liste_int *const b) {
+  assert(a != NULL && b != NULL && *b != NULL && *b != a);
+  trace_abandonner(a);
+  liste_int c = *b;
+  if (!a->chainee) {
+    int *copie_a, *copie_c;
+    int const *va = liste_int_valeurs(a, &copie_a);
+    int const *vc = liste_int_valeurs(c, &copie_c);
+    unsigned int capacite = anneau_capacite(a->taille + c->taille);
+    int *anneau = malloc(capacite * sizeof(int));
+    assert(anneau != NULL);
+    a->taille = ensemble_union(va, a->taille, vc, c->taille, anneau);
+    free(a->anneau);
+    a->anneau = anneau;
+    a->capacite = capacite;
+    a->debut = 0;
+    a->rang_courant = AUCUN_RANG;
+    free(copie_c);
+    liste_int_detruire(b);
+    return;
+  }
+  // Fusion des maillons : ceux de c sont insérés dans a, sauf les doublons
+  blocs_transferer(a, c);
+  maillon p = a->tete;
+  unsigned int restants = a->taille; /* maillons de a à partir de p */
+  maillon n = c->chainee ? c->tete : NULL;
+  for (unsigned int i = 0; i < c->taille; i++) {
+    int v = c->chainee ? n->val : *anneau_valeur(c, i);
+    maillon suivant = c->chainee ? n->suivant : NULL;
+    while (restants > 0 && p->val < v) {
+      p = p->suivant;
+      restants--;
+    }
+    if (restants > 0 && p->val == v) {
+      if (n != NULL) {
+        maillon_liberer(a, n);
+      }
+    } else {
+      liste_int_inserer_maillon(a, n != NULL ? n : maillon_creer(v),
+                                restants > 0 ? p : NULL);
+    }
+    n = suivant;
+  }
+  a->courant = NULL;
+  a->a_compacter = NULL;
+  c->tete = NULL;
+  liste_int_detruire(b);
+}
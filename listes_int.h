@@ -14,6 +14,15 @@
  * Afin de parcourir la liste, elle enregistre également une position courante.
  * Le parcours doit toujours être initialisé avant d'être utilisé.
  *
+ * Une liste modifiée seulement à ses extrémités (file, pile) est rangée dans
+ * un tableau circulaire dont la capacité double quand il est plein : ses
+ * insertions et suppressions ne font pas d'allocation. Elle passe en liste
+ * chaînée, sans changement visible, à la première insertion ou suppression au
+ * milieu relative au courant.
+ *
+ * Les noms du module sont préfixés par liste_int pour qu'un même programme
+ * puisse aussi utiliser les listes génériques (bibliothèque liblistes.a).
+ *
  * \copyright PASD
  * \version 2016
  */
@@ -25,26 +34,50 @@
  * Ces deux structures sont cachées et ne doivent jamais être manipulées
  * directement.
  */
-typedef struct liste_struct *liste;
+typedef struct liste_int_struct *liste_int;
 
 /*!
  * \brief Création d'une liste vide.
  * \return une nouvelle liste vide.
  */
-liste liste_creer(void);
+liste_int liste_int_creer(void);
 
 /*!
  * \brief Pour savoir si une liste est vide ou non.
  * \param l liste à tester.
  * \return true ssi la liste est vide.
  */
-bool liste_est_vide(liste const l);
+bool liste_int_est_vide(liste_int const l);
 
 /*!
  * \brief Destruction de la liste.
  * \param l (pointeur vers la) liste à détruire.
  */
-void liste_detruire(liste *const l);
+void liste_int_detruire(liste_int *const l);
+
+/*!
+ * \brief Destruction différée de la liste : elle est détachée en temps
+ * constant puis libérée par un thread dédié, démarré au premier appel, sans
+ * dépasser le débit fixé par liste_int_destruction_debit. La file, le thread
+ * et le débit sont communs avec liste_detruire_differe (cf.
+ * listes_destruction.h).
+ * \param l (pointeur vers la) liste à détruire, vaut NULL en sortie.
+ */
+void liste_int_detruire_differe(liste_int *const l);
+
+/*!
+ * \brief Attend que toutes les listes confiées à liste_int_detruire_differe
+ * ou à liste_detruire_differe soient libérées ; pendant l'attente, le débit n'est plus limité. À appeler
+ * avant la fin du programme.
+ */
+void liste_int_destructions_attendre(void);
+
+/*!
+ * \brief Débit maximal de la destruction différée, commun aux deux modules
+ * de listes, 20 millions de maillons par seconde par défaut.
+ * \param maillons_par_seconde nouveau débit, 0 pour ne pas le limiter.
+ */
+void liste_int_destruction_debit(unsigned long const maillons_par_seconde);
 
 /*!
  * \brief Insertion en début de liste.
@@ -53,7 +86,7 @@ void liste_detruire(liste *const l);
  * \param l liste où insérer.
  * \param val valeur entière à insérer.
  */
-void liste_insertion_debut(liste const l, int const val);
+void liste_int_insertion_debut(liste_int const l, int const val);
 
 /*!
  * \brief Insertion en fin de liste.
@@ -62,7 +95,7 @@ void liste_insertion_debut(liste const l, int const val);
  * \param l liste où insérer.
  * \param val valeur entière à insérer.
  */
-void liste_insertion_fin(liste const l, int const val);
+void liste_int_insertion_fin(liste_int const l, int const val);
 
 /*!
  * \brief Insertion après le maillon courant.
@@ -70,7 +103,7 @@ void liste_insertion_fin(liste const l, int const val);
  * \param l liste où insérer.
  * \param val valeur entière à insérer.
  */
-void liste_insertion_apres(liste const l, int const val);
+void liste_int_insertion_apres(liste_int const l, int const val);
 
 /*!
  * \brief Insertion avant le maillon courant.
@@ -78,19 +111,19 @@ void liste_insertion_apres(liste const l, int const val);
  * \param l liste où insérer.
  * \param val valeur entière à insérer.
  */
-void liste_insertion_avant(liste const l, int const val);
+void liste_int_insertion_avant(liste_int const l, int const val);
 
 /*!
  * \brief Suppression de l'élément en tete de liste (mettre à jour tete).
  * \param l liste d'où supprimer.
  */
-void liste_suppression_debut(liste const l);
+void liste_int_suppression_debut(liste_int const l);
 
 /*!
  * \brief Suppression de l'élément en pied de liste (mettre à jour pied).
  * \param l liste d'où supprimer.
  */
-void liste_suppression_fin(liste const l);
+void liste_int_suppression_fin(liste_int const l);
 
 /*!
  * \brief Suppression de l'élément avant courant s'il existe (tete et pied
@@ -98,7 +131,7 @@ void liste_suppression_fin(liste const l);
  * modifiés si nécessaire).
  * \param l liste d'où supprimer.
  */
-void liste_suppression_avant(liste const l);
+void liste_int_suppression_avant(liste_int const l);
 
 /*!
  * \brief Suppression de l'élément apres courant s'il existe (tete et pied
@@ -106,7 +139,7 @@ void liste_suppression_avant(liste const l);
  * modifiés si nécessaire).
  * \param l liste d'où supprimer.
  */
-void liste_suppression_apres(liste const l);
+void liste_int_suppression_apres(liste_int const l);
 
 /*!
  * \brief Affichage des éléments de la liste.
@@ -116,19 +149,19 @@ void liste_suppression_apres(liste const l);
  * \param f flux où imprimer.
  * \param l liste à afficher.
  */
-void liste_affichage(FILE *const f, liste const l);
+void liste_int_affichage(FILE *const f, liste_int const l);
 
 /*!
  * \brief Initialise courant à tete.
  * \param l liste à parcourir.
  */
-void liste_courant_init(liste const l);
+void liste_int_courant_init(liste_int const l);
 
 /*!
  * \brief Passe courant sur l'élément suivant.
  * \param l liste parcourue.
  */
-void liste_courant_suivant(liste const l);
+void liste_int_courant_suivant(liste_int const l);
 
 /*!
  * \brief Décalage de courant de n positions.
@@ -136,48 +169,134 @@ void liste_courant_suivant(liste const l);
  * \param n nombre de décalage à faire.
  * \param l liste parcourue.
 */
-void liste_decalage(liste const l, int n);
+void liste_int_decalage(liste_int const l, int n);
 
 /*!
  * \brief Retourne la taille de la liste.
  * \param l liste sur laquelle porte la demande.
  * \return le nombre d'éléments dans la liste.
  */
-int liste_taille(liste const l);
+int liste_int_taille(liste_int const l);
 
 /*!
  * \brief Retourne la valeur de tete.
  * \param l liste sur laquelle porte la demande.
  * \return le nombre d'éléments dans la liste.
  */
-int liste_valeur_tete(liste const l);
+int liste_int_valeur_tete(liste_int const l);
 
 /*!
  * \brief Retourne la valeur de pied.
  * \param l liste sur laquelle porte la demande.
  * \return la première valeur de la liste.
  */
-int liste_valeur_pied(liste const l);
+int liste_int_valeur_pied(liste_int const l);
 
 /*!
  * \brief Retourne la valeur de courant.
  * \param l liste parcourue sur laquelle porte la demande.
  * \return la value de l'élément courant de la liste.
  */
-int liste_valeur_courant(liste const l);
+int liste_int_valeur_courant(liste_int const l);
 
 /*!
  * \brief Retourne vrai si courant pointe sur tete.
  * \param l liste sur laquelle porte la demande.
  * \return true si la tete est l'élément courant.
  */
-bool liste_est_tete(liste const l);
+bool liste_int_est_tete(liste_int const l);
 
 /*!
  * \brief Retourne vrai si courant pointe sur pied.
  * \param l liste sur laquelle porte la demande.
  * \return true si le pied est l'élément courant.
  */
-bool liste_est_pied(liste const l);
+bool liste_int_est_pied(liste_int const l);
+
+/*!
+ * \brief Remplace l'élément courant par k éléments, dans l'ordre de vals.
+ * Le maillon courant est réutilisé pour vals[0] et les k - 1 autres sont
+ * alloués ensemble. tete et pied sont mis à jour.
+ * \param l liste parcourue.
+ * \param vals les k valeurs.
+ * \param k nombre de valeurs, non nul.
+ * \param position indice dans vals de l'élément qui devient courant.
+ */
+void liste_int_remplacer_courant(liste_int const l, int const *const vals,
+                                 unsigned int const k,
+                                 unsigned int const position);
+
+/*!
+ * \brief Réalloue les maillons de la liste dans un seul bloc contigu, dans
+ * l'ordre du parcours, pour que celui-ci profite des caches après de
+ * nombreuses insertions et suppressions.
+ * tete, pied et courant désignent toujours les mêmes éléments. Le bloc est
+ * libéré avec son dernier maillon.
+ * \param l liste à compacter.
+ */
+void liste_int_compacter(liste_int const l);
+
+/*!
+ * \brief Compaction incrémentale : déplace au plus k maillons dans un nouveau
+ * bloc, en reprenant le parcours là où l'appel précédent s'est arrêté (à la
+ * tete au premier appel).
+ * \param l liste à compacter.
+ * \param k nombre maximal de maillons déplacés, non nul.
+ * \return true si le pied a été atteint : l'appel suivant repart de tete.
+ */
+bool liste_int_compacter_etape(liste_int const l, unsigned int const k);
+
+/*!
+ * \brief Union de deux ensembles : des listes strictement croissantes.
+ * Les deux listes sont parcourues une seule fois ; quand l'une est beaucoup
+ * plus petite que l'autre, chacun de ses éléments est cherché dans la grande
+ * par recherche exponentielle, et les valeurs de la grande sont copiées par
+ * blocs.
+ * \param a premier ensemble.
+ * \param b second ensemble.
+ * \return un nouvel ensemble, à détruire, sans courant.
+ */
+liste_int liste_int_union(liste_int const a, liste_int const b);
+
+/*!
+ * \brief Intersection de deux ensembles, comme liste_int_union. Pour des
+ * tailles proches, les valeurs sont comparées par blocs de 4 (SSE2).
+ * \param a premier ensemble.
+ * \param b second ensemble.
+ * \return un nouvel ensemble, à détruire, sans courant.
+ */
+liste_int liste_int_intersection(liste_int const a, liste_int const b);
+
+/*!
+ * \brief Différence de deux ensembles, comme liste_int_union.
+ * \param a ensemble dont on retire les valeurs.
+ * \param b valeurs à retirer.
+ * \return un nouvel ensemble, à détruire, sans courant.
+ */
+liste_int liste_int_difference(liste_int const a, liste_int const b);
+
+/*!
+ * \brief Union en place : les valeurs de b sont ajoutées à a, en réutilisant
+ * les maillons de b si a est chaînée. b est détruite.
+ * \param a ensemble modifié, sans courant en sortie.
+ * \param b (pointeur vers l')ensemble ajouté, vaut NULL en sortie.
+ */
+void liste_int_unir(liste_int const a, liste_int *const b);
+
+/*!
+ * \brief Intersection en place : a ne garde que les valeurs aussi dans b.
+ * Aucune allocation n'est faite si b est un tableau (pas d'insertion au
+ * milieu).
+ * \param a ensemble modifié, sans courant en sortie.
+ * \param b second ensemble, inchangé.
+ */
+void liste_int_intersecter(liste_int const a, liste_int const b);
+
+/*!
+ * \brief Différence en place : les valeurs de b sont retirées de a.
+ * \param a ensemble modifié, sans courant en sortie.
+ * \param b valeurs à retirer, inchangé.
+ */
+void liste_int_retrancher(liste_int const a, liste_int const b);
 
 #endif
@@ -0,0 +1,501 @@
+#define _POSIX_C_SOURCE 200809L
+#include "listes_int_fichier.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Signature des fichiers de liste. */
+#define SIGNATURE "LISTINT"
+/*! \brief Version du format des fichiers de liste. */
+#define VERSION 1
+/*! \brief Place réservée à l'en-tête au début du fichier. */
+#define TAILLE_ENTETE 64
+/*! \brief Nombre de maillons d'un fichier neuf. */
+#define CAPACITE_INITIALE 1024
+/*! \brief Indice nul : l'emplacement 0 n'est jamais utilisé. */
+#define AUCUN 0
+
+#define ASSERT_LISTE() assert(l != NULL);
+
+#define ASSERT_LISTE_COURANT()                                                 \
+  assert(l != NULL);                                                           \
+  assert(l->courant != AUCUN);
+
+/*!
+ * \brief Maillon tel qu'il est enregistré dans le fichier : ses voisins sont
+ * désignés par leur indice.
+ */
+typedef struct maillon {
+  uint32_t precedent;
+  uint32_t suivant;
+  int32_t val;
+} maillon;
+
+/*!
+ * \brief En-tête du fichier. Les maillons supprimés sont chaînés par suivant
+ * à partir de libres ; ceux d'indice au moins utilises n'ont jamais servi.
+ */
+typedef struct entete {
+  char signature[8];
+  uint32_t version;
+  uint32_t propre; /* 1 si rien n'a été modifié depuis la dernière
+                      validation */
+  uint64_t generation;
+  uint32_t taille;
+  uint32_t tete;
+  uint32_t pied;
+  uint32_t libres;
+  uint32_t utilises;
+  uint32_t capacite;
+} entete;
+
+/*!
+ * \brief Liste ouverte : la projection du fichier et le courant.
+ */
+struct liste_fichier_struct {
+  int fd;
+  entete *e;     /* début de la projection */
+  maillon *m;    /* maillons, juste après l'en-tête */
+  size_t octets; /* taille de la projection */
+  uint32_t courant;
+};
+
+/*!
+ * \brief Taille du fichier d'une liste de capacite maillons.
+ */
+static size_t octets_fichier(uint32_t capacite) {
+  return TAILLE_ENTETE + (size_t)capacite * sizeof(maillon);
+}
+
+/*!
+ * \brief Projette le fichier en mémoire.
+ * \param l liste dont fd et octets sont renseignés.
+ * \return true ssi la projection a réussi.
+ */
+static bool projeter(liste_fichier l) {
+  void *p =
+      mmap(NULL, l->octets, PROT_READ | PROT_WRITE, MAP_SHARED, l->fd, 0);
+  if (p == MAP_FAILED) {
+    return false;
+  }
+  l->e = p;
+  l->m = (maillon *)((char *)p + TAILLE_ENTETE);
+  return true;
+}
+
+/*!
+ * \brief Marque le fichier comme modifié, sur le disque, avant la première
+ * modification qui suit une validation.
+ */
+static void modifier(liste_fichier l) {
+  if (l->e->propre) {
+    l->e->propre = 0;
+    msync(l->e, sizeof(entete), MS_SYNC);
+  }
+}
+
+/*!
+ * \brief Double la capacité du fichier. Les maillons étant désignés par leur
+ * indice, la nouvelle projection peut être à une autre adresse.
+ */
+static void agrandir(liste_fichier l) {
+  uint32_t capacite = l->e->capacite;
+  assert(capacite <= UINT32_MAX / 2);
+  munmap(l->e, l->octets);
+  l->octets = octets_fichier(2 * capacite);
+  bool projete = ftruncate(l->fd, (off_t)l->octets) == 0 && projeter(l);
+  assert(projete);
+  (void)projete;
+  l->e->capacite = 2 * capacite;
+}
+
+/*!
+ * \brief Création d'un maillon bouclant sur lui-même.
+ * \param l liste où le maillon est pris.
+ * \param val valeur à stocker dans le maillon.
+ * \return l'indice du maillon.
+ */
+static uint32_t maillon_creer(liste_fichier l, int val) {
+  uint32_t i = l->e->libres;
+  if (i != AUCUN) {
+    l->e->libres = l->m[i].suivant;
+  } else {
+    if (l->e->utilises == l->e->capacite) {
+      agrandir(l);
+    }
+    i = l->e->utilises++;
+  }
+  l->m[i].precedent = l->m[i].suivant = i;
+  l->m[i].val = val;
+  return i;
+}
+
+/*!
+ * \brief Rend un maillon détaché de la liste.
+ */
+static void maillon_liberer(liste_fichier l, uint32_t i) {
+  l->m[i].suivant = l->e->libres;
+  l->e->libres = i;
+}
+
+/*!
+ * \brief Ajout d'un élément après le maillon d'indice i.
+ * \return l'indice du nouveau maillon.
+ */
+static uint32_t maillon_ajouter_apres(liste_fichier l, uint32_t i, int val) {
+  uint32_t n = maillon_creer(l, val);
+  maillon *m = l->m;
+  m[n].precedent = i;
+  m[n].suivant = m[i].suivant;
+  m[m[i].suivant].precedent = n;
+  m[i].suivant = n;
+  return n;
+}
+
+/*!
+ * \brief Retrait du maillon d'indice i de l'anneau, qui en compte au moins
+ * deux.
+ */
+static void maillon_retirer(liste_fichier l, uint32_t i) {
+  maillon *m = l->m;
+  m[m[i].precedent].suivant = m[i].suivant;
+  m[m[i].suivant].precedent = m[i].precedent;
+  maillon_liberer(l, i);
+}
+
+/*!
+ * \brief Initialisation d'une liste ouverte sur le descripteur fd.
+ */
+static liste_fichier liste_allouer(int fd, size_t octets) {
+  liste_fichier l = malloc(sizeof(struct liste_fichier_struct));
+  l->fd = fd;
+  l->octets = octets;
+  l->courant = AUCUN;
+  if (!projeter(l)) {
+    close(fd);
+    free(l);
+    return NULL;
+  }
+  return l;
+}
+
+liste_fichier liste_fichier_creer(char const *chemin) {
+  assert(chemin != NULL);
+  int fd = open(chemin, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return NULL;
+  }
+  size_t octets = octets_fichier(CAPACITE_INITIALE);
+  if (ftruncate(fd, (off_t)octets) != 0) {
+    close(fd);
+    return NULL;
+  }
+  liste_fichier l = liste_allouer(fd, octets);
+  if (l == NULL) {
+    return NULL;
+  }
+  memset(l->e, 0, sizeof(entete));
+  memcpy(l->e->signature, SIGNATURE, sizeof(SIGNATURE));
+  l->e->version = VERSION;
+  l->e->utilises = 1;
+  l->e->capacite = CAPACITE_INITIALE;
+  liste_fichier_valider(l);
+  return l;
+}
+
+/*!
+ * \brief Ouverture d'une liste enregistrée.
+ * \param chemin chemin du fichier.
+ * \param recuperation vrai pour accepter un fichier non validé, dont seuls la
+ * signature, la version et la capacité sont vérifiés.
+ * \return la liste, NULL si le fichier est refusé.
+ */
+static liste_fichier liste_ouvrir(char const *chemin, bool recuperation) {
+  assert(chemin != NULL);
+  int fd = open(chemin, O_RDWR);
+  struct stat st;
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < octets_fichier(0)) {
+    close(fd);
+    return NULL;
+  }
+  liste_fichier l = liste_allouer(fd, (size_t)st.st_size);
+  if (l == NULL) {
+    return NULL;
+  }
+  entete const *e = l->e;
+  if (memcmp(e->signature, SIGNATURE, sizeof(SIGNATURE)) != 0 ||
+      e->version != VERSION || octets_fichier(e->capacite) != l->octets ||
+      e->utilises == 0 || e->utilises > e->capacite ||
+      (!recuperation &&
+       (e->propre != 1 || e->tete >= e->utilises || e->pied >= e->utilises ||
+        (e->taille == 0) != (e->tete == AUCUN)))) {
+    munmap(l->e, l->octets);
+    close(fd);
+    free(l);
+    return NULL;
+  }
+  return l;
+}
+
+liste_fichier liste_fichier_ouvrir(char const *chemin) {
+  return liste_ouvrir(chemin, false);
+}
+
+liste_fichier liste_fichier_recuperer(char const *chemin) {
+  liste_fichier l = liste_ouvrir(chemin, true);
+  if (l == NULL) {
+    return NULL;
+  }
+  entete *e = l->e;
+  maillon *m = l->m;
+  modifier(l);
+  /* les suivants font foi : les precedents sont réécrits, et le parcours
+     s'arrête au retour à tete ou au premier indice invalide */
+  unsigned char *vus = calloc((size_t)e->utilises / 8 + 1, 1);
+  assert(vus != NULL);
+  uint32_t taille = 0;
+  uint32_t pied = AUCUN;
+  uint32_t i = e->tete;
+  while (i != AUCUN && i < e->utilises && !(vus[i / 8] & 1u << i % 8)) {
+    vus[i / 8] |= (unsigned char)(1u << i % 8);
+    m[i].precedent = pied;
+    pied = i;
+    taille++;
+    i = m[i].suivant;
+  }
+  if (taille == 0) {
+    e->tete = AUCUN;
+  } else {
+    m[pied].suivant = e->tete;
+    m[e->tete].precedent = pied;
+  }
+  e->pied = pied;
+  e->taille = taille;
+  /* les maillons non atteints sont libres */
+  e->libres = AUCUN;
+  for (i = e->utilises - 1; i != AUCUN; i--) {
+    if (!(vus[i / 8] & 1u << i % 8)) {
+      maillon_liberer(l, i);
+    }
+  }
+  free(vus);
+  liste_fichier_valider(l);
+  return l;
+}
+
+void liste_fichier_valider(liste_fichier l) {
+  ASSERT_LISTE();
+  if (!l->e->propre) {
+    /* les maillons d'abord : l'en-tête ne devient propre qu'ensuite */
+    msync(l->e, l->octets, MS_SYNC);
+    l->e->generation++;
+    l->e->propre = 1;
+    msync(l->e, sizeof(entete), MS_SYNC);
+  }
+}
+
+unsigned long long liste_fichier_generation(liste_fichier l) {
+  ASSERT_LISTE();
+  return l->e->generation;
+}
+
+void liste_fichier_fermer(liste_fichier *l) {
+  assert(l != NULL && *l != NULL);
+  liste_fichier_valider(*l);
+  munmap((*l)->e, (*l)->octets);
+  close((*l)->fd);
+  free(*l);
+  *l = NULL;
+}
+
+bool liste_fichier_est_vide(liste_fichier l) {
+  ASSERT_LISTE();
+  return l->e->taille == 0;
+}
+
+/*!
+ * \brief Pour ajouter une valeur à une liste vide.
+ */
+static void liste_ajouter_a_vide(liste_fichier l, int val) {
+  uint32_t i = maillon_creer(l, val);
+  l->e->tete = l->e->pied = i;
+  l->e->taille = 1;
+}
+
+void liste_fichier_insertion_debut(liste_fichier l, int val) {
+  ASSERT_LISTE();
+  modifier(l);
+  if (l->e->taille == 0) {
+    liste_ajouter_a_vide(l, val);
+  } else {
+    assert(l->e->taille < UINT32_MAX - 1);
+    /* l'ajout peut déplacer la projection : l->e est relu ensuite */
+    uint32_t n = maillon_ajouter_apres(l, l->e->pied, val);
+    l->e->tete = n;
+    l->e->taille++;
+  }
+}
+
+void liste_fichier_insertion_fin(liste_fichier l, int val) {
+  ASSERT_LISTE();
+  modifier(l);
+  if (l->e->taille == 0) {
+    liste_ajouter_a_vide(l, val);
+  } else {
+    assert(l->e->taille < UINT32_MAX - 1);
+    /* l'ajout peut déplacer la projection : l->e est relu ensuite */
+    uint32_t n = maillon_ajouter_apres(l, l->e->pied, val);
+    l->e->pied = n;
+    l->e->taille++;
+  }
+}
+
+void liste_fichier_insertion_apres(liste_fichier l, int val) {
+  ASSERT_LISTE_COURANT();
+  modifier(l);
+  uint32_t n = maillon_ajouter_apres(l, l->courant, val);
+  l->e->taille++;
+  if (l->courant == l->e->pied) {
+    l->e->pied = n;
+  }
+}
+
+void liste_fichier_insertion_avant(liste_fichier l, int val) {
+  ASSERT_LISTE_COURANT();
+  modifier(l);
+  uint32_t n = maillon_ajouter_apres(l, l->m[l->courant].precedent, val);
+  l->e->taille++;
+  if (l->courant == l->e->tete) {
+    l->e->tete = n;
+  }
+}
+
+/*!
+ * \brief Suppression du maillon d'indice i, en mettant à jour tete, pied et
+ * courant (qui devient nul s'il est supprimé).
+ */
+static void liste_supprimer(liste_fichier l, uint32_t i) {
+  modifier(l);
+  if (l->e->taille == 1) {
+    maillon_liberer(l, i);
+    l->e->tete = l->e->pied = AUCUN;
+    l->courant = AUCUN;
+  } else {
+    if (i == l->e->tete) {
+      l->e->tete = l->m[i].suivant;
+    }
+    if (i == l->e->pied) {
+      l->e->pied = l->m[i].precedent;
+    }
+    if (i == l->courant) {
+      l->courant = AUCUN;
+    }
+    maillon_retirer(l, i);
+  }
+  l->e->taille--;
+}
+
+void liste_fichier_suppression_debut(liste_fichier l) {
+  ASSERT_LISTE();
+  assert(l->e->taille > 0);
+  liste_supprimer(l, l->e->tete);
+}
+
+void liste_fichier_suppression_fin(liste_fichier l) {
+  ASSERT_LISTE();
+  assert(l->e->taille > 0);
+  liste_supprimer(l, l->e->pied);
+}
+
+void liste_fichier_suppression_avant(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  if (l->e->taille >= 2) {
+    liste_supprimer(l, l->m[l->courant].precedent);
+  }
+}
+
+void liste_fichier_suppression_apres(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  if (l->e->taille >= 2) {
+    liste_supprimer(l, l->m[l->courant].suivant);
+  }
+}
+
+void liste_fichier_affichage(FILE *f, liste_fichier l) {
+  assert(f != NULL);
+  ASSERT_LISTE();
+  fprintf(f, "Liste de %u éléments : [", (unsigned int)l->e->taille);
+  uint32_t i = l->e->tete;
+  for (uint32_t k = 0; k < l->e->taille; k++) {
+    fprintf(f, " %d", (int)l->m[i].val);
+    i = l->m[i].suivant;
+  }
+  fprintf(f, " ]");
+}
+
+void liste_fichier_courant_init(liste_fichier l) {
+  ASSERT_LISTE();
+  l->courant = l->e->tete;
+}
+
+void liste_fichier_courant_suivant(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  l->courant = l->m[l->courant].suivant;
+}
+
+void liste_fichier_decalage(liste_fichier l, int n) {
+  ASSERT_LISTE_COURANT();
+  for (; n > 0; n--) {
+    l->courant = l->m[l->courant].suivant;
+  }
+  for (; n < 0; n++) {
+    l->courant = l->m[l->courant].precedent;
+  }
+}
+
+int liste_fichier_taille(liste_fichier l) {
+  ASSERT_LISTE();
+  return (int)l->e->taille;
+}
+
+int liste_fichier_valeur_tete(liste_fichier l) {
+  ASSERT_LISTE();
+  assert(l->e->taille > 0);
+  return l->m[l->e->tete].val;
+}
+
+int liste_fichier_valeur_pied(liste_fichier l) {
+  ASSERT_LISTE();
+  assert(l->e->taille > 0);
+  return l->m[l->e->pied].val;
+}
+
+int liste_fichier_valeur_courant(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  return l->m[l->courant].val;
+}
+
+bool liste_fichier_est_tete(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  return l->courant == l->e->tete;
+}
+
+bool liste_fichier_est_pied(liste_fichier l) {
+  ASSERT_LISTE_COURANT();
+  return l->courant == l->e->pied;
+}
@@ -0,0 +1,214 @@
+#ifndef LISTES_INT_FICHIER
+#define LISTES_INT_FICHIER
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/*! \file
+ * \brief Module liste d'entiers persistante.
+ *
+ * La liste a le même comportement que celle de listes_int, mais ses maillons
+ * sont stockés dans un fichier projeté en mémoire. Ils sont chaînés par leur
+ * indice dans le fichier et non par des pointeurs : le fichier ne dépend pas
+ * de l'adresse de la projection, et l'ouverture d'une liste existante ne
+ * demande aucune lecture ni reconstruction, quelle que soit sa taille.
+ *
+ * Les modifications sont faites directement dans le fichier. Elles ne sont
+ * garanties sur le disque qu'aux validations (liste_fichier_valider), qui
+ * incrémentent un numéro de génération enregistré dans l'en-tête. Un fichier
+ * modifié depuis sa dernière validation (arrêt brutal du programme) est
+ * refusé à l'ouverture ; liste_fichier_recuperer le reconstruit.
+ *
+ * Le fichier est lié à l'architecture (entiers natifs) ; la liste contient au
+ * plus 2^32 - 2 éléments. Le courant n'est pas enregistré.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Cette structure permet de manipuler une liste d'entiers ouverte.
+ * Elle est cachée et ne doit jamais être manipulée directement.
+ */
+typedef struct liste_fichier_struct *liste_fichier;
+
+/*!
+ * \brief Création d'une liste vide dans un fichier, remplacé s'il existe.
+ * \param chemin chemin du fichier.
+ * \return la nouvelle liste, NULL si le fichier n'a pas pu être créé.
+ */
+liste_fichier liste_fichier_creer(char const *chemin);
+
+/*!
+ * \brief Ouverture, en temps constant, d'une liste déjà enregistrée.
+ * \param chemin chemin du fichier.
+ * \return la liste, NULL si le fichier n'a pas pu être ouvert, n'est pas une
+ * liste ou a été modifié depuis sa dernière validation.
+ */
+liste_fichier liste_fichier_ouvrir(char const *chemin);
+
+/*!
+ * \brief Ouverture d'une liste, même modifiée depuis sa dernière validation :
+ * la liste est reconstruite en suivant les maillons depuis la tete, qui
+ * donnent la taille, le pied et les maillons libres, puis validée. Après un
+ * arrêt du programme, seul l'élément de l'opération interrompue peut manquer
+ * ou être mal placé ; après une panne du système, les maillons qui suivent
+ * le premier lien invalide sont perdus. Le coût est linéaire.
+ * \param chemin chemin du fichier.
+ * \return la liste, NULL si le fichier n'a pas pu être ouvert ou n'est pas
+ * une liste.
+ */
+liste_fichier liste_fichier_recuperer(char const *chemin);
+
+/*!
+ * \brief Valide les modifications : elles sont écrites sur le disque, puis le
+ * numéro de génération est incrémenté. Ne fait rien si la liste n'a pas été
+ * modifiée depuis la validation précédente.
+ * \param l liste à valider.
+ */
+void liste_fichier_valider(liste_fichier l);
+
+/*!
+ * \brief Numéro de génération : le nombre de validations depuis la création
+ * du fichier.
+ * \param l liste sur laquelle porte la demande.
+ * \return le numéro de la dernière validation.
+ */
+unsigned long long liste_fichier_generation(liste_fichier l);
+
+/*!
+ * \brief Valide puis ferme la liste ; le fichier est conservé.
+ * \param l (pointeur vers la) liste à fermer, vaut NULL en sortie.
+ */
+void liste_fichier_fermer(liste_fichier *l);
+
+/*!
+ * \brief Pour savoir si une liste est vide ou non.
+ * \param l liste à tester.
+ * \return true ssi la liste est vide.
+ */
+bool liste_fichier_est_vide(liste_fichier l);
+
+/*!
+ * \brief Insertion en début de liste.
+ * \param l liste où insérer.
+ * \param val valeur entière à insérer.
+ */
+void liste_fichier_insertion_debut(liste_fichier l, int val);
+
+/*!
+ * \brief Insertion en fin de liste.
+ * \param l liste où insérer.
+ * \param val valeur entière à insérer.
+ */
+void liste_fichier_insertion_fin(liste_fichier l, int val);
+
+/*!
+ * \brief Insertion après le maillon courant.
+ * \param l liste où insérer.
+ * \param val valeur entière à insérer.
+ */
+void liste_fichier_insertion_apres(liste_fichier l, int val);
+
+/*!
+ * \brief Insertion avant le maillon courant.
+ * \param l liste où insérer.
+ * \param val valeur entière à insérer.
+ */
+void liste_fichier_insertion_avant(liste_fichier l, int val);
+
+/*!
+ * \brief Suppression de l'élément en tete de liste.
+ * \param l liste d'où supprimer.
+ */
+void liste_fichier_suppression_debut(liste_fichier l);
+
+/*!
+ * \brief Suppression de l'élément en pied de liste.
+ * \param l liste d'où supprimer.
+ */
+void liste_fichier_suppression_fin(liste_fichier l);
+
+/*!
+ * \brief Suppression de l'élément avant courant s'il existe.
+ * \param l liste d'où supprimer.
+ */
+void liste_fichier_suppression_avant(liste_fichier l);
+
+/*!
+ * \brief Suppression de l'élément après courant s'il existe.
+ * \param l liste d'où supprimer.
+ */
+void liste_fichier_suppression_apres(liste_fichier l);
+
+/*!
+ * \brief Affichage des éléments de la liste, de la forme
+ * \verbatim Liste de 5 éléments : [ -1 -3 10 15 20 ]\endverbatim
+ * sans passage à la ligne à la fin.
+ * \param f flux où imprimer.
+ * \param l liste à afficher.
+ */
+void liste_fichier_affichage(FILE *f, liste_fichier l);
+
+/*!
+ * \brief Initialise courant à tete.
+ * \param l liste à parcourir.
+ */
+void liste_fichier_courant_init(liste_fichier l);
+
+/*!
+ * \brief Passe courant sur l'élément suivant.
+ * \param l liste parcourue.
+ */
+void liste_fichier_courant_suivant(liste_fichier l);
+
+/*!
+ * \brief Décalage de courant de n positions, vers la tête si n est négatif.
+ * \param l liste parcourue.
+ * \param n nombre de décalage à faire.
+ */
+void liste_fichier_decalage(liste_fichier l, int n);
+
+/*!
+ * \brief Retourne la taille de la liste.
+ * \param l liste sur laquelle porte la demande.
+ * \return le nombre d'éléments dans la liste.
+ */
+int liste_fichier_taille(liste_fichier l);
+
+/*!
+ * \brief Retourne la valeur de tete.
+ * \param l liste non vide sur laquelle porte la demande.
+ * \return la première valeur de la liste.
+ */
+int liste_fichier_valeur_tete(liste_fichier l);
+
+/*!
+ * \brief Retourne la valeur de pied.
+ * \param l liste non vide sur laquelle porte la demande.
+ * \return la dernière valeur de la liste.
+ */
+int liste_fichier_valeur_pied(liste_fichier l);
+
+/*!
+ * \brief Retourne la valeur de courant.
+ * \param l liste parcourue sur laquelle porte la demande.
+ * \return la valeur de l'élément courant de la liste.
+ */
+int liste_fichier_valeur_courant(liste_fichier l);
+
+/*!
+ * \brief Retourne vrai si courant pointe sur tete.
+ * \param l liste parcourue sur laquelle porte la demande.
+ * \return true si la tete est l'élément courant.
+ */
+bool liste_fichier_est_tete(liste_fichier l);
+
+/*!
+ * \brief Retourne vrai si courant pointe sur pied.
+ * \param l liste parcourue sur laquelle porte la demande.
+ * \return true si le pied est l'élément courant.
+ */
+bool liste_fichier_est_pied(liste_fichier l);
+
+#endif
@@ -0,0 +1,346 @@
+#include "listes_trace.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \file
+ * \brief La documentation pour les parties internes du module est ici.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*! \brief Signature des fichiers de trace. */
+#define SIGNATURE "LTRACE"
+/*! \brief Version du format des fichiers de trace. */
+#define VERSION 1
+/*! \brief Taille de chacun des deux tampons d'écriture. */
+#define TAILLE_TAMPON 65536
+
+/*! \brief Nombre d'arguments de chaque opération, hors valeurs de
+ * liste_remplacer_courant. */
+static unsigned int const nb_arguments[TRACE_NB_OPERATIONS] = {
+    [TRACE_CREER] = 1,           [TRACE_INSERTION_DEBUT] = 1,
+    [TRACE_INSERTION_FIN] = 1,   [TRACE_INSERTION_APRES] = 1,
+    [TRACE_INSERTION_AVANT] = 1, [TRACE_DECALAGE] = 1,
+    [TRACE_REMPLACER_COURANT] = 2, [TRACE_COMPACTER_ETAPE] = 1};
+
+/*! \brief Noms des opérations. */
+static char const *const noms[TRACE_NB_OPERATIONS] = {
+    "creer",           "detruire",          "detruire_differe",
+    "abandon",         "est_vide",          "insertion_debut",
+    "insertion_fin",   "insertion_apres",   "insertion_avant",
+    "suppression_debut", "suppression_fin", "suppression_avant",
+    "suppression_apres", "affichage",       "courant_init",
+    "courant_suivant", "decalage",          "taille",
+    "valeur_tete",     "valeur_pied",       "valeur_courant",
+    "est_tete",        "est_pied",          "remplacer_courant",
+    "compacter",       "compacter_etape"};
+
+/*!
+ * \brief Trace en cours. Les appels remplissent tampons[courant] sous verrou ;
+ * un tampon plein est confié au thread d'écriture (a_ecrire) et l'autre
+ * prend sa place, après la fin de son écriture précédente.
+ */
+static struct {
+  bool active;            /* une trace est en cours */
+  FILE *f;
+  unsigned char tampons[2][TAILLE_TAMPON];
+  size_t remplis;         /* octets de tampons[courant] */
+  unsigned int courant;   /* tampon en remplissage */
+  int a_ecrire;           /* tampon plein à écrire, -1 si aucun */
+  size_t octets_a_ecrire; /* octets du tampon a_ecrire */
+  bool en_ecriture;       /* le thread écrit l'autre tampon */
+  bool fin;               /* listes_trace_arreter a été appelée */
+  bool erreur;            /* une écriture a échoué */
+  unsigned long numero;   /* dernier numéro de liste attribué */
+  unsigned long premier;  /* premier numéro de la trace en cours */
+  pthread_t ecrivain;
+  pthread_mutex_t verrou;
+  pthread_cond_t plein; /* un tampon est à écrire, ou fin */
+  pthread_cond_t libre; /* l'écriture d'un tampon est terminée */
+} trace_en_cours = {.a_ecrire = -1,
+                    .verrou = PTHREAD_MUTEX_INITIALIZER,
+                    .plein = PTHREAD_COND_INITIALIZER,
+                    .libre = PTHREAD_COND_INITIALIZER};
+
+/*! \brief Thread d'écriture des tampons pleins. */
+static void *ecrire_tampons(void *arg) {
+  (void)arg;
+  pthread_mutex_lock(&trace_en_cours.verrou);
+  for (;;) {
+    while (trace_en_cours.a_ecrire < 0 && !trace_en_cours.fin) {
+      pthread_cond_wait(&trace_en_cours.plein, &trace_en_cours.verrou);
+    }
+    if (trace_en_cours.a_ecrire < 0) {
+      break;
+    }
+    int i = trace_en_cours.a_ecrire;
+    size_t n = trace_en_cours.octets_a_ecrire;
+    trace_en_cours.a_ecrire = -1;
+    trace_en_cours.en_ecriture = true;
+    pthread_mutex_unlock(&trace_en_cours.verrou);
+    bool ecrit = fwrite(trace_en_cours.tampons[i], 1, n, trace_en_cours.f) == n;
+    pthread_mutex_lock(&trace_en_cours.verrou);
+    trace_en_cours.erreur |= !ecrit;
+    trace_en_cours.en_ecriture = false;
+    pthread_cond_broadcast(&trace_en_cours.libre);
+  }
+  pthread_mutex_unlock(&trace_en_cours.verrou);
+  return NULL;
+}
+
+/*!
+ * \brief Confie le tampon courant au thread d'écriture et passe à l'autre,
+ * dès que son écriture précédente est terminée. Verrou pris.
+ */
+static void tampon_basculer(void) {
+  while (trace_en_cours.en_ecriture || trace_en_cours.a_ecrire >= 0) {
+    pthread_cond_wait(&trace_en_cours.libre, &trace_en_cours.verrou);
+  }
+  trace_en_cours.a_ecrire = (int)trace_en_cours.courant;
+  trace_en_cours.octets_a_ecrire = trace_en_cours.remplis;
+  trace_en_cours.courant ^= 1;
+  trace_en_cours.remplis = 0;
+  pthread_cond_signal(&trace_en_cours.plein);
+}
+
+/*! \brief Ajoute un octet au tampon courant. Verrou pris. */
+static void tampon_octet(unsigned char octet) {
+  if (trace_en_cours.remplis == TAILLE_TAMPON) {
+    tampon_basculer();
+  }
+  trace_en_cours.tampons[trace_en_cours.courant][trace_en_cours.remplis++] =
+      octet;
+}
+
+/*!
+ * \brief Écriture d'un entier LEB128 : 7 bits par octet, le bit de poids fort
+ * indiquant qu'un octet suit. Verrou pris.
+ */
+static void tampon_leb128(unsigned long long n) {
+  while (n >= 0x80) {
+    tampon_octet((unsigned char)(n | 0x80));
+    n >>= 7;
+  }
+  tampon_octet((unsigned char)n);
+}
+
+/*! \brief Écriture d'un entier signé, zigzag puis LEB128. Verrou pris. */
+static void tampon_entier(int v) {
+  tampon_leb128(v < 0 ? 2ULL * (unsigned int)(-(v + 1)) + 1
+                      : 2ULL * (unsigned int)v);
+}
+
+bool listes_trace_demarrer(char const *chemin) {
+  assert(chemin != NULL);
+  pthread_mutex_lock(&trace_en_cours.verrou);
+  if (trace_en_cours.active) {
+    pthread_mutex_unlock(&trace_en_cours.verrou);
+    return false;
+  }
+  FILE *f = fopen(chemin, "wb");
+  if (f == NULL) {
+    pthread_mutex_unlock(&trace_en_cours.verrou);
+    return false;
+  }
+  fwrite(SIGNATURE, 1, sizeof(SIGNATURE), f);
+  fputc(VERSION, f);
+  trace_en_cours.f = f;
+  trace_en_cours.remplis = 0;
+  trace_en_cours.courant = 0;
+  trace_en_cours.a_ecrire = -1;
+  trace_en_cours.en_ecriture = false;
+  trace_en_cours.fin = false;
+  trace_en_cours.erreur = false;
+  trace_en_cours.premier = trace_en_cours.numero + 1;
+  if (pthread_create(&trace_en_cours.ecrivain, NULL, &ecrire_tampons, NULL) !=
+      0) {
+    fclose(f);
+    pthread_mutex_unlock(&trace_en_cours.verrou);
+    return false;
+  }
+  __atomic_store_n(&trace_en_cours.active, true, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&trace_en_cours.verrou);
+  return true;
+}
+
+bool listes_trace_arreter(void) {
+  pthread_mutex_lock(&trace_en_cours.verrou);
+  if (!trace_en_cours.active) {
+    pthread_mutex_unlock(&trace_en_cours.verrou);
+    return false;
+  }
+  __atomic_store_n(&trace_en_cours.active, false, __ATOMIC_RELAXED);
+  if (trace_en_cours.remplis > 0) {
+    tampon_basculer();
+  }
+  trace_en_cours.fin = true;
+  pthread_cond_signal(&trace_en_cours.plein);
+  pthread_mutex_unlock(&trace_en_cours.verrou);
+  pthread_join(trace_en_cours.ecrivain, NULL);
+  bool ecrit = !trace_en_cours.erreur;
+  ecrit &= fclose(trace_en_cours.f) == 0;
+  trace_en_cours.f = NULL;
+  return ecrit;
+}
+
+unsigned long listes_trace_creation(trace_module module) {
+  if (!__atomic_load_n(&trace_en_cours.active, __ATOMIC_RELAXED)) {
+    return 0;
+  }
+  pthread_mutex_lock(&trace_en_cours.verrou);
+  unsigned long liste = 0;
+  if (trace_en_cours.active) {
+    liste = ++trace_en_cours.numero;
+    tampon_octet(TRACE_CREER);
+    tampon_leb128(liste - trace_en_cours.premier + 1);
+    tampon_entier((int)module);
+  }
+  pthread_mutex_unlock(&trace_en_cours.verrou);
+  return liste;
+}
+
+void listes_trace_appel(unsigned long liste, trace_operation operation,
+                        int const *arguments, unsigned int nb) {
+  assert(liste != 0 && operation < TRACE_NB_OPERATIONS);
+  assert(nb == 0 || arguments != NULL);
+  if (!__atomic_load_n(&trace_en_cours.active, __ATOMIC_RELAXED)) {
+    return;
+  }
+  pthread_mutex_lock(&trace_en_cours.verrou);
+  /* une liste d'une trace précédente n'est plus tracée */
+  if (trace_en_cours.active && liste >= trace_en_cours.premier) {
+    tampon_octet((unsigned char)operation);
+    tampon_leb128(liste - trace_en_cours.premier + 1);
+    for (unsigned int i = 0; i < nb; i++) {
+      tampon_entier(arguments[i]);
+    }
+  }
+  pthread_mutex_unlock(&trace_en_cours.verrou);
+}
+
+/*! \brief Lecture d'un entier LEB128 dans [*p, fin[, qui avance *p. */
+static bool lire_leb128(unsigned char const **p, unsigned char const *fin,
+                        unsigned long long *n) {
+  *n = 0;
+  for (unsigned int decalage = 0; decalage < 64; decalage += 7) {
+    if (*p == fin) {
+      return false;
+    }
+    unsigned char octet = *(*p)++;
+    *n |= (unsigned long long)(octet & 0x7F) << decalage;
+    if ((octet & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*! \brief Lecture d'un entier signé écrit par tampon_entier. */
+static bool lire_entier(unsigned char const **p, unsigned char const *fin,
+                        int *v) {
+  unsigned long long n;
+  if (!lire_leb128(p, fin, &n) || n > 0xFFFFFFFFULL) {
+    return false;
+  }
+  *v = (n & 1) ? -(int)(n >> 1) - 1 : (int)(n >> 1);
+  return true;
+}
+
+/*! \brief Lecture du contenu d'un fichier, libéré par l'appelant. */
+static unsigned char *lire_fichier(char const *chemin, size_t *taille) {
+  FILE *f = fopen(chemin, "rb");
+  if (f == NULL) {
+    return NULL;
+  }
+  size_t capacite = TAILLE_TAMPON;
+  unsigned char *contenu = malloc(capacite);
+  assert(contenu != NULL);
+  *taille = 0;
+  size_t lus;
+  while ((lus = fread(contenu + *taille, 1, capacite - *taille, f)) > 0) {
+    *taille += lus;
+    if (*taille == capacite) {
+      capacite *= 2;
+      contenu = realloc(contenu, capacite);
+      assert(contenu != NULL);
+    }
+  }
+  bool erreur = ferror(f);
+  fclose(f);
+  if (erreur) {
+    free(contenu);
+    return NULL;
+  }
+  return contenu;
+}
+
+bool listes_trace_lire(char const *chemin, trace *t) {
+  assert(chemin != NULL && t != NULL);
+  memset(t, 0, sizeof(trace));
+  size_t taille;
+  unsigned char *contenu = lire_fichier(chemin, &taille);
+  if (contenu == NULL) {
+    return false;
+  }
+  unsigned char const *p = contenu + sizeof(SIGNATURE) + 1;
+  unsigned char const *fin = contenu + taille;
+  bool valide = taille >= sizeof(SIGNATURE) + 1 &&
+                memcmp(contenu, SIGNATURE, sizeof(SIGNATURE)) == 0 &&
+                contenu[sizeof(SIGNATURE)] == VERSION;
+  size_t capacite = 0, capacite_valeurs = 0;
+  while (valide && p < fin) {
+    trace_appel a = {(trace_operation)*p++, 0, 0, 0, 0};
+    unsigned long long liste;
+    valide = a.operation < TRACE_NB_OPERATIONS && lire_leb128(&p, fin, &liste) &&
+             liste != 0 && liste <= (unsigned long)-1;
+    a.liste = (unsigned long)liste;
+    if (valide && nb_arguments[a.operation] > 0) {
+      valide = lire_entier(&p, fin, &a.argument);
+    }
+    if (valide && a.operation == TRACE_REMPLACER_COURANT) {
+      valide = lire_entier(&p, fin, &a.position) && a.argument > 0 &&
+               a.position >= 0 && a.position < a.argument;
+      a.valeurs = t->nb_valeurs;
+      for (int i = 0; valide && i < a.argument; i++) {
+        if (t->nb_valeurs == capacite_valeurs) {
+          capacite_valeurs = capacite_valeurs == 0 ? 64 : 2 * capacite_valeurs;
+          t->valeurs = realloc(t->valeurs, capacite_valeurs * sizeof(int));
+          assert(t->valeurs != NULL);
+        }
+        valide = lire_entier(&p, fin, &t->valeurs[t->nb_valeurs++]);
+      }
+    }
+    if (valide) {
+      if (t->nb_appels == capacite) {
+        capacite = capacite == 0 ? 1024 : 2 * capacite;
+        t->appels = realloc(t->appels, capacite * sizeof(trace_appel));
+        assert(t->appels != NULL);
+      }
+      t->appels[t->nb_appels++] = a;
+      if (a.liste > t->nb_listes) {
+        t->nb_listes = a.liste;
+      }
+    }
+  }
+  free(contenu);
+  if (!valide) {
+    listes_trace_liberer(t);
+  }
+  return valide;
+}
+
+void listes_trace_liberer(trace *t) {
+  assert(t != NULL);
+  free(t->appels);
+  free(t->valeurs);
+  memset(t, 0, sizeof(trace));
+}
+
+char const *listes_trace_nom(trace_operation operation) {
+  assert(operation < TRACE_NB_OPERATIONS);
+  return noms[operation];
+}
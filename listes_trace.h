@@ -0,0 +1,149 @@
+#ifndef LISTES_TRACE
+#define LISTES_TRACE
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! \file
+ * \brief Module de trace des appels aux listes.
+ *
+ * Pendant une trace, chaque appel public à une liste de listes_int ou de
+ * listes_generiques créée depuis le début de la trace est enregistré avec ses
+ * arguments dans un fichier binaire compact : un octet d'opération, le numéro
+ * de la liste puis les arguments entiers, en LEB128 (zigzag pour les
+ * arguments). Les enregistrements sont accumulés dans deux tampons ; un
+ * thread écrit l'un pendant que l'autre se remplit.
+ *
+ * Seules les valeurs des listes d'entiers sont enregistrées, 0 pour les
+ * autres. Une opération sans équivalent dans les deux modules (scission,
+ * concaténation, tri, opérations ensemblistes) arrête la trace de la liste
+ * modifiée, ce qui est enregistré comme un abandon.
+ *
+ * Le programme rejouer relit une trace et la rejoue sur une des
+ * implémentations de listes en mesurant son temps.
+ *
+ * \copyright PASD
+ * \version 2016
+ */
+
+/*!
+ * \brief Opérations enregistrées, un octet dans la trace.
+ */
+typedef enum trace_operation {
+  TRACE_CREER,             /* argument : le module (trace_module) */
+  TRACE_DETRUIRE,
+  TRACE_DETRUIRE_DIFFERE,
+  TRACE_ABANDON,           /* la liste n'est plus tracée */
+  TRACE_EST_VIDE,
+  TRACE_INSERTION_DEBUT,   /* argument : la valeur insérée */
+  TRACE_INSERTION_FIN,     /* argument : la valeur insérée */
+  TRACE_INSERTION_APRES,   /* argument : la valeur insérée */
+  TRACE_INSERTION_AVANT,   /* argument : la valeur insérée */
+  TRACE_SUPPRESSION_DEBUT,
+  TRACE_SUPPRESSION_FIN,
+  TRACE_SUPPRESSION_AVANT,
+  TRACE_SUPPRESSION_APRES,
+  TRACE_AFFICHAGE,
+  TRACE_COURANT_INIT,
+  TRACE_COURANT_SUIVANT,
+  TRACE_DECALAGE,          /* argument : le décalage */
+  TRACE_TAILLE,
+  TRACE_VALEUR_TETE,
+  TRACE_VALEUR_PIED,
+  TRACE_VALEUR_COURANT,
+  TRACE_EST_TETE,
+  TRACE_EST_PIED,
+  TRACE_REMPLACER_COURANT, /* arguments : k, la position puis les k valeurs */
+  TRACE_COMPACTER,
+  TRACE_COMPACTER_ETAPE,   /* argument : le nombre maximal de maillons */
+  TRACE_NB_OPERATIONS
+} trace_operation;
+
+/*!
+ * \brief Module d'une liste créée pendant la trace.
+ */
+typedef enum trace_module {
+  TRACE_MODULE_INT,
+  TRACE_MODULE_GENERIQUES, /* valeurs copiées par la fonction copier */
+  TRACE_MODULE_POD         /* valeurs stockées dans les maillons */
+} trace_module;
+
+/*!
+ * \brief Un appel relu dans une trace.
+ */
+typedef struct trace_appel {
+  trace_operation operation;
+  unsigned long liste; /* numéro de la liste, à partir de 1 */
+  int argument;        /* premier argument, 0 si l'opération n'en a pas */
+  int position;        /* position de liste_remplacer_courant */
+  size_t valeurs;      /* indice dans trace.valeurs des valeurs de
+                          liste_remplacer_courant */
+} trace_appel;
+
+/*!
+ * \brief Une trace relue.
+ */
+typedef struct trace {
+  trace_appel *appels;
+  size_t nb_appels;
+  unsigned long nb_listes; /* plus grand numéro de liste */
+  int *valeurs;            /* valeurs de liste_remplacer_courant */
+  size_t nb_valeurs;
+} trace;
+
+/*!
+ * \brief Démarre la trace des listes créées à partir de maintenant.
+ * \param chemin fichier de la trace, remplacé s'il existe.
+ * \return false si le fichier n'a pas pu être créé ou si une trace est déjà
+ * en cours.
+ */
+bool listes_trace_demarrer(char const *chemin);
+
+/*!
+ * \brief Arrête la trace : les tampons sont écrits et le fichier fermé. Les
+ * listes tracées ne le sont plus.
+ * \return false si une écriture a échoué.
+ */
+bool listes_trace_arreter(void);
+
+/*!
+ * \brief Numérote une liste qui vient d'être créée et enregistre sa
+ * création. Réservé aux modules de listes.
+ * \param module module de la liste.
+ * \return son numéro, 0 s'il n'y a pas de trace en cours.
+ */
+unsigned long listes_trace_creation(trace_module module);
+
+/*!
+ * \brief Enregistre un appel sur une liste tracée. Réservé aux modules de
+ * listes.
+ * \param liste numéro de la liste, non nul.
+ * \param operation opération appelée.
+ * \param arguments arguments entiers de l'appel.
+ * \param nb nombre d'arguments.
+ */
+void listes_trace_appel(unsigned long liste, trace_operation operation,
+                        int const *arguments, unsigned int nb);
+
+/*!
+ * \brief Relit une trace.
+ * \param chemin fichier de la trace.
+ * \param t trace à remplir, à libérer par listes_trace_liberer.
+ * \return false si le fichier n'a pas pu être lu ou n'est pas une trace.
+ */
+bool listes_trace_lire(char const *chemin, trace *t);
+
+/*!
+ * \brief Libère une trace relue.
+ * \param t trace à libérer.
+ */
+void listes_trace_liberer(trace *t);
+
+/*!
+ * \brief Nom d'une opération, celui de la fonction sans son préfixe.
+ * \param operation opération.
+ * \return le nom, par exemple "insertion_fin".
+ */
+char const *listes_trace_nom(trace_operation operation);
+
+#endif
@@ -0,0 +1,402 @@
+#define _POSIX_C_SOURCE 200809L
+#include "listes_generiques.h"
+#include "listes_int.h"
+#include "listes_trace.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Rejoue une trace enregistrée par listes_trace sur une ou plusieurs
+ * implémentations de listes (cibles) : listes_int, listes_generiques aux
+ * valeurs copiées, ou aux entiers stockés dans les maillons. La trace est lue
+ * entièrement avant la mesure ; seuls les appels sont chronométrés, les listes
+ * encore vivantes à la fin de la trace étant détruites hors mesure.
+ * Le résultat est un fichier CSV sur la sortie standard, une ligne par cible
+ * avec une somme de contrôle des valeurs lues, identique pour toutes les
+ * cibles, puis la médiane du temps total et du temps par appel. Avec
+ * --detail, le nombre d'appels de chaque opération est affiché avant.
+ */
+
+/* Nombre de répétitions par défaut. */
+#define REPETITIONS 5
+
+static FILE *nul;
+
+static double ns_depuis(struct timespec const *debut) {
+  struct timespec fin;
+  clock_gettime(CLOCK_MONOTONIC, &fin);
+  return (double)(fin.tv_sec - debut->tv_sec) * 1e9 +
+         (double)(fin.tv_nsec - debut->tv_nsec);
+}
+
+static int comparer_doubles(void const *a, void const *b) {
+  double x = *(double const *)a, y = *(double const *)b;
+  return (x > y) - (x < y);
+}
+
+/* Ajoute une valeur lue à la somme de contrôle. */
+static void controler(unsigned long long *controle, long long v) {
+  *controle = *controle * 1000003ULL + (unsigned long long)v;
+}
+
+/* Plus grand nombre de valeurs d'un appel à liste_remplacer_courant. */
+static unsigned int max_remplacements(trace const *t) {
+  unsigned int k = 1;
+  for (size_t i = 0; i < t->nb_appels; i++) {
+    if (t->appels[i].operation == TRACE_REMPLACER_COURANT &&
+        (unsigned int)t->appels[i].argument > k) {
+      k = (unsigned int)t->appels[i].argument;
+    }
+  }
+  return k;
+}
+
+static double rejouer_int(trace const *t, unsigned long long *controle) {
+  liste_int *listes = calloc(t->nb_listes + 1, sizeof(liste_int));
+  assert(listes != NULL);
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (size_t i = 0; i < t->nb_appels; i++) {
+    trace_appel const *a = &t->appels[i];
+    liste_int l = listes[a->liste];
+    if (l == NULL && a->operation != TRACE_CREER) {
+      continue;
+    }
+    switch (a->operation) {
+    case TRACE_CREER:
+      listes[a->liste] = liste_int_creer();
+      break;
+    case TRACE_DETRUIRE:
+    case TRACE_ABANDON:
+      liste_int_detruire(&listes[a->liste]);
+      break;
+    case TRACE_DETRUIRE_DIFFERE:
+      liste_int_detruire_differe(&listes[a->liste]);
+      break;
+    case TRACE_EST_VIDE:
+      controler(controle, liste_int_est_vide(l));
+      break;
+    case TRACE_INSERTION_DEBUT:
+      liste_int_insertion_debut(l, a->argument);
+      break;
+    case TRACE_INSERTION_FIN:
+      liste_int_insertion_fin(l, a->argument);
+      break;
+    case TRACE_INSERTION_APRES:
+      liste_int_insertion_apres(l, a->argument);
+      break;
+    case TRACE_INSERTION_AVANT:
+      liste_int_insertion_avant(l, a->argument);
+      break;
+    case TRACE_SUPPRESSION_DEBUT:
+      liste_int_suppression_debut(l);
+      break;
+    case TRACE_SUPPRESSION_FIN:
+      liste_int_suppression_fin(l);
+      break;
+    case TRACE_SUPPRESSION_AVANT:
+      liste_int_suppression_avant(l);
+      break;
+    case TRACE_SUPPRESSION_APRES:
+      liste_int_suppression_apres(l);
+      break;
+    case TRACE_AFFICHAGE:
+      liste_int_affichage(nul, l);
+      break;
+    case TRACE_COURANT_INIT:
+      liste_int_courant_init(l);
+      break;
+    case TRACE_COURANT_SUIVANT:
+      liste_int_courant_suivant(l);
+      break;
+    case TRACE_DECALAGE:
+      liste_int_decalage(l, a->argument);
+      break;
+    case TRACE_TAILLE:
+      controler(controle, liste_int_taille(l));
+      break;
+    case TRACE_VALEUR_TETE:
+      controler(controle, liste_int_valeur_tete(l));
+      break;
+    case TRACE_VALEUR_PIED:
+      controler(controle, liste_int_valeur_pied(l));
+      break;
+    case TRACE_VALEUR_COURANT:
+      controler(controle, liste_int_valeur_courant(l));
+      break;
+    case TRACE_EST_TETE:
+      controler(controle, liste_int_est_tete(l));
+      break;
+    case TRACE_EST_PIED:
+      controler(controle, liste_int_est_pied(l));
+      break;
+    case TRACE_REMPLACER_COURANT:
+      liste_int_remplacer_courant(l, t->valeurs + a->valeurs,
+                                  (unsigned int)a->argument,
+                                  (unsigned int)a->position);
+      break;
+    case TRACE_COMPACTER:
+      liste_int_compacter(l);
+      break;
+    case TRACE_COMPACTER_ETAPE:
+      liste_int_compacter_etape(l, (unsigned int)a->argument);
+      break;
+    default:
+      assert(false);
+    }
+  }
+  double ns = ns_depuis(&debut);
+  for (unsigned long i = 0; i <= t->nb_listes; i++) {
+    if (listes[i] != NULL) {
+      liste_int_detruire(&listes[i]);
+    }
+  }
+  liste_int_destructions_attendre();
+  free(listes);
+  return ns;
+}
+
+static void copier_int(void *val, void **pt) {
+  *pt = malloc(sizeof(int));
+  assert(*pt != NULL);
+  *(int *)*pt = *(int *)val;
+}
+
+static void afficher_int(FILE *f, void *val) { fprintf(f, "%d ", *(int *)val); }
+
+static void detruire_int(void **pt) {
+  free(*pt);
+  *pt = NULL;
+}
+
+static liste creer_generiques(void) {
+  return liste_creer(&copier_int, &afficher_int, &detruire_int);
+}
+
+/* La même boucle pour les deux cibles de listes_generiques. */
+static double rejouer_liste(trace const *t, liste (*creer)(void),
+                            unsigned long long *controle) {
+  liste *listes = calloc(t->nb_listes + 1, sizeof(liste));
+  void **vals = malloc(max_remplacements(t) * sizeof(void *));
+  assert(listes != NULL && vals != NULL);
+  struct timespec debut;
+  clock_gettime(CLOCK_MONOTONIC, &debut);
+  for (size_t i = 0; i < t->nb_appels; i++) {
+    trace_appel const *a = &t->appels[i];
+    liste l = listes[a->liste];
+    int v = a->argument;
+    if (l == NULL && a->operation != TRACE_CREER) {
+      continue;
+    }
+    switch (a->operation) {
+    case TRACE_CREER:
+      listes[a->liste] = creer();
+      break;
+    case TRACE_DETRUIRE:
+    case TRACE_ABANDON:
+      liste_detruire(&listes[a->liste]);
+      break;
+    case TRACE_DETRUIRE_DIFFERE:
+      liste_detruire_differe(&listes[a->liste]);
+      break;
+    case TRACE_EST_VIDE:
+      controler(controle, liste_est_vide(l));
+      break;
+    case TRACE_INSERTION_DEBUT:
+      liste_insertion_debut(l, &v);
+      break;
+    case TRACE_INSERTION_FIN:
+      liste_insertion_fin(l, &v);
+      break;
+    case TRACE_INSERTION_APRES:
+      liste_insertion_apres(l, &v);
+      break;
+    case TRACE_INSERTION_AVANT:
+      liste_insertion_avant(l, &v);
+      break;
+    case TRACE_SUPPRESSION_DEBUT:
+      liste_suppression_debut(l);
+      break;
+    case TRACE_SUPPRESSION_FIN:
+      liste_suppression_fin(l);
+      break;
+    case TRACE_SUPPRESSION_AVANT:
+      liste_suppression_avant(l);
+      break;
+    case TRACE_SUPPRESSION_APRES:
+      liste_suppression_apres(l);
+      break;
+    case TRACE_AFFICHAGE:
+      liste_affichage(nul, l);
+      break;
+    case TRACE_COURANT_INIT:
+      liste_courant_init(l);
+      break;
+    case TRACE_COURANT_SUIVANT:
+      liste_courant_suivant(l);
+      break;
+    case TRACE_DECALAGE:
+      liste_decalage(l, a->argument);
+      break;
+    case TRACE_TAILLE:
+      controler(controle, liste_taille(l));
+      break;
+    case TRACE_VALEUR_TETE:
+      controler(controle, *(int *)liste_valeur_tete(l));
+      break;
+    case TRACE_VALEUR_PIED:
+      controler(controle, *(int *)liste_valeur_pied(l));
+      break;
+    case TRACE_VALEUR_COURANT:
+      controler(controle, *(int *)liste_valeur_courant(l));
+      break;
+    case TRACE_EST_TETE:
+      controler(controle, liste_est_tete(l));
+      break;
+    case TRACE_EST_PIED:
+      controler(controle, liste_est_pied(l));
+      break;
+    case TRACE_REMPLACER_COURANT:
+      for (int k = 0; k < a->argument; k++) {
+        vals[k] = &t->valeurs[a->valeurs + (size_t)k];
+      }
+      liste_remplacer_courant(l, vals, (unsigned int)a->argument,
+                              (unsigned int)a->position);
+      break;
+    case TRACE_COMPACTER:
+      liste_compacter(l);
+      break;
+    case TRACE_COMPACTER_ETAPE:
+      liste_compacter_etape(l, (unsigned int)a->argument);
+      break;
+    default:
+      assert(false);
+    }
+  }
+  double ns = ns_depuis(&debut);
+  for (unsigned long i = 0; i <= t->nb_listes; i++) {
+    if (listes[i] != NULL) {
+      liste_detruire(&listes[i]);
+    }
+  }
+  liste_destructions_attendre();
+  free(vals);
+  free(listes);
+  return ns;
+}
+
+static double rejouer_generiques(trace const *t, unsigned long long *controle) {
+  return rejouer_liste(t, &creer_generiques, controle);
+}
+
+static double rejouer_pod(trace const *t, unsigned long long *controle) {
+  return rejouer_liste(t, &liste_creer_int, controle);
+}
+
+/* Une implémentation sur laquelle rejouer la trace. */
+typedef struct cible {
+  char const *nom;
+  double (*rejouer)(trace const *t, unsigned long long *controle);
+} cible;
+
+static cible const cibles[] = {{"int", &rejouer_int},
+                               {"generiques", &rejouer_generiques},
+                               {"pod", &rejouer_pod}};
+
+#define NB_CIBLES (sizeof(cibles) / sizeof(cibles[0]))
+
+static cible const *cible_chercher(char const *nom) {
+  for (size_t i = 0; i < NB_CIBLES; i++) {
+    if (strcmp(cibles[i].nom, nom) == 0) {
+      return &cibles[i];
+    }
+  }
+  return NULL;
+}
+
+/* Nombre d'appels de chaque opération. */
+static void afficher_detail(trace const *t) {
+  size_t nb[TRACE_NB_OPERATIONS] = {0};
+  for (size_t i = 0; i < t->nb_appels; i++) {
+    nb[t->appels[i].operation]++;
+  }
+  printf("operation,appels\n");
+  for (unsigned int op = 0; op < TRACE_NB_OPERATIONS; op++) {
+    if (nb[op] > 0) {
+      printf("%s,%zu\n", listes_trace_nom((trace_operation)op), nb[op]);
+    }
+  }
+}
+
+static void usage(char const *nom) {
+  fprintf(stderr,
+          "usage : %s TRACE [int|generiques|pod]... [--repetitions N]"
+          " [--detail]\n",
+          nom);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int repetitions = REPETITIONS;
+  bool detail = false;
+  cible const *choisies[NB_CIBLES * 4];
+  size_t nb_choisies = 0;
+  if (argc < 2) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+      repetitions = (unsigned int)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--detail") == 0) {
+      detail = true;
+    } else if (cible_chercher(argv[i]) != NULL &&
+               nb_choisies < NB_CIBLES * 4) {
+      choisies[nb_choisies++] = cible_chercher(argv[i]);
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (repetitions == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (nb_choisies == 0) {
+    for (size_t i = 0; i < NB_CIBLES; i++) {
+      choisies[nb_choisies++] = &cibles[i];
+    }
+  }
+  trace t;
+  if (!listes_trace_lire(argv[1], &t)) {
+    fprintf(stderr, "%s : trace illisible\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  nul = fopen("/dev/null", "w");
+  assert(nul != NULL);
+  if (detail) {
+    afficher_detail(&t);
+  }
+  printf("cible,appels,listes,controle,repetitions,mediane_ms,ns_par_appel\n");
+  double *ns = malloc(repetitions * sizeof(double));
+  assert(ns != NULL);
+  for (size_t c = 0; c < nb_choisies; c++) {
+    unsigned long long controle = 0;
+    for (unsigned int r = 0; r < repetitions; r++) {
+      controle = 0;
+      ns[r] = choisies[c]->rejouer(&t, &controle);
+    }
+    qsort(ns, repetitions, sizeof(double), &comparer_doubles);
+    double mediane = ns[repetitions / 2];
+    printf("%s,%zu,%lu,%016llx,%u,%.3f,%.2f\n", choisies[c]->nom, t.nb_appels,
+           t.nb_listes, controle, repetitions, mediane / 1e6,
+           t.nb_appels > 0 ? mediane / (double)t.nb_appels : 0.0);
+    fflush(stdout);
+  }
+  free(ns);
+  fclose(nul);
+  listes_trace_liberer(&t);
+  return 0;
+}
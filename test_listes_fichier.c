@@ -0,0 +1,129 @@
+#include "listes_int_fichier.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define FICHIER "test_listes_fichier.bin"
+
+void test1(FILE *f_out) {
+  fprintf(f_out, "-----------------test1------------------\n");
+  liste_fichier l = liste_fichier_creer(FICHIER);
+  for (int a = 1; a <= 5; a++) {
+    liste_fichier_insertion_fin(l, a);
+  }
+  liste_fichier_insertion_debut(l, 0);
+  liste_fichier_courant_init(l);
+  liste_fichier_decalage(l, 3);
+  liste_fichier_insertion_avant(l, 10);
+  liste_fichier_insertion_apres(l, 11);
+  liste_fichier_suppression_apres(l);
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "génération : %llu\n", liste_fichier_generation(l));
+  liste_fichier_fermer(&l);
+}
+
+void test2(FILE *f_out) {
+  fprintf(f_out, "-----------------test2------------------\n");
+  liste_fichier l = liste_fichier_ouvrir(FICHIER);
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "génération : %llu\n", liste_fichier_generation(l));
+  /* plusieurs agrandissements du fichier */
+  for (int a = 0; a < 5000; a++) {
+    liste_fichier_insertion_fin(l, a);
+  }
+  for (int a = 0; a < 4998; a++) {
+    liste_fichier_suppression_fin(l);
+  }
+  liste_fichier_courant_init(l);
+  liste_fichier_decalage(l, -1);
+  fprintf(f_out, "pied : %d %d\n", liste_fichier_est_pied(l),
+          liste_fichier_valeur_courant(l));
+  liste_fichier_suppression_avant(l);
+  liste_fichier_valider(l);
+  fprintf(f_out, "génération : %llu\n", liste_fichier_generation(l));
+  /* modification non validée : le fichier n'est plus cohérent sur le disque */
+  liste_fichier_suppression_debut(l);
+  fprintf(f_out, "ouverture non validée : %d\n",
+          liste_fichier_ouvrir(FICHIER) != NULL);
+  liste_fichier_fermer(&l);
+}
+
+void test3(FILE *f_out) {
+  fprintf(f_out, "-----------------test3------------------\n");
+  liste_fichier l = liste_fichier_ouvrir(FICHIER);
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "génération : %llu\n", liste_fichier_generation(l));
+  liste_fichier_courant_init(l);
+  while (!liste_fichier_est_pied(l)) {
+    liste_fichier_courant_suivant(l);
+  }
+  fprintf(f_out, "pied : %d\n", liste_fichier_valeur_pied(l));
+  while (!liste_fichier_est_vide(l)) {
+    liste_fichier_suppression_fin(l);
+  }
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  liste_fichier_fermer(&l);
+  fprintf(f_out, "ouverture absente : %d\n",
+          liste_fichier_ouvrir("absent.bin") != NULL);
+}
+
+void test4(FILE *f_out) {
+  fprintf(f_out, "-----------------test4------------------\n");
+  liste_fichier l = liste_fichier_creer(FICHIER);
+  for (int a = 1; a <= 6; a++) {
+    liste_fichier_insertion_fin(l, a);
+  }
+  liste_fichier_fermer(&l);
+  /* arrêt brutal d'un programme qui a modifié la liste sans la valider */
+  fflush(f_out);
+  pid_t pid = fork();
+  if (pid == 0) {
+    l = liste_fichier_ouvrir(FICHIER);
+    liste_fichier_insertion_debut(l, 0);
+    liste_fichier_suppression_fin(l);
+    liste_fichier_courant_init(l);
+    liste_fichier_decalage(l, 2);
+    liste_fichier_insertion_apres(l, 20);
+    _exit(0);
+  }
+  waitpid(pid, NULL, 0);
+  fprintf(f_out, "ouverture : %d\n", liste_fichier_ouvrir(FICHIER) != NULL);
+  /* lien precedent du troisième maillon écrasé : il est reconstruit */
+  FILE *f = fopen(FICHIER, "r+b");
+  fseek(f, 64 + 3 * 12, SEEK_SET);
+  fputc(99, f);
+  fclose(f);
+  l = liste_fichier_recuperer(FICHIER);
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "génération : %llu\n", liste_fichier_generation(l));
+  liste_fichier_courant_init(l);
+  liste_fichier_decalage(l, -1);
+  fprintf(f_out, "pied : %d %d\n", liste_fichier_est_pied(l),
+          liste_fichier_valeur_courant(l));
+  liste_fichier_decalage(l, -6);
+  fprintf(f_out, "tete : %d\n", liste_fichier_est_tete(l));
+  /* le maillon libéré par la suppression est réutilisé */
+  liste_fichier_insertion_fin(l, 7);
+  liste_fichier_fermer(&l);
+  l = liste_fichier_ouvrir(FICHIER);
+  liste_fichier_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  liste_fichier_fermer(&l);
+}
+
+int main(void) {
+  FILE *f_out = fopen("test_listes_fichier_out.txt", "w");
+  test1(f_out);
+  test2(f_out);
+  test3(f_out);
+  test4(f_out);
+  fclose(f_out);
+  remove(FICHIER);
+  return 0;
+}
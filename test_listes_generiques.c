@@ -1,5 +1,6 @@
 #include "listes_generiques.h"
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -136,6 +137,494 @@ void test5(FILE *f_out) {
   fclose(f_in);
 }
 
+void test6(FILE *f_out) {
+  fprintf(f_out, "-----------------test6------------------\n");
+  liste l = liste_creer(&copie_int, &afficher_int, &detruire_int);
+  liste_recyclage(l, 3, sizeof(int));
+  int a;
+  for (a = 0; a < 6; a++) {
+    liste_insertion_fin(l, &a);
+  }
+  liste_courant_init(l);
+  liste_courant_suivant(l);
+  for (a = 10; a < 14; a++) {
+    liste_suppression_apres(l);
+    liste_insertion_avant(l, &a);
+    fprintf(f_out, "recycles : %u\n", liste_nb_recycles(l));
+  }
+  fprintf(f_out, "allocations : %llu\n", liste_nb_allocations(l));
+  liste_suppression_debut(l);
+  liste_suppression_fin(l);
+  liste_suppression_fin(l);
+  liste_suppression_fin(l);
+  fprintf(f_out, "recycles : %u\n", liste_nb_recycles(l));
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  liste_recyclage(l, 1, 0);
+  fprintf(f_out, "recycles : %u\n", liste_nb_recycles(l));
+  liste_detruire(&l);
+}
+
+void test7(FILE *f_out) {
+  fprintf(f_out, "-----------------test7------------------\n");
+  liste l = liste_creer(&copie_int, &afficher_int, &detruire_int);
+  int a;
+  for (a = 1; a <= 7; a++) {
+    liste_insertion_fin(l, &a);
+  }
+  liste milieu = liste_scinder(l, 2);
+  liste fin = liste_scinder(milieu, 4);
+  liste vide = liste_scinder(fin, 1);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  liste_affichage(f_out, milieu);
+  fprintf(f_out, "\n");
+  liste_affichage(f_out, fin);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "vide : %d\n", liste_est_vide(vide));
+  a = 0;
+  liste_insertion_debut(vide, &a);
+  liste_concatener(vide, &l);
+  liste_concatener(vide, &milieu);
+  liste_concatener(vide, &fin);
+  liste_affichage(f_out, vide);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "tete : %d, pied : %d\n", *(int *)liste_valeur_tete(vide),
+          *(int *)liste_valeur_pied(vide));
+  liste_detruire(&vide);
+}
+
+void test8(FILE *f_out) {
+  fprintf(f_out, "-----------------test8------------------\n");
+  liste l = liste_creer(&copie_int, &afficher_int, &detruire_int);
+  fprintf(f_out, "vide valide : %d\n", liste_est_valide(l));
+  int a;
+  for (a = 1; a <= 5; a++) {
+    liste_insertion_fin(l, &a);
+  }
+  liste_courant_init(l);
+  liste_suppression_avant(l);
+  liste_courant_suivant(l);
+  liste_suppression_apres(l);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "valide : %d\n", liste_est_valide(l));
+  liste_suppression_debut(l);
+  liste_suppression_fin(l);
+  liste_suppression_fin(l);
+  fprintf(f_out, "vidée valide : %d\n", liste_est_valide(l));
+  liste_detruire(&l);
+}
+
+void test9(FILE *f_out) {
+  fprintf(f_out, "-----------------test9------------------\n");
+  liste l = liste_creer_int();
+  liste_recyclage(l, 2, sizeof(int));
+  int a;
+  for (a = 1; a <= 6; a++) {
+    liste_insertion_fin(l, &a);
+  }
+  liste_courant_init(l);
+  liste_courant_suivant(l);
+  a = 20;
+  liste_insertion_avant(l, &a);
+  liste_suppression_apres(l);
+  liste_suppression_fin(l);
+  liste_suppression_fin(l);
+  a = 30;
+  liste_insertion_debut(l, &a);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "allocations : %llu, recycles : %u\n",
+          liste_nb_allocations(l), liste_nb_recycles(l));
+  liste fin = liste_scinder(l, 3);
+  liste_concatener(fin, &l);
+  liste_affichage(f_out, fin);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "tete : %d, valide : %d\n",
+          *(int *)liste_valeur_tete(fin), liste_est_valide(fin));
+  liste_detruire(&fin);
+}
+
+void test10(FILE *f_out) {
+  fprintf(f_out, "-----------------test10-----------------\n");
+  liste l = liste_creer(&copie_int, &afficher_int, &detruire_int);
+  liste n = liste_creer_int();
+  int a;
+  for (a = 1; a <= 7; a++) {
+    liste_insertion_fin(l, &a);
+    liste_insertion_debut(n, &a);
+  }
+  liste_courant_init(l);
+  liste_decalage(l, 3);
+  int etapes = 1;
+  while (!liste_compacter_etape(l, 2)) {
+    etapes++;
+    liste_suppression_apres(l);
+  }
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "étapes : %d, courant : %d, valide : %d\n", etapes,
+          *(int *)liste_valeur_courant(l), liste_est_valide(l));
+  liste_compacter(n);
+  liste fin = liste_scinder(n, 4);
+  liste_suppression_debut(fin);
+  liste_compacter(fin);
+  liste_suppression_fin(n);
+  liste_concatener(n, &fin);
+  liste_suppression_debut(l);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  liste_affichage(f_out, n);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "valides : %d %d\n", liste_est_valide(l), liste_est_valide(n));
+  liste_detruire(&l);
+  liste_detruire(&n);
+}
+
+void test11(FILE *f_out) {
+  fprintf(f_out, "-----------------test11-----------------\n");
+  liste l = liste_creer(&copie_int, &afficher_int, &detruire_int);
+  int v[4] = {10, 11, 12, 13};
+  void *vals[4] = {&v[0], &v[1], &v[2], &v[3]};
+  int a = 1;
+  liste_insertion_fin(l, &a);
+  liste_courant_init(l);
+  liste_remplacer_courant(l, vals, 2, 1);
+  fprintf(f_out, "pied : %d\n", liste_est_pied(l));
+  a = 2;
+  liste_insertion_fin(l, &a);
+  liste_suppression_fin(l);
+  liste_courant_init(l);
+  liste_remplacer_courant(l, vals + 1, 3, 0);
+  liste_courant_suivant(l);
+  liste_courant_suivant(l);
+  liste_courant_suivant(l);
+  liste_remplacer_courant(l, vals, 4, 3);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "courant : %d, pied : %d, valide : %d\n",
+          *(int *)liste_valeur_courant(l), liste_est_pied(l),
+          liste_est_valide(l));
+  liste_detruire(&l);
+}
+
+/*!
+ * \brief Lecteur de test12 : chaque parcours doit voir des valeurs croissantes.
+ */
+static void *lire_croissant(void *arg) {
+  lecteur r = liste_lecteur_creer((liste)arg);
+  long incoherences = 0;
+  for (int i = 0; i < 200; i++) {
+    liste_lecture_debut(r);
+    int precedente = -1;
+    for (int *v = liste_lecture_premier(r); v != NULL;
+         v = liste_lecture_suivant(r)) {
+      incoherences += *v <= precedente;
+      precedente = *v;
+    }
+    liste_lecture_fin(r);
+  }
+  liste_lecteur_detruire(&r);
+  return (void *)incoherences;
+}
+
+void test12(FILE *f_out) {
+  fprintf(f_out, "-----------------test12-----------------\n");
+  liste l = liste_creer_int();
+  liste_concurrente(l, true);
+  lecteur r = liste_lecteur_creer(l);
+  int a;
+  for (a = 0; a < 5; a++) {
+    liste_insertion_fin(l, &a);
+  }
+  liste_lecture_debut(r);
+  int *v = liste_lecture_premier(r);
+  fprintf(f_out, "premier : %d\n", *v);
+  liste_lecture_suivant(r);
+  /* l'élément lu reste valide pendant la lecture */
+  liste_suppression_debut(l);
+  liste_suppression_debut(l);
+  fprintf(f_out, "recycles pendant la lecture : %u\n", liste_nb_recycles(l));
+  fprintf(f_out, "lu :");
+  for (; v != NULL; v = liste_lecture_suivant(r)) {
+    fprintf(f_out, " %d", *v);
+  }
+  fprintf(f_out, "\n");
+  liste_lecture_fin(r);
+  liste_lecteur_detruire(&r);
+  liste_concurrente(l, false);
+  fprintf(f_out, "recycles après : %u, valide : %d\n", liste_nb_recycles(l),
+          liste_est_valide(l));
+  liste_concurrente(l, true);
+  pthread_t threads[3];
+  for (int i = 0; i < 3; i++) {
+    pthread_create(&threads[i], NULL, &lire_croissant, l);
+  }
+  for (a = 5; a < 200000; a++) {
+    liste_insertion_fin(l, &a);
+    if (a % 3 != 0) {
+      liste_suppression_debut(l);
+    }
+  }
+  long incoherences = 0;
+  for (int i = 0; i < 3; i++) {
+    void *resultat;
+    pthread_join(threads[i], &resultat);
+    incoherences += (long)resultat;
+  }
+  liste_synchroniser(l);
+  liste_concurrente(l, false);
+  fprintf(f_out, "incohérences : %ld, valide : %d\n", incoherences,
+          liste_est_valide(l));
+  liste_detruire(&l);
+}
+
+/*! \brief Enregistrement de test13 : la clé de tri et le rang d'insertion. */
+typedef struct fiche {
+  int cle;
+  int rang;
+} fiche;
+
+static int copies_fiche = 0;
+
+void copie_fiche(void *val, void **pt) {
+  *pt = malloc(sizeof(fiche));
+  memcpy(*pt, val, sizeof(fiche));
+  copies_fiche++;
+}
+
+void afficher_fiche(FILE *f, void *val) {
+  fprintf(f, "%d/%d ", ((fiche *)val)->cle, ((fiche *)val)->rang);
+}
+
+void detruire_fiche(void **pt) {
+  free(*pt);
+  *pt = NULL;
+  copies_fiche--;
+}
+
+int comparer_cles(void const *a, void const *b) {
+  return (((fiche const *)a)->cle > ((fiche const *)b)->cle) -
+         (((fiche const *)a)->cle < ((fiche const *)b)->cle);
+}
+
+int comparer_int(void const *a, void const *b) {
+  return (*(int const *)a > *(int const *)b) -
+         (*(int const *)a < *(int const *)b);
+}
+
+/*!
+ * \brief Vérifie que la liste de fiches est triée par clé et, à clé égale,
+ * par rang d'insertion.
+ */
+static bool fiches_triees(liste l) {
+  liste_courant_init(l);
+  for (unsigned int i = 1; i < liste_taille(l); i++) {
+    fiche *a = liste_valeur_courant(l);
+    liste_courant_suivant(l);
+    fiche *b = liste_valeur_courant(l);
+    if (a->cle > b->cle || (a->cle == b->cle && a->rang > b->rang)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void test13(FILE *f_out) {
+  fprintf(f_out, "-----------------test13-----------------\n");
+  liste l = liste_creer(&copie_fiche, &afficher_fiche, &detruire_fiche);
+  /* une suite croissante, une décroissante et des égaux */
+  int cles[12] = {1, 3, 5, 7, 9, 4, 4, 2, 0, 8, 3, 6};
+  for (int i = 0; i < 12; i++) {
+    fiche f = {cles[i], i};
+    liste_insertion_fin(l, &f);
+  }
+  liste_courant_init(l);
+  liste_decalage(l, 5);
+  int copies = copies_fiche;
+  liste_trier(l, &comparer_cles);
+  liste_affichage(f_out, l);
+  fprintf(f_out, "\n");
+  fprintf(f_out, "courant : %d, copies : %d, valide : %d\n",
+          ((fiche *)liste_valeur_courant(l))->rang, copies_fiche - copies,
+          liste_est_valide(l));
+  /* grande liste, triée en parallèle sur 4 threads */
+  unsigned long long x = 88172645463325252ULL;
+  for (int i = 12; i < 200000; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    fiche f = {(int)(x % 1000), i};
+    liste_insertion_fin(l, &f);
+  }
+  liste_trier_parallele(l, &comparer_cles, 4);
+  fprintf(f_out, "triée et stable : %d, valide : %d\n", fiches_triees(l),
+          liste_est_valide(l));
+  liste_detruire(&l);
+  liste n = liste_creer_int();
+  for (int a = 0; a < 100000; a++) {
+    int v = 100000 - a;
+    liste_insertion_fin(n, &v);
+  }
+  liste_trier_parallele(n, &comparer_int, 3);
+  fprintf(f_out, "tete : %d, pied : %d, valide : %d\n",
+          *(int *)liste_valeur_tete(n), *(int *)liste_valeur_pied(n),
+          liste_est_valide(n));
+  liste_detruire(&n);
+}
+
+void test14(FILE *f_out) {
+  fprintf(f_out, "-----------------test14-----------------\n");
+  int copies = copies_fiche;
+  liste l = liste_creer(&copie_fiche, &afficher_fiche, &detruire_fiche);
+  for (int i = 0; i < 100000; i++) {
+    fiche f = {i % 7, i};
+    liste_insertion_fin(l, &f);
+  }
+  /* des maillons recyclés, puis compactés dans un bloc */
+  for (int i = 0; i < 10; i++) {
+    liste_suppression_debut(l);
+  }
+  liste_compacter(l);
+  liste n = liste_creer_int();
+  for (int a = 0; a < 50000; a++) {
+    liste_insertion_debut(n, &a);
+  }
+  liste v = liste_creer_int();
+  /* le débit limité laisse les listes en attente jusqu'à l'appel d'attente */
+  liste_destruction_debit(1000000);
+  liste_detruire_differe(&l);
+  liste_detruire_differe(&n);
+  liste_detruire_differe(&v);
+  fprintf(f_out, "détachées : %d\n", l == NULL && n == NULL && v == NULL);
+  liste_destructions_attendre();
+  liste_destruction_debit(20000000);
+  fprintf(f_out, "valeurs restantes : %d\n", copies_fiche - copies);
+}
+
+/* Tirage pseudo-aléatoire reproductible pour test15. */
+static unsigned int tirer(unsigned int *etat, unsigned int n) {
+  *etat = *etat * 1103515245u + 12345u;
+  return (*etat >> 16) % n;
+}
+
+/* Vrai si les deux listes ont les mêmes valeurs ; leurs courants sont
+ * réinitialisés. */
+static bool memes_valeurs(liste a, liste b) {
+  if (liste_taille(a) != liste_taille(b)) {
+    return false;
+  }
+  liste_courant_init(a);
+  liste_courant_init(b);
+  for (unsigned int i = 0; i < liste_taille(a); i++) {
+    if (*(int *)liste_valeur_courant(a) != *(int *)liste_valeur_courant(b)) {
+      return false;
+    }
+    liste_courant_suivant(a);
+    liste_courant_suivant(b);
+  }
+  return true;
+}
+
+void test15(FILE *f_out) {
+  fprintf(f_out, "-----------------test15-----------------\n");
+  /* segments de 8 entiers, dont 6 au plus en mémoire */
+  liste e = liste_creer_externe(sizeof(int), &afficher_int, ".", 256);
+  liste n = liste_creer_int();
+  for (int i = 0; i < 20; i++) {
+    liste_insertion_fin(e, &i);
+  }
+  liste_affichage(f_out, e);
+  fprintf(f_out, "\n");
+  for (int i = 0; i < 20; i++) {
+    liste_suppression_debut(e);
+  }
+  fprintf(f_out, "vide : %d\n", liste_est_vide(e));
+  /* mêmes opérations sur les deux listes, comparées à chaque pas */
+  unsigned int etat = 1;
+  bool identiques = true;
+  for (int i = 0; i < 20000 && identiques; i++) {
+    int v = (int)tirer(&etat, 1000);
+    bool courant = liste_taille(n) > 0;
+    unsigned int op = tirer(&etat, courant ? 12 : 2);
+    if (op == 0) {
+      liste_insertion_debut(e, &v);
+      liste_insertion_debut(n, &v);
+    } else if (op == 1) {
+      liste_insertion_fin(e, &v);
+      liste_insertion_fin(n, &v);
+    } else if (op == 2) {
+      liste_insertion_avant(e, &v);
+      liste_insertion_avant(n, &v);
+    } else if (op == 3) {
+      liste_insertion_apres(e, &v);
+      liste_insertion_apres(n, &v);
+    } else if (op == 4 || op == 5) {
+      /* un courant supprimé est replacé sur la tête */
+      bool perdu = op == 4 ? liste_est_tete(n) : liste_est_pied(n);
+      if (op == 4) {
+        liste_suppression_debut(e);
+        liste_suppression_debut(n);
+      } else {
+        liste_suppression_fin(e);
+        liste_suppression_fin(n);
+      }
+      if (perdu) {
+        liste_courant_init(e);
+        liste_courant_init(n);
+      }
+    } else if (op == 6) {
+      liste_suppression_avant(e);
+      liste_suppression_avant(n);
+    } else if (op == 7) {
+      liste_suppression_apres(e);
+      liste_suppression_apres(n);
+    } else if (op == 8) {
+      liste_courant_suivant(e);
+      liste_courant_suivant(n);
+    } else if (op == 9) {
+      liste_decalage(e, v);
+      liste_decalage(n, v);
+    } else if (op == 10) {
+      int filles[3] = {v, v + 1, v + 2};
+      void *vals[3] = {&filles[0], &filles[1], &filles[2]};
+      unsigned int k = 1 + tirer(&etat, 3);
+      unsigned int position = tirer(&etat, k);
+      liste_remplacer_courant(e, vals, k, position);
+      liste_remplacer_courant(n, vals, k, position);
+    } else {
+      /* modification en place */
+      (*(int *)liste_valeur_courant(e))++;
+      (*(int *)liste_valeur_courant(n))++;
+    }
+    if (!courant) {
+      liste_courant_init(e);
+      liste_courant_init(n);
+    }
+    if (!liste_est_vide(n)) {
+      identiques = liste_taille(e) == liste_taille(n) &&
+                   *(int *)liste_valeur_courant(e) ==
+                       *(int *)liste_valeur_courant(n) &&
+                   liste_est_tete(e) == liste_est_tete(n) &&
+                   liste_est_pied(e) == liste_est_pied(n) &&
+                   *(int *)liste_valeur_tete(e) ==
+                       *(int *)liste_valeur_tete(n) &&
+                   *(int *)liste_valeur_pied(e) ==
+                       *(int *)liste_valeur_pied(n);
+    }
+  }
+  fprintf(f_out, "identiques : %d\n", identiques && memes_valeurs(e, n));
+  fprintf(f_out, "valide : %d\n", liste_est_valide(e));
+  /* plus de segments chargés que ne le permet le budget */
+  fprintf(f_out, "débordement : %d\n",
+          liste_nb_allocations(e) > liste_taille(e) / 8);
+  liste_externe_budget(e, 1 << 20);
+  fprintf(f_out, "identiques : %d\n", memes_valeurs(e, n));
+  liste_detruire(&e);
+  liste_detruire(&n);
+}
+
 int main(void) {
   FILE *f_out = fopen("test_out.txt", "w");
 
@@ -144,6 +633,16 @@ int main(void) {
   test3(f_out);
   test4(f_out);
   test5(f_out);
+  test6(f_out);
+  test7(f_out);
+  test8(f_out);
+  test9(f_out);
+  test10(f_out);
+  test11(f_out);
+  test12(f_out);
+  test13(f_out);
+  test14(f_out);
+  test15(f_out);
 
   fclose(f_out);
   return 0;
@@ -3,40 +3,41 @@
 #include <string.h>
 #include <assert.h>
 #include "listes_int.h"
+#include "listes_trace.h"
 
 void test1(FILE* f_out)
 {
   fprintf(f_out,"-----------------test1------------------\n");
-  liste l = liste_creer();
-  liste_insertion_debut(l,1);
-  liste_affichage(f_out,l);
+  liste_int l = liste_int_creer();
+  liste_int_insertion_debut(l,1);
+  liste_int_affichage(f_out,l);
   fprintf(f_out,"\n");
-  liste_detruire(&l);
+  liste_int_detruire(&l);
 }
 
 void test2(FILE* f_out)
 {
   fprintf(f_out,"-----------------test2------------------\n");
-  liste l = liste_creer();
-  liste_insertion_fin(l,3);
-  liste_affichage(f_out,l);
+  liste_int l = liste_int_creer();
+  liste_int_insertion_fin(l,3);
+  liste_int_affichage(f_out,l);
   fprintf(f_out,"\n");
-  liste_detruire(&l);
+  liste_int_detruire(&l);
 }
 
 void test3(FILE* f_out)
 {
   fprintf(f_out,"-----------------test3------------------\n");
-  liste l = liste_creer();
-  liste_insertion_debut(l,1);
-  liste_insertion_debut(l,2);
-  liste_insertion_fin(l,3);
-  liste_insertion_fin(l,4);    
-  liste_courant_init(l);
-  liste_insertion_apres(l,10);
-  liste_affichage(f_out,l);
-  fprintf(f_out,"\n");
-  liste_detruire(&l);
+  liste_int l = liste_int_creer();
+  liste_int_insertion_debut(l,1);
+  liste_int_insertion_debut(l,2);
+  liste_int_insertion_fin(l,3);
+  liste_int_insertion_fin(l,4);    
+  liste_int_courant_init(l);
+  liste_int_insertion_apres(l,10);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  liste_int_detruire(&l);
 }
 
 void test4(FILE* f_out)
@@ -45,55 +46,55 @@ void test4(FILE* f_out)
   
   FILE* f_in = fopen("test_listes_int_in.txt","r");  
   
-  liste l = liste_creer();
+  liste_int l = liste_int_creer();
   int a;
   fscanf(f_in,"%d",&a);
-  liste_insertion_debut(l,a);
+  liste_int_insertion_debut(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_fin(l,a);
+  liste_int_insertion_fin(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_fin(l,a);
+  liste_int_insertion_fin(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_fin(l,a);
+  liste_int_insertion_fin(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_fin(l,a);
+  liste_int_insertion_fin(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_debut(l,a);
+  liste_int_insertion_debut(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_debut(l,a);
+  liste_int_insertion_debut(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_debut(l,a);
-  liste_suppression_debut(l);
-  liste_suppression_debut(l);
-  liste_suppression_fin(l);
+  liste_int_insertion_debut(l,a);
+  liste_int_suppression_debut(l);
+  liste_int_suppression_debut(l);
+  liste_int_suppression_fin(l);
   fscanf(f_in,"%d",&a);
-  liste_courant_init(l);
-  liste_courant_suivant(l);
-  liste_insertion_avant(l,a);
+  liste_int_courant_init(l);
+  liste_int_courant_suivant(l);
+  liste_int_insertion_avant(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_avant(l,a);
+  liste_int_insertion_avant(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_apres(l,a);
+  liste_int_insertion_apres(l,a);
   fscanf(f_in,"%d",&a);
-  liste_insertion_apres(l,a);
-  liste_courant_suivant(l);
-  liste_suppression_avant(l);
-  liste_suppression_apres(l);
-  liste_suppression_avant(l);
-  liste_suppression_apres(l);
-  liste_affichage(f_out,l);
-  fprintf(f_out,"\n");
-  liste_courant_init(l);
-  while(!liste_est_pied(l)) {
-    if (liste_est_tete(l))
-      fprintf(f_out,"tete : %d\n",liste_valeur_courant(l));
+  liste_int_insertion_apres(l,a);
+  liste_int_courant_suivant(l);
+  liste_int_suppression_avant(l);
+  liste_int_suppression_apres(l);
+  liste_int_suppression_avant(l);
+  liste_int_suppression_apres(l);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  liste_int_courant_init(l);
+  while(!liste_int_est_pied(l)) {
+    if (liste_int_est_tete(l))
+      fprintf(f_out,"tete : %d\n",liste_int_valeur_courant(l));
     else
-      fprintf(f_out,"courant : %d\n",liste_valeur_courant(l));
-    liste_courant_suivant(l);
+      fprintf(f_out,"courant : %d\n",liste_int_valeur_courant(l));
+    liste_int_courant_suivant(l);
   }
-  fprintf(f_out,"pied : %d\n",liste_valeur_pied(l));
+  fprintf(f_out,"pied : %d\n",liste_int_valeur_pied(l));
   fclose(f_in);
-  liste_detruire(&l);
+  liste_int_detruire(&l);
 }
 
 void test5(FILE* f_out)
@@ -102,25 +103,281 @@ void test5(FILE* f_out)
   
   FILE* f_in = fopen("test_listes_int_in.txt","r");  
   
-  liste l = liste_creer();
+  liste_int l = liste_int_creer();
 
   int a;
   fscanf(f_in,"%d",&a);  
-  liste_insertion_debut(l,a);
+  liste_int_insertion_debut(l,a);
   fscanf(f_in,"%d",&a);
-  liste_courant_init(l);
+  liste_int_courant_init(l);
   do {
-    liste_insertion_avant(l,a);
+    liste_int_insertion_avant(l,a);
     fscanf(f_in,"%d",&a);
   }  while (!feof(f_in)) ;
   
-  liste_affichage(f_out,l);
+  liste_int_affichage(f_out,l);
   fprintf(f_out,"\n");
-  liste_detruire(&l);
+  liste_int_detruire(&l);
   fclose(f_in);
   
 }
 
+void test6(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test6------------------\n");
+  liste_int l = liste_int_creer();
+  for (int a = 1; a <= 7; a++) {
+    if (a != 4) {
+      liste_int_insertion_fin(l,a);
+    }
+  }
+  /* l'insertion au milieu fait passer la liste en maillons chaînés */
+  liste_int_courant_init(l);
+  liste_int_decalage(l,2);
+  liste_int_insertion_apres(l,4);
+  liste_int_courant_suivant(l);
+  int etapes = 1;
+  while (!liste_int_compacter_etape(l,2)) {
+    etapes++;
+    liste_int_suppression_apres(l);
+  }
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  fprintf(f_out,"étapes : %d, courant : %d\n",etapes,liste_int_valeur_courant(l));
+  liste_int_insertion_debut(l,0);
+  liste_int_compacter(l);
+  liste_int_suppression_debut(l);
+  liste_int_suppression_fin(l);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  liste_int_detruire(&l);
+}
+
+void test7(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test7------------------\n");
+  liste_int l = liste_int_creer();
+  int vals[4] = {10, 11, 12, 13};
+  liste_int_insertion_fin(l,1);
+  liste_int_insertion_fin(l,2);
+  liste_int_courant_init(l);
+  liste_int_remplacer_courant(l,vals,2,1);
+  liste_int_courant_suivant(l);
+  liste_int_remplacer_courant(l,vals,4,3);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  fprintf(f_out,"courant : %d, pied : %d, tete : %d\n",
+          liste_int_valeur_courant(l),liste_int_est_pied(l),
+          liste_int_valeur_tete(l));
+  liste_int_suppression_debut(l);
+  liste_int_suppression_fin(l);
+  liste_int_detruire(&l);
+}
+
+void test8(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test8------------------\n");
+  liste_int l = liste_int_creer();
+  /* file : l'anneau fait plusieurs tours et double deux fois */
+  for (int a = 0; a < 40; a++) {
+    liste_int_insertion_fin(l,a);
+    if (a % 3 != 0) {
+      liste_int_suppression_debut(l);
+    }
+  }
+  for (int a = 1; a <= 20; a++) {
+    liste_int_insertion_debut(l,-a);
+  }
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  liste_int_courant_init(l);
+  liste_int_insertion_avant(l,-100);
+  liste_int_decalage(l,liste_int_taille(l)-2);
+  liste_int_insertion_apres(l,100);
+  liste_int_suppression_apres(l);
+  liste_int_courant_suivant(l);
+  liste_int_suppression_avant(l);
+  fprintf(f_out,"courant : %d, tete : %d, pied : %d\n",
+          liste_int_valeur_courant(l),liste_int_est_tete(l),
+          liste_int_valeur_pied(l));
+  /* suppression au milieu : passage en maillons chaînés */
+  liste_int_decalage(l,5);
+  liste_int_suppression_apres(l);
+  liste_int_courant_suivant(l);
+  fprintf(f_out,"courant : %d, tete : %d, pied : %d\n",
+          liste_int_valeur_courant(l),liste_int_valeur_tete(l),
+          liste_int_valeur_pied(l));
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  liste_int_detruire(&l);
+}
+
+/* ensemble des multiples de pas dans [0, n[, chaîné si demandé */
+liste_int multiples(int pas, int n, bool chainee)
+{
+  liste_int l = liste_int_creer();
+  for (int a = 0; a < n; a += pas) {
+    liste_int_insertion_fin(l,a);
+  }
+  if (chainee && !liste_int_est_vide(l)) {
+    /* une insertion au milieu chaîne les maillons */
+    liste_int_courant_init(l);
+    liste_int_insertion_apres(l,-1);
+    liste_int_suppression_apres(l);
+  }
+  return l;
+}
+
+void test9(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test9------------------\n");
+  liste_int a = multiples(2,30,false);
+  liste_int b = multiples(3,30,true);
+  liste_int u = liste_int_union(a,b);
+  liste_int i = liste_int_intersection(a,b);
+  liste_int d = liste_int_difference(a,b);
+  liste_int_affichage(f_out,u);
+  fprintf(f_out,"\n");
+  liste_int_affichage(f_out,i);
+  fprintf(f_out,"\n");
+  liste_int_affichage(f_out,d);
+  fprintf(f_out,"\n");
+  /* tailles très différentes : recherche exponentielle */
+  liste_int grand = multiples(1,1000,false);
+  liste_int petit = liste_int_creer();
+  liste_int_insertion_fin(petit,-5);
+  liste_int_insertion_fin(petit,7);
+  liste_int_insertion_fin(petit,999);
+  liste_int_insertion_fin(petit,2000);
+  liste_int v = liste_int_intersection(grand,petit);
+  liste_int w = liste_int_union(petit,grand);
+  liste_int x = liste_int_difference(grand,petit);
+  liste_int_affichage(f_out,v);
+  fprintf(f_out,"\n");
+  fprintf(f_out,"union : %d, tete : %d, pied : %d\n",liste_int_taille(w),
+          liste_int_valeur_tete(w),liste_int_valeur_pied(w));
+  fprintf(f_out,"différence : %d\n",liste_int_taille(x));
+  /* en place, sur des maillons chaînés puis sur un anneau */
+  liste_int_intersecter(b,a);
+  liste_int_affichage(f_out,b);
+  fprintf(f_out,"\n");
+  liste_int_retrancher(a,i);
+  liste_int_affichage(f_out,a);
+  fprintf(f_out,"\n");
+  liste_int c = multiples(5,30,true);
+  liste_int_unir(c,&b);
+  liste_int_unir(c,&petit);
+  liste_int_affichage(f_out,c);
+  fprintf(f_out,"\n");
+  liste_int_unir(a,&c);
+  liste_int_affichage(f_out,a);
+  fprintf(f_out,"\n");
+  fprintf(f_out,"détruites : %d\n",b == NULL && c == NULL && petit == NULL);
+  liste_int_detruire(&a);
+  liste_int_detruire(&u);
+  liste_int_detruire(&i);
+  liste_int_detruire(&d);
+  liste_int_detruire(&grand);
+  liste_int_detruire(&v);
+  liste_int_detruire(&w);
+  liste_int_detruire(&x);
+}
+
+void test10(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test10-----------------\n");
+  liste_int a = multiples(1,100000,true);
+  liste_int_compacter(a);
+  liste_int b = multiples(1,100000,false);
+  liste_int c = liste_int_creer();
+  liste_int_detruire_differe(&a);
+  liste_int_detruire_differe(&b);
+  liste_int_detruire_differe(&c);
+  fprintf(f_out,"détachées : %d\n",a == NULL && b == NULL && c == NULL);
+  liste_int_destructions_attendre();
+  /* sans limite de débit */
+  liste_int_destruction_debit(0);
+  a = multiples(3,100000,true);
+  liste_int_detruire_differe(&a);
+  liste_int_destructions_attendre();
+  liste_int_destruction_debit(20000000);
+  fprintf(f_out,"détruite : %d\n",a == NULL);
+}
+
+void test11(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test11-----------------\n");
+  liste_int avant = multiples(2,3,false);
+  fprintf(f_out,"démarrée : %d\n",
+          listes_trace_demarrer("test_listes_int_out.trace"));
+  liste_int a = liste_int_creer();
+  liste_int b = liste_int_creer();
+  liste_int_insertion_fin(a,-3);
+  liste_int_insertion_debut(a,7);
+  liste_int_insertion_fin(avant,8);
+  liste_int_courant_init(a);
+  liste_int_decalage(a,1);
+  int const vals[] = {1,-2};
+  liste_int_remplacer_courant(a,vals,2,0);
+  liste_int_valeur_courant(a);
+  liste_int_taille(a);
+  liste_int_insertion_fin(b,5);
+  liste_int_unir(a,&b);
+  liste_int_insertion_fin(a,9);
+  liste_int_detruire(&a);
+  fprintf(f_out,"arrêtée : %d\n",listes_trace_arreter());
+  trace t;
+  fprintf(f_out,"relue : %d\n",listes_trace_lire("test_listes_int_out.trace",&t));
+  for (size_t i = 0; i < t.nb_appels; i++) {
+    trace_appel const* c = &t.appels[i];
+    fprintf(f_out,"%lu %s %d",c->liste,listes_trace_nom(c->operation),
+            c->argument);
+    if (c->operation == TRACE_REMPLACER_COURANT) {
+      fprintf(f_out," %d :",c->position);
+      for (int k = 0; k < c->argument; k++) {
+        fprintf(f_out," %d",t.valeurs[c->valeurs + (size_t)k]);
+      }
+    }
+    fprintf(f_out,"\n");
+  }
+  listes_trace_liberer(&t);
+  remove("test_listes_int_out.trace");
+  liste_int_detruire(&avant);
+}
+
+void test12(FILE* f_out)
+{
+  fprintf(f_out,"-----------------test12-----------------\n");
+  /* suppressions de la tete et du pied sur des maillons chaînés */
+  liste_int l = multiples(1,5,false);
+  liste_int_courant_init(l);
+  liste_int_decalage(l,2);
+  liste_int_insertion_apres(l,10);
+  liste_int_courant_init(l);
+  liste_int_courant_suivant(l);
+  liste_int_suppression_avant(l);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\ntete : %d, pied : %d\n",liste_int_valeur_tete(l),
+          liste_int_valeur_pied(l));
+  liste_int_decalage(l,3);
+  liste_int_suppression_apres(l);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\ntete : %d, pied : %d\n",liste_int_valeur_tete(l),
+          liste_int_valeur_pied(l));
+  liste_int_insertion_debut(l,0);
+  liste_int_insertion_fin(l,6);
+  liste_int_affichage(f_out,l);
+  fprintf(f_out,"\n");
+  /* la suppression du dernier élément, courant, oublie le courant */
+  liste_int_courant_init(l);
+  liste_int_decalage(l,5);
+  for (int k = 0; k < 6; k++) {
+    liste_int_suppression_debut(l);
+  }
+  fprintf(f_out,"vide : %d\n",liste_int_est_vide(l));
+  liste_int_detruire(&l);
+}
+
 int main (void)
 {
 
@@ -130,6 +387,13 @@ int main (void)
   test3(f_out);
   test4(f_out);
   test5(f_out);
+  test6(f_out);
+  test7(f_out);
+  test8(f_out);
+  test9(f_out);
+  test10(f_out);
+  test11(f_out);
+  test12(f_out);
   fclose(f_out);
 
 